@@ -0,0 +1,119 @@
+#include "BenchUtil.h"
+#include "MetricArchive.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * 归档基准：Gorilla 编码、写入段文件和 mmap 扫描
+ *
+ * 样本模拟 1 秒采样周期：时间戳带几毫秒抖动，数值一半是单调递增的计数器，
+ * 一半是缓慢变化的百分比。bits/sample 是编码后每个样本的平均比特数。
+ * 扫描基准同时校验解码结果与写入的样本一致。
+ */
+
+namespace {
+
+struct Sample {
+  int64_t ts;
+  double value;
+};
+
+std::vector<Sample> make_samples(size_t n, bool counter) {
+  std::vector<Sample> out(n);
+  int64_t ts = 1700000000000;
+  double value = counter ? 123456789.0 : 42.5;
+  for (size_t i = 0; i < n; ++i) {
+    ts += 1000 + static_cast<int64_t>(i * 7919 % 5) - 2;
+    if (counter)
+      value += static_cast<double>(i * 31 % 4096);
+    else
+      value = std::round((42.5 + 10 * std::sin(i / 60.0)) * 10) / 10;
+    out[i] = Sample{ts, value};
+  }
+  return out;
+}
+
+std::string make_archive_dir() {
+  char tmpl[] = "/tmp/sysmon-archive-XXXXXX";
+  if (!mkdtemp(tmpl))
+    return std::string();
+  return tmpl;
+}
+
+void BM_GorillaEncode(benchmark::State &state) {
+  auto samples = make_samples(100000, state.range(0) != 0);
+  std::vector<uint8_t> buf(MetricArchive::BLOCK_BYTES);
+  GorillaEncoder enc(buf.data(), buf.size());
+  size_t i = 0, bits = 0, encoded = 0;
+  for (auto _ : state) {
+    const Sample &s = samples[i++ % samples.size()];
+    if (!enc.append(s.ts, s.value)) {
+      bits += enc.bit_count();
+      encoded += enc.count();
+      enc.reset();
+      enc.append(s.ts, s.value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (encoded)
+    state.counters["bits/sample"] = static_cast<double>(bits) / encoded;
+}
+BENCHMARK(BM_GorillaEncode)->Arg(0)->Arg(1)->ArgName("counter");
+
+// 100 个指标各 10000 个样本写入归档，再用 SegmentReader 扫描其中一个
+void BM_ArchiveScan(benchmark::State &state) {
+  constexpr size_t METRICS = 100;
+  constexpr size_t SAMPLES = 10000;
+  std::string dir = make_archive_dir();
+  auto samples = make_samples(SAMPLES, true);
+
+  std::string path;
+  size_t file_bytes = 0;
+  {
+    MetricArchive archive(dir);
+    std::vector<MetricInfo> infos(METRICS);
+    for (size_t m = 0; m < METRICS; ++m)
+      infos[m] = MetricInfo{"bench_metric", "id", std::to_string(m)};
+    for (const Sample &s : samples)
+      for (size_t m = 0; m < METRICS; ++m)
+        archive.append(m, infos[m], s.ts, s.value + m);
+    archive.flush();
+    for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+      path = entry.path();
+      file_bytes = entry.file_size();
+    }
+  }
+
+  SegmentReader reader;
+  if (path.empty() || !reader.open(path)) {
+    state.SkipWithError("无法打开归档段");
+    return;
+  }
+  size_t id = reader.find("bench_metric", "42");
+
+  for (auto _ : state) {
+    size_t i = 0;
+    bool ok = true;
+    size_t n = reader.scan(id, INT64_MIN, INT64_MAX, [&](int64_t ts, double v) {
+      ok = ok && ts == samples[i].ts && v == samples[i].value + 42;
+      ++i;
+    });
+    if (!ok || n != SAMPLES) {
+      state.SkipWithError("解码结果与写入的样本不一致");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * SAMPLES);
+  state.counters["bytes/sample"] =
+      static_cast<double>(file_bytes) / (METRICS * SAMPLES);
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+BENCHMARK(BM_ArchiveScan)->Unit(benchmark::kMicrosecond);
+
+} // namespace
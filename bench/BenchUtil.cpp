@@ -0,0 +1,218 @@
+#include "BenchUtil.h"
+#include "AllocCounter.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+uint64_t allocation_count() { return AllocCounter::total(); }
+
+// ==================== fixture 内容 ====================
+std::string make_meminfo() {
+  static const char *keys[] = {
+      "MemTotal",     "MemFree",      "MemAvailable", "Buffers",
+      "Cached",       "SwapCached",   "Active",       "Inactive",
+      "Active(anon)", "Inactive(anon)", "Active(file)", "Inactive(file)",
+      "Unevictable",  "Mlocked",      "SwapTotal",    "SwapFree",
+      "Dirty",        "Writeback",    "AnonPages",    "Mapped",
+      "Shmem",        "KReclaimable", "Slab",         "SReclaimable",
+      "SUnreclaim",   "KernelStack",  "PageTables",   "NFS_Unstable",
+      "Bounce",       "WritebackTmp", "CommitLimit",  "Committed_AS",
+      "VmallocTotal", "VmallocUsed",  "VmallocChunk", "Percpu",
+      "HardwareCorrupted", "AnonHugePages", "ShmemHugePages",
+      "ShmemPmdMapped", "FileHugePages", "FilePmdMapped",
+      "DirectMap4k",  "DirectMap2M",  "DirectMap1G"};
+  std::string out;
+  uint64_t value = 16384256;
+  for (const char *key : keys) {
+    out += key;
+    out += ":       ";
+    out += std::to_string(value);
+    out += " kB\n";
+    value = value * 7 / 11 + 13;
+  }
+  out += "HugePages_Total:       0\nHugePages_Free:        0\n";
+  return out;
+}
+
+std::string make_diskstats(int devices) {
+  std::string out;
+  for (int i = 0; i < devices; ++i) {
+    out += " 259       " + std::to_string(i) + " nvme" + std::to_string(i) +
+           "n1 183740 5641 12092288 41661 412718 256972 19543802 397657 0 "
+           "283425 455429 0 0 0 0 28490 16110\n";
+  }
+  return out;
+}
+
+std::string make_netdev(int interfaces) {
+  std::string out =
+      "Inter-|   Receive                                                |  "
+      "Transmit\n"
+      " face |bytes    packets errs drop fifo frame compressed multicast|"
+      "bytes    packets errs drop fifo colls carrier compressed\n";
+  for (int i = 0; i < interfaces; ++i) {
+    out += "veth" + std::to_string(i) +
+           ": 918273645 1234567 0 0 0 0 0 0 546372819 7654321 0 0 0 0 0 0\n";
+  }
+  return out;
+}
+
+std::string make_proc_stat(int cpus) {
+  // 与真实内核相同的 10 列格式；各核数值不同，避免计算结果恒为 0
+  std::string out;
+  auto line = [&out](const std::string &name, uint64_t base) {
+    out += name;
+    for (int f = 0; f < 10; ++f) {
+      out += ' ';
+      out += std::to_string(f >= 8 ? 0 : base * (f + 3) + f * 17);
+    }
+    out += '\n';
+  };
+  line("cpu ", 1000003ULL * cpus);
+  for (int i = 0; i < cpus; ++i)
+    line("cpu" + std::to_string(i), 1000003ULL + i * 7919ULL);
+  out += "intr 123456789 0 9 0 0\nctxt 987654321\nbtime 1700000000\n"
+         "processes 4242424\nprocs_running 3\nprocs_blocked 0\n";
+  return out;
+}
+
+// ==================== SyntheticProcTree ====================
+SyntheticProcTree::SyntheticProcTree(int pid_count) {
+  char tmpl[] = "/tmp/sysmon-proc-XXXXXX";
+  if (!mkdtemp(tmpl))
+    throw std::runtime_error("mkdtemp 失败");
+  root_ = tmpl;
+
+  namespace fs = std::filesystem;
+  // 非 PID 条目：扫描器必须跳过它们
+  fs::create_directory(root_ + "/self");
+  fs::create_directory(root_ + "/sys");
+  fs::create_directory(root_ + "/net");
+  std::ofstream(root_ + "/stat") << make_proc_stat(FIXTURE_CPUS);
+  std::ofstream(root_ + "/meminfo") << make_meminfo();
+  std::ofstream(root_ + "/diskstats") << make_diskstats(FIXTURE_DISKS);
+  std::ofstream(root_ + "/net/dev") << make_netdev(FIXTURE_INTERFACES);
+  std::ofstream(root_ + "/uptime") << "354172.52 1398231.17\n";
+  std::ofstream(root_ + "/loadavg") << "0.52 0.58 0.59 3/1234 4242\n";
+  fs::create_directory(root_ + "/pressure");
+  for (const char *resource : {"cpu", "memory", "io"}) {
+    std::ofstream(root_ + "/pressure/" + resource)
+        << "some avg10=4.01 avg60=2.79 avg300=2.22 total=213094129\n"
+           "full avg10=0.00 avg60=0.28 avg300=0.25 total=11079313\n";
+  }
+
+  for (int pid = 1; pid <= pid_count; ++pid) {
+    std::string dir = root_ + "/" + std::to_string(pid);
+    fs::create_directory(dir);
+    std::ofstream(dir + "/stat") << stat_line(pid);
+  }
+}
+
+SyntheticProcTree::~SyntheticProcTree() {
+  std::error_code ec;
+  std::filesystem::remove_all(root_, ec);
+}
+
+const SyntheticProcTree &SyntheticProcTree::get(int pid_count) {
+  static std::map<int, std::unique_ptr<SyntheticProcTree>> trees;
+  auto &tree = trees[pid_count];
+  if (!tree)
+    tree = std::make_unique<SyntheticProcTree>(pid_count);
+  return *tree;
+}
+
+void SyntheticProcTree::add_tasks(int pid, int count) const {
+  namespace fs = std::filesystem;
+  std::string task_dir = root_ + "/" + std::to_string(pid) + "/task";
+  fs::create_directory(task_dir);
+  for (int i = 0; i < count; ++i) {
+    // 其余线程的 tid 排在所有 PID 之后，互不重叠
+    int tid = i == 0 ? pid : 1000000 + pid * 1000 + i;
+    std::string dir = task_dir + "/" + std::to_string(tid);
+    fs::create_directory(dir);
+    std::ofstream(dir + "/stat") << stat_line(tid);
+  }
+}
+
+std::string SyntheticProcTree::stat_line(int pid) {
+  // 字段布局与真实内核一致，数值随 pid 变化以便排序有意义
+  unsigned long long utime = pid * 37ULL % 100000;
+  unsigned long long stime = pid * 11ULL % 50000;
+  unsigned long long rss = pid * 7919ULL % 262144;
+  char buf[512];
+  std::snprintf(buf, sizeof(buf),
+                "%d (worker-%d) %c 1 %d %d 0 -1 4194560 1234 0 12 0 %llu %llu "
+                "0 0 20 0 4 0 %d %llu %llu 18446744073709551615 1 1 0 0 0 0 "
+                "0 0 0 0 0 0 17 3 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+                pid, pid, pid % 97 == 0 ? 'R' : 'S', pid, pid, utime, stime,
+                1000 + pid, rss * 4096 * 4, rss);
+  return buf;
+}
+
+// ==================== SyntheticCgroupTree ====================
+SyntheticCgroupTree::SyntheticCgroupTree(int cgroup_count) {
+  char tmpl[] = "/tmp/sysmon-cgroup-XXXXXX";
+  if (!mkdtemp(tmpl))
+    throw std::runtime_error("mkdtemp 失败");
+  root_ = tmpl;
+
+  add("", 0);
+  add("/kubepods", 1);
+  add("/kubepods/burstable", 2);
+  add("/kubepods/besteffort", 3);
+  count_ = 4;
+  for (int pod = 0; count_ < cgroup_count; ++pod) {
+    std::string dir = std::string(pod % 2 ? "/kubepods/besteffort" : "/kubepods/burstable") +
+                      "/pod" + std::to_string(pod);
+    add(dir, count_++);
+    for (int c = 0; c < 3 && count_ < cgroup_count; ++c)
+      add(dir + "/cri-containerd-" + std::to_string(pod * 3 + c), count_++);
+  }
+}
+
+SyntheticCgroupTree::~SyntheticCgroupTree() {
+  std::error_code ec;
+  std::filesystem::remove_all(root_, ec);
+}
+
+std::string SyntheticCgroupTree::add(const std::string &relative,
+                                     int seed) const {
+  std::string dir = root_ + relative;
+  std::filesystem::create_directories(dir);
+  uint64_t usage = 1000003ULL * (seed + 1);
+  std::ofstream(dir + "/cpu.stat")
+      << "usage_usec " << usage << "\nuser_usec " << usage * 2 / 3
+      << "\nsystem_usec " << usage / 3
+      << "\nnr_periods 0\nnr_throttled 0\nthrottled_usec 0\n"
+         "nr_bursts 0\nburst_usec 0\n";
+  std::ofstream(dir + "/memory.current") << 4096ULL * (seed * 7919 % 262144)
+                                         << '\n';
+  // 真实的 memory.stat 约 40 行，anon/file 在最前面
+  static const char *keys[] = {
+      "anon", "file", "kernel", "kernel_stack", "pagetables", "sec_pagetables",
+      "percpu", "sock", "vmalloc", "shmem", "zswap", "zswapped", "file_mapped",
+      "file_dirty", "file_writeback", "swapcached", "anon_thp", "file_thp",
+      "shmem_thp", "inactive_anon", "active_anon", "inactive_file",
+      "active_file", "unevictable", "slab_reclaimable", "slab_unreclaimable",
+      "slab", "workingset_refault_anon", "workingset_refault_file",
+      "workingset_activate_anon", "workingset_activate_file",
+      "workingset_restore_anon", "workingset_restore_file",
+      "workingset_nodereclaim", "pgscan", "pgsteal", "pgfault", "pgmajfault",
+      "pgrefill", "pgactivate", "pgdeactivate", "thp_fault_alloc"};
+  std::ofstream memory(dir + "/memory.stat");
+  uint64_t value = 1048576ULL * (seed % 977 + 1);
+  for (const char *key : keys) {
+    memory << key << ' ' << value << '\n';
+    value = value * 7 / 11 + 13;
+  }
+  std::ofstream(dir + "/io.stat")
+      << "259:0 rbytes=" << 512ULL * seed << " wbytes=" << 1024ULL * seed
+      << " rios=" << seed << " wios=" << 2 * seed
+      << " dbytes=0 dios=0\n8:0 rbytes=4096 wbytes=8192 rios=1 wios=2 "
+         "dbytes=0 dios=0\n";
+  return dir;
+}
@@ -0,0 +1,86 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * 基准测试公共工具
+ *
+ * allocation_count() 返回 AllocCounter::total()，
+ * 基准测试用它的差值统计每次迭代的堆分配次数。
+ */
+uint64_t allocation_count();
+
+// 合成的 /proc 文件内容，格式与真实内核一致
+std::string make_proc_stat(int cpus);
+std::string make_meminfo();
+std::string make_diskstats(int devices);
+std::string make_netdev(int interfaces);
+
+// fixture 规模：对应大型主机上的 /proc
+constexpr int FIXTURE_CPUS = 256;
+constexpr int FIXTURE_DISKS = 500;
+constexpr int FIXTURE_INTERFACES = 2000;
+
+/**
+ * 合成的 /proc 目录树
+ *
+ * 在临时目录下创建 pid_count 个 <pid>/stat 文件、若干非 PID 条目，
+ * 以及 stat/meminfo/diskstats/net/dev/uptime/loadavg/pressure（规模见 FIXTURE_*），
+ * 可以直接作为采集器的 proc 根目录。析构时删除。
+ * 同一规模的目录树在整个进程内只创建一次（见 get()）。
+ */
+class SyntheticProcTree {
+public:
+    explicit SyntheticProcTree(int pid_count);
+    ~SyntheticProcTree();
+
+    SyntheticProcTree(const SyntheticProcTree&) = delete;
+    SyntheticProcTree& operator=(const SyntheticProcTree&) = delete;
+
+    const std::string& root() const { return root_; }
+
+    // 按规模缓存的目录树，程序退出时清理
+    static const SyntheticProcTree& get(int pid_count);
+
+    // 一行合成的 /proc/<pid>/stat 内容
+    static std::string stat_line(int pid);
+
+    // 给 pid 创建 count 个线程目录 <pid>/task/<tid>/stat（第一个 tid 等于 pid）
+    void add_tasks(int pid, int count) const;
+
+private:
+    std::string root_;
+};
+
+/**
+ * 合成的 cgroup v2 目录树
+ *
+ * 按 Kubernetes 节点的布局 /kubepods/<qos>/pod<N>/<container> 创建
+ * cgroup_count 个目录（每个 pod 目录下 3 个容器），每个目录都有
+ * cpu.stat、memory.current、memory.stat 和 io.stat（普通文件）。析构时删除。
+ */
+class SyntheticCgroupTree {
+public:
+    explicit SyntheticCgroupTree(int cgroup_count);
+    ~SyntheticCgroupTree();
+
+    SyntheticCgroupTree(const SyntheticCgroupTree&) = delete;
+    SyntheticCgroupTree& operator=(const SyntheticCgroupTree&) = delete;
+
+    const std::string& root() const { return root_; }
+    int size() const { return count_; }
+
+    // 在根目录下创建并写好一个 cgroup，返回其完整路径
+    std::string add(const std::string& relative, int seed) const;
+
+private:
+    std::string root_;
+    int count_ = 0;
+};
+
+// Kubernetes 节点上常见的 cgroup 数量
+constexpr int FIXTURE_CGROUPS = 5000;
+
+#endif // BENCH_UTIL_H
@@ -0,0 +1,88 @@
+#include "BenchUtil.h"
+#include "CgroupCollector.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+
+/**
+ * cgroup 采集基准：5000 个 cgroup 的合成目录树（SyntheticCgroupTree）
+ *
+ * Update 是层级稳定时的一个 tick：持久 fd 上的 pread + 解析 + Top N，
+ * 不再遍历目录；Rescan 每次迭代新建采集器，相当于每个 tick 都重新
+ * 遍历层级、打开所有文件的做法；Churn 每次迭代创建并删除一个 pod
+ * （4 个 cgroup），只计 do_collect()：处理 inotify 事件、增量加入和移除，
+ * 不完整重新遍历。
+ */
+
+namespace {
+
+class CollectHarness : public CgroupCollector {
+public:
+  using CgroupCollector::CgroupCollector;
+  void collect() { do_collect(); }
+};
+
+const SyntheticCgroupTree &fixture() {
+  static SyntheticCgroupTree tree(FIXTURE_CGROUPS);
+  return tree;
+}
+
+template <typename Fn>
+void run_counting_allocs(benchmark::State &state, Fn &&fn) {
+  fn();
+  uint64_t before = allocation_count();
+  for (auto _ : state) {
+    fn();
+  }
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(allocation_count() - before),
+                         benchmark::Counter::kAvgIterations);
+}
+
+void BM_CgroupUpdate(benchmark::State &state) {
+  CgroupCollector c(fixture().root());
+  c.update();
+  run_counting_allocs(state, [&] {
+    c.update();
+    benchmark::ClobberMemory();
+  });
+  state.counters["cgroups"] = static_cast<double>(c.cgroup_count());
+  state.counters["full_rescans"] = static_cast<double>(c.full_rescans());
+}
+BENCHMARK(BM_CgroupUpdate)->Unit(benchmark::kMillisecond);
+
+void BM_CgroupRescan(benchmark::State &state) {
+  const std::string &root = fixture().root();
+  for (auto _ : state) {
+    CgroupCollector c(root);
+    c.update();
+    benchmark::DoNotOptimize(c.cgroup_count());
+  }
+}
+BENCHMARK(BM_CgroupRescan)->Unit(benchmark::kMillisecond);
+
+void BM_CgroupChurn(benchmark::State &state) {
+  const SyntheticCgroupTree &tree = fixture();
+  CollectHarness c(tree.root());
+  c.update();
+  uint64_t updates = c.hierarchy_updates();
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::string pod = tree.add("/kubepods/burstable/podchurn", 1);
+    for (int i = 0; i < 3; ++i)
+      tree.add("/kubepods/burstable/podchurn/c" + std::to_string(i), i);
+    state.ResumeTiming();
+    c.collect();
+    state.PauseTiming();
+    std::filesystem::remove_all(pod);
+    state.ResumeTiming();
+    c.collect();
+  }
+  state.counters["cgroups"] = static_cast<double>(c.cgroup_count());
+  state.counters["updates_per_iter"] = benchmark::Counter(
+      static_cast<double>(c.hierarchy_updates() - updates),
+      benchmark::Counter::kAvgIterations);
+  state.counters["full_rescans"] = static_cast<double>(c.full_rescans());
+}
+BENCHMARK(BM_CgroupChurn)->Unit(benchmark::kMicrosecond);
+
+} // namespace
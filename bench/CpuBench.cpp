@@ -0,0 +1,52 @@
+#include "CpuStats.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+/**
+ * 每核心 CPU 使用率计算：标量 vs AVX2
+ *
+ * 输入为 n 个核心（加一个汇总行）的两次随机采样，
+ * 每核心耗时在核心数增加时应保持平稳。
+ */
+
+namespace {
+
+struct CpuSamples {
+  CpuTimes prev, curr;
+  CpuUsage usage;
+
+  explicit CpuSamples(size_t cores) {
+    std::mt19937_64 rng(42);
+    prev.resize(cores + 1);
+    curr.resize(cores + 1);
+    usage.resize(cores + 1);
+    for (int f = 0; f < CPU_FIELD_COUNT; ++f) {
+      for (size_t i = 0; i <= cores; ++i) {
+        prev.fields[f][i] = rng() % 100000000;
+        curr.fields[f][i] = prev.fields[f][i] + rng() % 200;
+      }
+    }
+  }
+};
+
+template <void (*Kernel)(const CpuTimes &, const CpuTimes &, CpuUsage &)>
+void BM_CpuUsage(benchmark::State &state) {
+  CpuSamples samples(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    Kernel(samples.prev, samples.curr, samples.usage);
+    benchmark::DoNotOptimize(samples.usage.total.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_CpuUsage, compute_cpu_usage_scalar)
+    ->RangeMultiplier(4)
+    ->Range(8, 512);
+#if defined(__x86_64__) || defined(__i386__)
+BENCHMARK_TEMPLATE(BM_CpuUsage, compute_cpu_usage_avx2)
+    ->RangeMultiplier(4)
+    ->Range(8, 512);
+#endif
+
+} // namespace
@@ -0,0 +1,106 @@
+#include "CollectorFactory.h"
+#include "ParseCursor.h"
+#include "StaticCollectors.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+
+/**
+ * 分发基准：CollectorFactory（std::function 创建 + 虚调用）
+ * 与 StaticCollectorSet（类型列表 + 折叠表达式 + 内联）的每 tick 开销
+ *
+ * Tiny 组用六个几乎不做事的采集器，差别只剩分发本身；Real 组是默认的
+ * 八个采集器读取本机 /proc 和 cgroup，看分发在真实 tick 中的占比。pct_of_10ms 是
+ * 一个 tick 占 10ms 采样周期的百分比（--interval 10 时的预算）。
+ */
+
+namespace {
+
+// 解析一个固定的数字并累加，do_* 都很短，适合观察内联
+template <int ID> class TinyCollector : public Collector {
+public:
+  explicit TinyCollector(const std::string & /*proc_root*/) {}
+
+  std::string get_name() const override { return "tiny" + std::to_string(ID); }
+  void print_result(std::ostream &out) const override { out << total_ << '\n'; }
+
+protected:
+  void do_collect() override { raw_data_ = "12345 678\n"; }
+  void do_parse() override {
+    ParseCursor cur(raw_data_);
+    cur.parse_u64(value_);
+  }
+  void do_calculate() override { total_ += value_; }
+
+private:
+  uint64_t value_ = 0;
+  uint64_t total_ = 0;
+};
+
+using TinyList = CollectorList<TinyCollector<0>, TinyCollector<1>, TinyCollector<2>,
+                               TinyCollector<3>, TinyCollector<4>, TinyCollector<5>>;
+
+// 每个 tick 的墙钟时间占 10ms 的百分比
+template <typename Fn> void run_ticks(benchmark::State &state, Fn &&tick) {
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+  for (auto _ : state) {
+    tick();
+    benchmark::ClobberMemory();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  state.counters["pct_of_10ms"] =
+      state.iterations() ? seconds / static_cast<double>(state.iterations()) / 0.010 * 100
+                         : 0.0;
+}
+
+// 与 CollectorFactory 相同的存放方式：std::function 创建，unique_ptr<Collector> 保存
+template <typename... Ts>
+std::vector<std::unique_ptr<Collector>> make_virtual(const std::string &root) {
+  std::vector<CollectorFactory::CreatorFunc> creators{
+      [&root] {
+        return std::unique_ptr<Collector>(
+            std::make_unique<Ts>(CollectorRoot<Ts>::get(root)));
+      }...};
+  std::vector<std::unique_ptr<Collector>> collectors;
+  for (auto &create : creators)
+    collectors.push_back(create());
+  return collectors;
+}
+
+template <typename... Ts>
+void tick_virtual(benchmark::State &state, CollectorList<Ts...>,
+                  const std::string &root) {
+  auto collectors = make_virtual<Ts...>(root);
+  run_ticks(state, [&] {
+    for (auto &c : collectors)
+      c->update();
+  });
+}
+
+template <typename List>
+void tick_static(benchmark::State &state, const std::string &root) {
+  StaticCollectorSet<List> collectors(root);
+  run_ticks(state, [&] { collectors.update_all(); });
+}
+
+void BM_DispatchTiny_Factory(benchmark::State &state) {
+  tick_virtual(state, TinyList{}, "");
+}
+BENCHMARK(BM_DispatchTiny_Factory);
+
+void BM_DispatchTiny_Static(benchmark::State &state) {
+  tick_static<TinyList>(state, "");
+}
+BENCHMARK(BM_DispatchTiny_Static);
+
+void BM_DispatchReal_Factory(benchmark::State &state) {
+  tick_virtual(state, DefaultCollectorList{}, DEFAULT_PROC_ROOT);
+}
+BENCHMARK(BM_DispatchReal_Factory)->Unit(benchmark::kMicrosecond);
+
+void BM_DispatchReal_Static(benchmark::State &state) {
+  tick_static<DefaultCollectorList>(state, DEFAULT_PROC_ROOT);
+}
+BENCHMARK(BM_DispatchReal_Static)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,44 @@
+#include "Logger.h"
+#include <benchmark/benchmark.h>
+
+/**
+ * 日志基准：调用线程上 LOG_* 的开销
+ *
+ * BM_LogDisabled 是运行时关闭的级别，消息字符串不会被构造；
+ * BM_LogAsync 只计入格式化和入队，后台线程写到 /dev/null，
+ * 队列满时丢弃，dropped 是被丢弃的比例。
+ */
+
+namespace {
+
+void BM_LogDisabled(benchmark::State &state) {
+  Logger::instance().set_level(Logger::Level::ERROR);
+  std::string path = "/proc/12345/stat";
+  for (auto _ : state) {
+    LOG_WARN("打开 " + path + " 失败");
+  }
+  Logger::instance().set_level(Logger::Level::INFO);
+}
+BENCHMARK(BM_LogDisabled);
+
+void BM_LogAsync(benchmark::State &state) {
+  Logger &logger = Logger::instance();
+  logger.set_level(Logger::Level::WARNING);
+  if (!logger.start_async("/dev/null")) {
+    state.SkipWithError("无法打开 /dev/null");
+    return;
+  }
+  uint64_t before = logger.dropped();
+  std::string path = "/proc/12345/stat";
+  for (auto _ : state) {
+    LOG_WARN("打开 " + path + " 失败");
+  }
+  state.counters["dropped"] =
+      benchmark::Counter(static_cast<double>(logger.dropped() - before),
+                         benchmark::Counter::kAvgIterations);
+  logger.stop_async();
+  logger.set_level(Logger::Level::INFO);
+}
+BENCHMARK(BM_LogAsync);
+
+} // namespace
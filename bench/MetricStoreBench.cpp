@@ -0,0 +1,92 @@
+#include "BenchUtil.h"
+#include "Collectors.h"
+#include "MetricStore.h"
+#include "MetricsServer.h"
+#include "EventLoop.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+/**
+ * MetricStore 基准：采集器发布样本、环形缓冲区写入和范围查询
+ *
+ * 发布基准使用 fixture 目录树（2000 个 veth，每个 4 个指标），
+ * 第一次发布创建指标；计时部分的分配只来自环形缓冲区按块的首次写入
+ * （每个指标每 MetricRing::CHUNK_SAMPLES 次发布一次，写满一圈后为 0）。
+ * BM_MetricsSerialize 是 /metrics 响应体每个 tick 的序列化开销。
+ */
+
+namespace {
+
+constexpr auto RETENTION = std::chrono::hours(1);
+
+void BM_MetricRingPush(benchmark::State &state) {
+  MetricRing ring(4096);
+  int64_t ts = 0;
+  for (auto _ : state) {
+    ring.push(ts, static_cast<double>(ts));
+    ++ts;
+  }
+  benchmark::DoNotOptimize(ring.latest_value());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricRingPush);
+
+// 在写满并回绕过的环中读取最近 range(0) 个样本
+void BM_MetricRingReadRange(benchmark::State &state) {
+  MetricRing ring(4096);
+  for (int64_t ts = 0; ts < 10000; ++ts)
+    ring.push(ts * 1000, static_cast<double>(ts));
+  size_t n = static_cast<size_t>(state.range(0));
+  std::vector<int64_t> timestamps(n);
+  std::vector<double> values(n);
+  int64_t to = ring.latest_timestamp();
+  int64_t from = to - static_cast<int64_t>(n - 1) * 1000;
+  for (auto _ : state) {
+    size_t got =
+        ring.read_range(from, to, timestamps.data(), values.data(), n);
+    benchmark::DoNotOptimize(got);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MetricRingReadRange)->Arg(60)->Arg(3600);
+
+void BM_PublishNetwork(benchmark::State &state) {
+  NetworkCollector collector(SyntheticProcTree::get(0).root());
+  collector.update();
+  MetricStore store(RETENTION);
+  int64_t ts = 0;
+  collector.publish(store, ts++);
+
+  uint64_t before = allocation_count();
+  for (auto _ : state) {
+    collector.publish(store, ts++);
+  }
+  state.SetItemsProcessed(state.iterations() * store.metric_count());
+  state.counters["metrics"] = static_cast<double>(store.metric_count());
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(allocation_count() - before),
+                         benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PublishNetwork);
+
+void BM_MetricsSerialize(benchmark::State &state) {
+  NetworkCollector collector(SyntheticProcTree::get(0).root());
+  collector.update();
+  MetricStore store(RETENTION);
+  collector.publish(store, 0);
+
+  EventLoop loop;
+  MetricsServer server(loop);
+  server.update(store);
+  uint64_t before = allocation_count();
+  for (auto _ : state) {
+    server.update(store);
+  }
+  state.counters["body_bytes"] = static_cast<double>(server.body_size());
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(allocation_count() - before),
+                         benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_MetricsSerialize)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,227 @@
+#include "BenchUtil.h"
+#include "Collectors.h"
+#include "MemInfo.h"
+#include "ParseCursor.h"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * do_parse() 微基准：旧的 stringstream 实现 vs ParseCursor 实现
+ *
+ * 旧实现原样保留在本文件中作为对照组；新实现直接调用采集器的 do_parse()，
+ * 通过派生类访问 protected 成员。allocs 计数器是每次迭代的堆分配次数。
+ */
+
+namespace {
+
+// ==================== 旧实现（对照组） ====================
+struct LegacyMem {
+  uint64_t total_kb = 0, free_kb = 0, available_kb = 0, buffers_kb = 0,
+           cached_kb = 0;
+};
+
+void legacy_parse_meminfo(const std::string &raw, LegacyMem &m) {
+  std::istringstream iss(raw);
+  std::string line;
+  while (std::getline(iss, line)) {
+    std::stringstream ss(line);
+    std::string key;
+    uint64_t value;
+    std::string unit;
+    ss >> key >> value >> unit;
+    if (key == "MemTotal:")
+      m.total_kb = value;
+    else if (key == "MemFree:")
+      m.free_kb = value;
+    else if (key == "MemAvailable:")
+      m.available_kb = value;
+    else if (key == "Buffers:")
+      m.buffers_kb = value;
+    else if (key == "Cached:")
+      m.cached_kb = value;
+  }
+}
+
+struct LegacyDisk {
+  std::string name;
+  uint64_t reads_completed, writes_completed, sectors_read, sectors_written;
+};
+
+void legacy_parse_diskstats(const std::string &raw,
+                            std::vector<LegacyDisk> &disks) {
+  disks.clear();
+  std::istringstream iss(raw);
+  std::string line;
+  while (std::getline(iss, line)) {
+    std::stringstream ss(line);
+    int major, minor;
+    std::string name;
+    uint64_t reads_completed, reads_merged, sectors_read, time_reading;
+    uint64_t writes_completed, writes_merged, sectors_written, time_writing;
+    ss >> major >> minor >> name >> reads_completed >> reads_merged >>
+        sectors_read >> time_reading >> writes_completed >> writes_merged >>
+        sectors_written >> time_writing;
+    if (name.find("loop") == std::string::npos &&
+        name.find("nvme") != std::string::npos &&
+        name.find("p") == std::string::npos) {
+      disks.push_back(LegacyDisk{name, reads_completed, writes_completed,
+                                 sectors_read, sectors_written});
+    }
+  }
+}
+
+struct LegacyIface {
+  std::string name;
+  uint64_t rx_bytes, tx_bytes, rx_packets, tx_packets;
+};
+
+void legacy_parse_netdev(const std::string &raw,
+                         std::vector<LegacyIface> &ifaces) {
+  ifaces.clear();
+  std::istringstream iss(raw);
+  std::string line;
+  int line_num = 0;
+  while (std::getline(iss, line)) {
+    if (++line_num <= 2)
+      continue;
+    size_t colon_pos = line.find(':');
+    if (colon_pos == std::string::npos)
+      continue;
+    std::string iface_name = line.substr(0, colon_pos);
+    iface_name.erase(0, iface_name.find_first_not_of(" \t"));
+    std::stringstream ss(line.substr(colon_pos + 1));
+    LegacyIface stats{iface_name, 0, 0, 0, 0};
+    uint64_t dummy;
+    ss >> stats.rx_bytes >> stats.rx_packets >> dummy >> dummy >> dummy >>
+        dummy >> dummy >> dummy;
+    ss >> stats.tx_bytes >> stats.tx_packets;
+    ifaces.push_back(stats);
+  }
+}
+
+// 所有 meminfo 字段的 if/else 链：按字段表顺序逐个比较键名
+void chain_parse_meminfo(std::string_view raw, uint64_t *values) {
+  ParseCursor cur(raw);
+  std::string_view line;
+  while (cur.next_line(line)) {
+    ParseCursor lc(line);
+    std::string_view key;
+    uint64_t value = 0;
+    if (!lc.next_token(key) || key.empty() || !lc.parse_u64(value))
+      continue;
+    key.remove_suffix(1);
+    for (int f = 0; f < meminfo::FIELD_COUNT; ++f) {
+      if (key == meminfo::key(static_cast<meminfo::Field>(f))) {
+        values[f] = value;
+        break;
+      }
+    }
+  }
+}
+
+// ==================== 新实现：直接驱动采集器 ====================
+template <typename Base> class ParseHarness : public Base {
+public:
+  void parse(std::string_view data) {
+    this->raw_data_ = data;
+    this->do_parse();
+  }
+};
+
+template <typename Fn>
+void run_counting_allocs(benchmark::State &state, Fn &&fn) {
+  fn(); // 预热：让复用的容器达到稳定容量
+  uint64_t before = allocation_count();
+  for (auto _ : state) {
+    fn();
+  }
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(allocation_count() - before),
+                         benchmark::Counter::kAvgIterations);
+}
+
+// ==================== 基准 ====================
+void BM_Meminfo_Stringstream(benchmark::State &state) {
+  std::string raw = make_meminfo();
+  LegacyMem m;
+  run_counting_allocs(state, [&] {
+    legacy_parse_meminfo(raw, m);
+    benchmark::DoNotOptimize(m);
+  });
+}
+BENCHMARK(BM_Meminfo_Stringstream);
+
+void BM_Meminfo_Cursor(benchmark::State &state) {
+  std::string raw = make_meminfo();
+  ParseHarness<MemoryCollector> c;
+  run_counting_allocs(state, [&] {
+    c.parse(raw);
+    benchmark::ClobberMemory();
+  });
+}
+BENCHMARK(BM_Meminfo_Cursor);
+
+// 全部字段：if/else 链 vs 编译期完美哈希（MemoryCollector 和 NumaCollector 的解析）
+void BM_MeminfoAll_Chain(benchmark::State &state) {
+  std::string raw = make_meminfo();
+  uint64_t values[meminfo::FIELD_COUNT] = {};
+  run_counting_allocs(state, [&] {
+    chain_parse_meminfo(raw, values);
+    benchmark::DoNotOptimize(values);
+  });
+}
+BENCHMARK(BM_MeminfoAll_Chain);
+
+void BM_MeminfoAll_PerfectHash(benchmark::State &state) {
+  std::string raw = make_meminfo();
+  uint64_t values[meminfo::FIELD_COUNT] = {};
+  run_counting_allocs(state, [&] {
+    meminfo::parse(raw, values);
+    benchmark::DoNotOptimize(values);
+  });
+}
+BENCHMARK(BM_MeminfoAll_PerfectHash);
+
+void BM_Diskstats_Stringstream(benchmark::State &state) {
+  std::string raw = make_diskstats(static_cast<int>(state.range(0)));
+  std::vector<LegacyDisk> disks;
+  run_counting_allocs(state, [&] {
+    legacy_parse_diskstats(raw, disks);
+    benchmark::DoNotOptimize(disks.data());
+  });
+}
+BENCHMARK(BM_Diskstats_Stringstream)->RangeMultiplier(8)->Range(8, 512);
+
+void BM_Diskstats_Cursor(benchmark::State &state) {
+  std::string raw = make_diskstats(static_cast<int>(state.range(0)));
+  ParseHarness<DiskCollector> c;
+  run_counting_allocs(state, [&] {
+    c.parse(raw);
+    benchmark::ClobberMemory();
+  });
+}
+BENCHMARK(BM_Diskstats_Cursor)->RangeMultiplier(8)->Range(8, 512);
+
+void BM_Netdev_Stringstream(benchmark::State &state) {
+  std::string raw = make_netdev(static_cast<int>(state.range(0)));
+  std::vector<LegacyIface> ifaces;
+  run_counting_allocs(state, [&] {
+    legacy_parse_netdev(raw, ifaces);
+    benchmark::DoNotOptimize(ifaces.data());
+  });
+}
+BENCHMARK(BM_Netdev_Stringstream)->RangeMultiplier(8)->Range(8, 512);
+
+void BM_Netdev_Cursor(benchmark::State &state) {
+  std::string raw = make_netdev(static_cast<int>(state.range(0)));
+  ParseHarness<NetworkCollector> c;
+  run_counting_allocs(state, [&] {
+    c.parse(raw);
+    benchmark::ClobberMemory();
+  });
+}
+BENCHMARK(BM_Netdev_Cursor)->RangeMultiplier(8)->Range(8, 512);
+
+} // namespace
@@ -0,0 +1,91 @@
+#include "BenchUtil.h"
+#include "Collectors.h"
+#include "Snapshot.h"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <thread>
+
+/**
+ * 快照基准：发布和读取 SnapshotBuffer 的开销
+ *
+ * BM_SnapshotPublish 发布 2000 个网卡的快照（NetworkCollector 的规模），
+ * range(0) 为 1 时另开一个线程不停地读取，skipped 是因为没有空闲槽位
+ * 而放弃的发布比例。稳定状态下两者都应当没有堆分配。
+ */
+
+namespace {
+
+using Snapshot = NetworkCollector::Snapshot;
+
+// 与 NetworkCollector 相同的设备表，计数器来自 fixture
+DeviceTable make_table() {
+  NetworkCollector collector(SyntheticProcTree::get(0).root());
+  collector.update();
+  const DeviceSnapshot &source = collector.snapshot()->interfaces;
+
+  DeviceTable table(source.fields);
+  table.begin_rows();
+  for (size_t slot = 0; slot < source.size(); ++slot) {
+    uint64_t *counters = table.row(source.names[slot]);
+    for (size_t f = 0; f < source.fields; ++f)
+      counters[f] = source.counter(slot, f);
+  }
+  table.end_rows();
+  table.compute_rates(DeviceTable::Clock::now());
+  return table;
+}
+
+void BM_SnapshotPublish(benchmark::State &state) {
+  const DeviceTable source = make_table();
+  SnapshotBuffer<Snapshot> buffer;
+  auto fill = [&source](Snapshot &snap) { snap.interfaces.assign(source); };
+  for (int i = 0; i < 3; ++i) // 先把每个槽位填满一次
+    buffer.publish(fill);
+
+  std::atomic<bool> stop{false};
+  std::thread reader;
+  if (state.range(0)) {
+    reader = std::thread([&] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        auto snap = buffer.read();
+        benchmark::DoNotOptimize(snap->interfaces.rates.data());
+      }
+    });
+  }
+
+  uint64_t skipped = buffer.skipped();
+  uint64_t before = allocation_count();
+  for (auto _ : state) {
+    buffer.publish(fill);
+  }
+  uint64_t allocs = allocation_count() - before;
+  stop = true;
+  if (reader.joinable())
+    reader.join();
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["skipped"] = benchmark::Counter(
+      static_cast<double>(buffer.skipped() - skipped),
+      benchmark::Counter::kAvgIterations);
+  state.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SnapshotPublish)
+    ->Arg(0)
+    ->Arg(1)
+    ->ArgName("reader")
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+void BM_SnapshotRead(benchmark::State &state) {
+  SnapshotBuffer<Snapshot> buffer;
+  buffer.publish([](Snapshot &snap) { snap.interfaces.names.resize(1); });
+  for (auto _ : state) {
+    auto snap = buffer.read();
+    benchmark::DoNotOptimize(snap->interfaces.names.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnapshotRead);
+
+} // namespace
@@ -0,0 +1,114 @@
+#include "BenchUtil.h"
+#include "Collectors.h"
+#include "MetricStore.h"
+#include "WireProtocol.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+/**
+ * 汇聚协议基准：每个 tick 的编码开销、帧大小和汇聚端的解码开销
+ *
+ * BM_WireEncodeFixture 在 fixture（2000 个 veth，16000 个指标）上每次改动
+ * range(0)% 的指标再编码，bytes 计数器是每个 tick 要发出的字节数，
+ * define_bytes 是连接建立后第一次发送全部定义的大小。
+ * BM_WireDecodeFixture 是汇聚端解码同样的帧（每 tick 改动 10%）的开销。
+ */
+
+namespace {
+
+constexpr auto RETENTION = std::chrono::minutes(10);
+
+// 汇聚端的空处理器：只做解码
+class NullHandler : public wire::Decoder::Handler {
+public:
+  bool on_hello(const std::string &, uint32_t) override { return true; }
+  void on_define(uint64_t, const std::string &, const std::string &,
+                 const std::string &) override {}
+  void on_sample(uint64_t, int64_t, double value) override { sum += value; }
+  double sum = 0.0;
+};
+
+// 把 fixture 的网络指标写入 store，之后每个 tick 改动 percent% 的值
+struct FixtureStore {
+  explicit FixtureStore(int percent) : store(RETENTION), percent(percent) {
+    NetworkCollector collector(SyntheticProcTree::get(0).root());
+    collector.update();
+    collector.publish(store, 0);
+  }
+
+  void tick() {
+    ts += 1000;
+    size_t count = store.metric_count();
+    size_t step = percent > 0 ? 100 / static_cast<size_t>(percent) : count + 1;
+    for (size_t id = offset; id < count; id += step)
+      store.push(id, ts, store.ring(id).latest_value() + 1.25);
+    offset = (offset + 1) % step;
+  }
+
+  MetricStore store;
+  int percent;
+  int64_t ts = 0;
+  size_t offset = 0;
+};
+
+void BM_WireEncodeFixture(benchmark::State &state) {
+  FixtureStore fixture(static_cast<int>(state.range(0)));
+  wire::Encoder encoder;
+  encoder.reset();
+  std::vector<uint8_t> out;
+  encoder.encode_tick(fixture.store, fixture.ts, out);
+  size_t define_bytes = out.size();
+
+  uint64_t bytes = 0;
+  uint64_t before = allocation_count();
+  for (auto _ : state) {
+    state.PauseTiming();
+    fixture.tick();
+    out.clear();
+    state.ResumeTiming();
+    encoder.encode_tick(fixture.store, fixture.ts, out);
+    bytes += out.size();
+  }
+  state.counters["metrics"] = static_cast<double>(fixture.store.metric_count());
+  state.counters["define_bytes"] = static_cast<double>(define_bytes);
+  state.counters["bytes"] = benchmark::Counter(static_cast<double>(bytes),
+                                               benchmark::Counter::kAvgIterations);
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(allocation_count() - before),
+                         benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_WireEncodeFixture)->Arg(10)->Arg(100);
+
+void BM_WireDecodeFixture(benchmark::State &state) {
+  // 预先编码若干个 tick，计时部分只解码它们
+  FixtureStore fixture(10);
+  wire::Encoder encoder;
+  encoder.reset();
+  std::vector<uint8_t> setup;
+  encoder.encode_hello("bench", 1000, setup);
+  encoder.encode_tick(fixture.store, fixture.ts, setup);
+  constexpr int TICKS = 64;
+  std::vector<uint8_t> ticks;
+  for (int i = 0; i < TICKS; ++i) {
+    fixture.tick();
+    encoder.encode_tick(fixture.store, fixture.ts, ticks);
+  }
+
+  NullHandler handler;
+  wire::Decoder decoder;
+  decoder.consume(setup.data(), setup.size(), handler);
+  uint64_t before = allocation_count();
+  for (auto _ : state) {
+    long used = decoder.consume(ticks.data(), ticks.size(), handler);
+    benchmark::DoNotOptimize(used);
+  }
+  benchmark::DoNotOptimize(handler.sum);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(ticks.size()));
+  state.SetItemsProcessed(state.iterations() * TICKS);
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(allocation_count() - before),
+                         benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_WireDecodeFixture);
+
+} // namespace
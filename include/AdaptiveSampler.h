@@ -0,0 +1,89 @@
+#ifndef ADAPTIVE_SAMPLER_H
+#define ADAPTIVE_SAMPLER_H
+
+#include "Collectors.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * 自适应采样 (Adaptive Sampling)
+ *
+ * 目的：主机 CPU 已经打满时，监控器自己的 /proc 扫描只会雪上加霜。
+ * 以监控器自身的 CPU 占用（单核百分比）为控制目标，主机繁忙且超出预算时
+ * 逐级降低进程采集的精度，主机恢复后逐级恢复
+ *
+ * 实现要点：
+ * 1. 输入都是已有的数据：CPUCollector 的总使用率、SystemCollector 的
+ *    1 分钟负载（除以 CPU 数），自身 CPU 用 getrusage(RUSAGE_SELF) 计算
+ * 2. 每个评估窗口（2 秒）决定一次级别：主机繁忙且自身超出预算时升一级；
+ *    主机空闲或自身低于预算的一半，连续 CALM_WINDOWS 个窗口才降一级（滞回）
+ * 3. 级别越高，进程扫描间隔越长（跳过到期的扫描）、Top N 越小、
+ *    stat 抽样越稀（ProcessCollector::set_sample_stride）
+ * 4. 其他采集器都只读几个固定文件，不做调整
+ */
+class AdaptiveSampler {
+public:
+    struct Thresholds {
+        double cpu_budget_percent = 0.5;  // 自身 CPU 占单核的百分比上限
+        double hot_cpu_percent = 90.0;    // 主机 CPU 使用率不低于此值视为繁忙
+        double hot_load_per_cpu = 1.0;    // 1 分钟负载 / CPU 数 不低于此值视为繁忙
+    };
+
+    // 每一级的进程采集精度
+    struct Level {
+        unsigned interval_factor;  // 进程扫描间隔的倍数
+        unsigned top_n_divisor;    // Top N 除以此值（至少 1）
+        size_t sample_stride;      // stat 抽样间隔，1 表示全部读取
+    };
+    static constexpr Level LEVELS[] = {
+        {1, 1, 1},
+        {2, 1, 1},
+        {4, 2, 2},
+        {8, 2, 4},
+    };
+    static constexpr size_t MAX_LEVEL = sizeof(LEVELS) / sizeof(LEVELS[0]) - 1;
+
+    static constexpr std::chrono::seconds EVAL_WINDOW{2};
+    static constexpr int CALM_WINDOWS = 3;
+
+    // cpu/system 可以为 nullptr（对应的条件不参与判断）；process 为 nullptr 时什么也不做
+    AdaptiveSampler(const Thresholds& thresholds, const CPUCollector* cpu,
+                    const SystemCollector* system, ProcessCollector* process);
+
+    // 从本轮到期的采集器中去掉需要跳过的进程扫描
+    void filter(std::vector<Collector*>& due);
+
+    // 每个 tick 结束时调用，评估窗口到了就调整级别
+    void update(std::chrono::steady_clock::time_point now);
+
+    size_t level() const { return level_; }
+    bool host_hot() const { return host_hot_; }
+    double self_cpu_percent() const { return self_cpu_percent_; }
+
+    // 一行状态，供 --stats 显示
+    void print(std::ostream& out) const;
+
+private:
+    void apply_level();
+    static uint64_t self_cpu_ns();
+
+    Thresholds thresholds_;
+    const CPUCollector* cpu_;
+    const SystemCollector* system_;
+    ProcessCollector* process_;
+    size_t base_top_n_ = 0;
+    unsigned cpus_ = 1;
+
+    size_t level_ = 0;
+    int calm_windows_ = 0;
+    uint64_t process_due_ = 0;   // 进程扫描到期的次数，按 interval_factor 取模
+    bool host_hot_ = false;
+    double self_cpu_percent_ = 0.0;
+    std::chrono::steady_clock::time_point window_start_{};
+    uint64_t window_cpu_ns_ = 0;
+};
+
+#endif // ADAPTIVE_SAMPLER_H
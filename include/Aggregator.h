@@ -0,0 +1,136 @@
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+#include "MetricStore.h"
+#include "WireProtocol.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class EventLoop;
+
+// 汇聚端的资源上限：一个客户端不能通过 HELLO/DEFINE 让汇聚端耗尽内存
+struct AggregatorLimits {
+    // 环形缓冲区按不短于它的采样周期计算容量；推送更快的主机保留的时长相应变短
+    std::chrono::milliseconds min_interval{1000};
+    size_t max_metrics_per_host = 4096;
+    size_t max_hosts = 10000;              // 满了先淘汰最久没有数据的离线主机
+    size_t max_ring_bytes = size_t(1) << 30;  // 所有主机的环形缓冲区写满后合计
+};
+
+/**
+ * 多主机汇聚端 (Aggregator)
+ *
+ * 目的：一个进程接收成千上万台主机用 --push 推来的指标（见 WireClient），
+ * 按主机分别保存最近一段时间的样本
+ *
+ * 实现要点：
+ * 1. 监听 socket 和所有连接都注册在同一个 EventLoop 上，与 main() 的
+ *    采集循环、MetricsServer 同样的非阻塞 epoll 写法，不为连接开线程
+ * 2. 每个连接一个 wire::Decoder 和输入缓冲区，读到的字节只解析完整的帧，
+ *    不完整的尾部留到下次；协议错误时断开连接
+ * 3. 每台主机（按 HELLO 里的主机名）一个 MetricStore，容量按它的采样周期和
+ *    retention 计算；连接上的指标 id 映射到本地 id，主机重连后沿用原来的存储
+ * 4. 只有变化的值才会出现在帧里，环形缓冲区按变化点保存样本
+ *
+ * 5. 死连接：对端掉电或网络分区时收不到 FIN。连接开启 TCP keepalive，
+ *    并且每秒检查一次空闲期限（HELLO 之前 HELLO_TIMEOUT，之后为采样周期的
+ *    IDLE_INTERVALS 倍，至少 MIN_IDLE），客户端每个 tick 都会发一帧
+ * 6. 资源上限（AggregatorLimits）：采样周期按下限计算容量；超出单机指标数或
+ *    环形缓冲区总字节数的新指标被丢弃并计数；主机数满时淘汰最久没有数据的
+ *    离线主机，全部在线时拒绝新主机；每个连接的解码器按单机指标数限制
+ *    DEFINE 累计定义的字符串和指标，超出时断开连接
+ *
+ * 同名主机同一时间只有一个连接：新的 HELLO 替换旧连接。
+ */
+class Aggregator {
+public:
+    static constexpr size_t INITIAL_BUFFER_BYTES = 4096;
+    static constexpr std::chrono::seconds HELLO_TIMEOUT{10};
+    static constexpr std::chrono::seconds MIN_IDLE{15};
+    static constexpr int IDLE_INTERVALS = 5;
+
+    Aggregator(EventLoop& loop, std::chrono::milliseconds retention,
+               AggregatorLimits limits = AggregatorLimits());
+    ~Aggregator();
+
+    Aggregator(const Aggregator&) = delete;
+    Aggregator& operator=(const Aggregator&) = delete;
+
+    // 监听 "[HOST:]PORT"（IPv4，HOST 默认 0.0.0.0），失败返回 false
+    bool listen(const std::string& address);
+
+    uint16_t port() const { return port_; }
+    size_t host_count() const { return hosts_.size(); }
+    size_t connection_count() const { return connections_.size(); }
+    size_t ring_bytes() const { return ring_bytes_; }
+    uint64_t dropped_metrics() const { return dropped_metrics_; }
+
+    // 主机的存储，没有该主机时返回 nullptr
+    const MetricStore* store(const std::string& host) const;
+
+    // 主机列表：连接状态、指标数、带宽（两次 print() 之间）和最后一帧的时间
+    void print(std::ostream& out, size_t max_rows);
+
+private:
+    struct Host {
+        std::string name;
+        std::unique_ptr<MetricStore> store;
+        size_t capacity = 0;
+        size_t ring_bytes = 0;      // 已创建的环形缓冲区写满后的字节数
+        int connection_fd = -1;     // 当前连接，-1 表示离线
+        uint64_t bytes = 0;
+        uint64_t printed_bytes = 0;  // 上次 print() 时的 bytes
+        uint64_t frames = 0;
+        std::chrono::steady_clock::time_point last_frame{};
+    };
+
+    struct Connection : wire::Decoder::Handler {
+        Aggregator* owner = nullptr;
+        int fd = -1;
+        wire::Decoder decoder;
+        std::vector<uint8_t> input;
+        size_t input_len = 0;
+        Host* host = nullptr;
+        std::vector<MetricStore::MetricId> ids;  // 远端 id -> 本地 id
+        std::chrono::steady_clock::time_point last_read{};
+        std::chrono::milliseconds idle_limit{HELLO_TIMEOUT};
+        bool warned_limit = false;  // 本连接已经报告过指标被丢弃
+
+        bool on_hello(const std::string& host_name, uint32_t interval_ms) override;
+        void on_define(uint64_t id, const std::string& name, const std::string& label_key,
+                       const std::string& label_value) override;
+        void on_sample(uint64_t id, int64_t timestamp_ms, double value) override;
+    };
+
+    void on_accept();
+    void on_event(int fd, uint32_t events);
+    bool read_frames(Connection& conn);
+    void close_connection(int fd);
+    void close_idle();
+    // 找到或创建主机；主机数已满且没有可淘汰的离线主机时返回 nullptr
+    Host* host_for(const std::string& name);
+    // 为主机的新指标预留环形缓冲区，超出上限时返回 false
+    bool reserve_metric(Host& host);
+
+    EventLoop& loop_;
+    std::chrono::milliseconds retention_;
+    AggregatorLimits limits_;
+    size_t ring_bytes_ = 0;
+    uint64_t dropped_metrics_ = 0;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    std::unordered_map<std::string, std::unique_ptr<Host>> hosts_;
+    std::chrono::steady_clock::time_point printed_at_{};
+    uint64_t rejected_ = 0;
+    int spare_fd_ = -1;  // fd 用完时临时释放它来接受并关闭新连接
+    int sweep_fd_ = -1;  // 检查空闲期限的定时器
+};
+
+#endif // AGGREGATOR_H
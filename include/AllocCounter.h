@@ -0,0 +1,20 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+/**
+ * 堆分配计数
+ *
+ * 全局 operator new 被替换为计数版本（见 AllocCounter.cpp），计数本身只是一次
+ * relaxed 原子加和一次线程局部自增，开销可以忽略。
+ *
+ * - total()        : 整个进程自启动以来的分配次数
+ * - thread_count() : 当前线程的分配次数，用于统计单个采集器 update() 的分配
+ */
+namespace AllocCounter {
+uint64_t total();
+uint64_t thread_count();
+} // namespace AllocCounter
+
+#endif // ALLOC_COUNTER_H
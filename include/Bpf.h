@@ -0,0 +1,118 @@
+#ifndef BPF_H
+#define BPF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/bpf.h>
+#include <string>
+#include <vector>
+
+/**
+ * eBPF 的最小封装（直接使用 bpf(2) 系统调用，不依赖 libbpf）
+ *
+ * 目的：在内核里聚合调度事件，用户态每个 tick 只读几个 map，
+ * 与 IoUring 一样不引入额外的库和 BPF 编译工具链
+ *
+ * 实现要点：
+ * 1. Assembler 用带标签的跳转拼出 BPF 指令，程序由调用方手写（见 EbpfCollectors.cpp）
+ * 2. 程序类型只用 BPF_PROG_TYPE_RAW_TRACEPOINT：按名字挂到 tracepoint，
+ *    不需要 tracefs，也不需要 kprobe
+ * 3. 内核结构体的字段偏移从 /sys/kernel/btf/vmlinux 查出，再写进指令的立即数，
+ *    相当于手工的 CO-RE
+ *
+ * 加载需要 CAP_BPF + CAP_PERFMON（或 root），失败时调用方退回 /proc 扫描。
+ */
+namespace bpf {
+
+/**
+ * BPF 指令汇编器
+ *
+ * 跳转目标用 new_label() 创建、bind() 绑定到下一条指令，finish() 时统一回填偏移。
+ */
+class Assembler {
+public:
+    using Label = size_t;
+
+    Label new_label();
+    void bind(Label label);
+
+    void mov_imm(uint8_t dst, int32_t imm) { alu64(BPF_MOV | BPF_K, dst, 0, imm); }
+    void mov_reg(uint8_t dst, uint8_t src) { alu64(BPF_MOV | BPF_X, dst, src, 0); }
+    void add_imm(uint8_t dst, int32_t imm) { alu64(BPF_ADD | BPF_K, dst, 0, imm); }
+    void sub_reg(uint8_t dst, uint8_t src) { alu64(BPF_SUB | BPF_X, dst, src, 0); }
+    void div_imm(uint8_t dst, int32_t imm) { alu64(BPF_DIV | BPF_K, dst, 0, imm); }
+    void rsh_imm(uint8_t dst, int32_t imm) { alu64(BPF_RSH | BPF_K, dst, 0, imm); }
+    // 32 位传送：高 32 位清零
+    void mov32_reg(uint8_t dst, uint8_t src) { emit(BPF_ALU | BPF_MOV | BPF_X, dst, src, 0, 0); }
+
+    // size 为 BPF_B/BPF_H/BPF_W/BPF_DW
+    void load(uint8_t size, uint8_t dst, uint8_t src, int16_t off) {
+        emit(BPF_LDX | BPF_MEM | size, dst, src, off, 0);
+    }
+    void store(uint8_t size, uint8_t dst, int16_t off, uint8_t src) {
+        emit(BPF_STX | BPF_MEM | size, dst, src, off, 0);
+    }
+    void store_imm(uint8_t size, uint8_t dst, int16_t off, int32_t imm) {
+        emit(BPF_ST | BPF_MEM | size, dst, 0, off, imm);
+    }
+    // *(size *)(dst + off) += src，原子操作
+    void atomic_add(uint8_t size, uint8_t dst, int16_t off, uint8_t src) {
+        emit(BPF_STX | BPF_ATOMIC | size, dst, src, off, BPF_ADD);
+    }
+
+    // op 为 BPF_JEQ/BPF_JNE/BPF_JGT/BPF_JGE/BPF_JLT 等
+    void jump_imm(uint8_t op, uint8_t dst, int32_t imm, Label target);
+    void jump_reg(uint8_t op, uint8_t dst, uint8_t src, Label target);
+    void jump(Label target);
+
+    void call(int32_t helper) { emit(BPF_JMP | BPF_CALL, 0, 0, 0, helper); }
+    void exit() { emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0); }
+    // dst = map 的地址（两条指令的 64 位立即数）
+    void load_map(uint8_t dst, int map_fd);
+
+    // 回填跳转偏移，有未绑定的标签时返回 false
+    bool finish(std::vector<bpf_insn>& out);
+
+private:
+    void alu64(uint8_t op, uint8_t dst, uint8_t src, int32_t imm) {
+        emit(BPF_ALU64 | op, dst, src, 0, imm);
+    }
+    void emit(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm);
+
+    struct Fixup {
+        size_t insn;
+        Label label;
+    };
+
+    std::vector<bpf_insn> insns_;
+    std::vector<long> labels_;  // 标签 -> 指令下标，-1 表示未绑定
+    std::vector<Fixup> fixups_;
+};
+
+// 创建 map，失败返回 -1（errno 保留）
+int create_map(bpf_map_type type, uint32_t key_size, uint32_t value_size,
+               uint32_t max_entries, const char* name);
+
+// 加载 raw tracepoint 程序，失败返回 -1，log 里是校验器的输出
+int load_raw_tracepoint(const std::vector<bpf_insn>& insns, const char* name,
+                        std::string& log);
+
+// 把程序挂到名为 tracepoint 的 raw tracepoint，返回关联的 fd（关闭即卸载）
+int attach_raw_tracepoint(const char* tracepoint, int prog_fd);
+
+bool lookup(int map_fd, const void* key, void* value);
+
+// 批量读取整个 map（remove 为 true 时同时删除），最多 capacity 个元素，
+// 返回读取的个数，失败返回 -1。value_size 对 PERCPU map 是所有 CPU 的总大小
+long read_all(int map_fd, bool remove, void* keys, uint32_t key_size, void* values,
+              uint32_t value_size, uint32_t capacity);
+
+// 可能存在的 CPU 数（/sys/devices/system/cpu/possible），PERCPU map 的值按它排列
+int possible_cpus();
+
+// 内核结构体成员的字节偏移（来自 /sys/kernel/btf/vmlinux），找不到时返回 false
+bool btf_member_offset(const char* struct_name, const char* member, uint32_t& offset);
+
+} // namespace bpf
+
+#endif // BPF_H
@@ -0,0 +1,130 @@
+#ifndef CGROUP_COLLECTOR_H
+#define CGROUP_COLLECTOR_H
+
+#include "Collectors.h"
+#include "DeviceTable.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// cgroup v2 的挂载点：纯 v2 主机是 /sys/fs/cgroup，混合模式是 /sys/fs/cgroup/unified；
+// 都不是 cgroup2 时返回空字符串
+std::string default_cgroup_root();
+
+/**
+ * cgroup v2 采集器
+ *
+ * 目的：容器里的负载只看主机级的 /proc/stat、/proc/meminfo 看不出是谁在用；
+ * 按 cgroup 统计 CPU、内存和 I/O，Kubernetes 节点上约有 5000 个 cgroup
+ *
+ * 实现要点：
+ * 1. 每个 cgroup 目录保持一个 dirfd，cpu.stat、memory.current、memory.stat、
+ *    io.stat 各保持一个 fd，每个 tick 每个文件只有一次 pread，不拼接路径
+ * 2. 层级结构只在 inotify 事件（子目录创建/删除/移动）时增量更新，
+ *    事件队列溢出时才完整重新遍历；稳定时不再 getdents64
+ * 3. 文件内容读到同一个复用缓冲区上立即解析（ParseCursor），计数器写入
+ *    DeviceTable（cgroup 路径 -> 槽位），速率按下标计算，稳定后不分配
+ * 4. 显示按 CPU 使用率取 Top N，指标发布覆盖所有 cgroup
+ *
+ * 没有启用的控制器对应的文件不存在，相应计数器为 0。
+ * 每个 cgroup 最多需要 5 个 fd：按当前的 RLIMIT_NOFILE 软限制（main() 启动时
+ * 提到硬限制）给进程其余部分留出余量；超出预算的目录和文件退回每次 open/pread/close。
+ */
+class CgroupCollector : public Collector {
+public:
+    explicit CgroupCollector(std::string cgroup_root = default_cgroup_root());
+    ~CgroupCollector() override;
+
+    // DeviceTable 中每个 cgroup 的计数器
+    enum Field {
+        CPU_USAGE_USEC,
+        CPU_USER_USEC,
+        CPU_SYSTEM_USEC,
+        CPU_THROTTLED_USEC,
+        MEMORY_CURRENT,       // 字节，瞬时值
+        MEMORY_ANON,
+        MEMORY_FILE,
+        IO_READ_BYTES,        // 所有设备之和
+        IO_WRITE_BYTES,
+        IO_READ_OPS,
+        IO_WRITE_OPS,
+        FIELD_COUNT
+    };
+
+    struct Snapshot {
+        bool available = false;    // 找到了 cgroup v2 层级
+        DeviceSnapshot cgroups;    // 按路径，速率为每秒
+        std::vector<size_t> top;   // 按 CPU 使用率降序的前 top_n 个槽位
+        uint64_t hierarchy_updates = 0;
+    };
+
+    static constexpr const char* NAME = "cgroup";
+    std::string get_name() const override { return NAME; }
+    bool slow_start() const override { return true; }
+    void print_result(std::ostream& out) const override;
+    void configure(const MonitorOptions& options) override;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
+
+    size_t cgroup_count() const { return groups_.size(); }
+    // 层级结构更新次数（增量和完整遍历）与完整遍历次数
+    uint64_t hierarchy_updates() const { return hierarchy_updates_; }
+    uint64_t full_rescans() const { return full_rescans_; }
+
+protected:
+    void do_collect() override;
+    void do_parse() override;
+    void do_calculate() override;
+    void do_publish(MetricWriter& out) const override;
+    void do_snapshot() override;
+
+private:
+    enum File { CPU_STAT, MEMORY_CURRENT_FILE, MEMORY_STAT, IO_STAT, FILE_COUNT };
+    static constexpr int FD_ABSENT = -1;   // 文件不存在（控制器未启用）
+    static constexpr int FD_REOPEN = -2;   // 超出 fd 预算，每次读取时重新打开
+
+    struct Group {
+        std::string path;                  // 相对根目录，根为 "/"
+        int dir_fd = FD_REOPEN;
+        int wd = -1;                       // inotify watch
+        int files[FILE_COUNT] = {FD_ABSENT, FD_ABSENT, FD_ABSENT, FD_ABSENT};
+    };
+
+    bool open_hierarchy();
+    void close_hierarchy();
+    void full_rescan();
+    bool reserve_fd();                     // 预算内时占用一个持久 fd
+    int open_in(const Group& group, const char* name, int flags);
+    void close_group(Group& group);
+    // 加入一个 cgroup 及其子目录；dir_fd 不在预算内时遍历后关闭
+    void add_subtree(std::string path, int dir_fd);
+    size_t add_group(std::string path, int dir_fd);
+    void walk(size_t index, int dir_fd);   // 递归加入 groups_[index] 的子目录
+    void remove_subtree(const std::string& path);
+    bool drain_events();                   // 返回 false 表示需要完整重新遍历
+    std::string_view read_file(Group& group, File file);
+    void parse_group(Group& group, uint64_t* counters);
+
+    std::string root_;
+    int inotify_fd_ = -1;
+    bool opened_ = false;      // 已经尝试打开层级
+    bool available_ = false;
+    bool warned_fds_ = false;
+    bool warned_watches_ = false;
+    size_t fd_budget_ = 0;
+    size_t open_fds_ = 0;
+    std::string path_;                        // 非持久目录下拼接的路径
+    std::vector<Group> groups_;
+    std::unordered_map<int, size_t> by_wd_;   // wd -> groups_ 下标
+    std::vector<char> events_;
+    std::vector<char> dents_;
+    std::vector<char> buffer_;                // 所有文件共用的读取缓冲区
+    DeviceTable table_{FIELD_COUNT};
+    std::vector<size_t> top_;
+    size_t top_n_ = 5;
+    uint64_t hierarchy_updates_ = 0;
+    uint64_t full_rescans_ = 0;
+    SnapshotBuffer<Snapshot> snapshot_;
+};
+
+#endif // CGROUP_COLLECTOR_H
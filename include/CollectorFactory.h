@@ -2,8 +2,11 @@
 #define COLLECTOR_FACTORY_H
 
 #include "Collectors.h"
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 /**
@@ -18,29 +21,97 @@
  *
  * 改进：使用 vector 替代 map 存储注册信息，利用静态初始化的顺序（在单文件中）
  * 自动决定显示顺序，无需硬编码 order 数组。
+ *
+ * 每个注册项带一个默认采样周期，create_all() 创建时设置到采集器上。
+ * 注册项还记录采集器的名字（T::NAME，与 get_name() 相同），
+ * --collectors 按名字筛选时，没有选中的采集器根本不会被构造。
+ *
+ * 后端：同一个采集器可以注册替代实现（例如读 netlink 而不是 /proc），
+ * 用 REGISTER_COLLECTOR_BACKEND 按 (采集器名, 后端名) 注册；create_all()
+ * 按 --backend 的选择替换默认实现，显示顺序和采样周期不变。
  */
 class CollectorFactory {
 public:
   // 创建函数类型
   using CreatorFunc = std::function<std::unique_ptr<Collector>()>;
 
+  // 默认采样周期
+  static constexpr std::chrono::milliseconds DEFAULT_INTERVAL{1000};
+  // 默认实现的后端名（读取 /proc 文本）
+  static constexpr const char *DEFAULT_BACKEND = "proc";
+
   // 获取工厂单例
   static CollectorFactory &instance() {
     static CollectorFactory factory;
     return factory;
   }
 
-  // 注册采集器创建函数 (不再需要名字)
-  void register_collector(CreatorFunc creator) {
-    creators_.emplace_back(std::move(creator));
+  // 注册采集器创建函数，name 是创建出的采集器 get_name() 的返回值
+  void register_collector(const char *name, CreatorFunc creator,
+                          std::chrono::milliseconds interval = DEFAULT_INTERVAL) {
+    creators_.push_back(Entry{name, std::move(creator), interval});
+  }
+
+  // 是否注册了名为 name 的采集器
+  bool has_collector(const std::string &name) const {
+    for (const auto &entry : creators_) {
+      if (name == entry.name)
+        return true;
+    }
+    return false;
+  }
+
+  // 已注册的采集器名，逗号分隔（用于错误提示）
+  std::string collector_names() const {
+    std::string names;
+    for (const auto &entry : creators_)
+      names += (names.empty() ? "" : ", ") + std::string(entry.name);
+    return names;
+  }
+
+  // 注册 collector（get_name() 的返回值）的替代实现
+  void register_backend(std::string collector, std::string backend,
+                        CreatorFunc creator) {
+    backends_.push_back(
+        Backend{std::move(collector), std::move(backend), std::move(creator)});
+  }
+
+  // collector 是否有名为 backend 的实现（DEFAULT_BACKEND 总是有）
+  bool has_backend(const std::string &collector,
+                   const std::string &backend) const {
+    return backend == DEFAULT_BACKEND || find_backend(collector, backend);
+  }
+
+  // collector 可选的后端名，逗号分隔（用于错误提示）
+  std::string backend_names(const std::string &collector) const {
+    std::string names = DEFAULT_BACKEND;
+    for (const auto &b : backends_) {
+      if (b.collector == collector)
+        names += ", " + b.backend;
+    }
+    return names;
   }
 
-  // 创建所有已注册的采集器
-  std::vector<std::unique_ptr<Collector>> create_all() const {
+  // 创建已注册的采集器（only 非空时只创建其中列出的），
+  // selected 中指定了后端的换成对应实现
+  std::vector<std::unique_ptr<Collector>>
+  create_all(const std::vector<BackendOverride> &selected = {},
+             const std::vector<std::string> &only = {}) const {
     std::vector<std::unique_ptr<Collector>> collectors;
     // 直接按注册顺序创建
-    for (const auto &creator : creators_) {
-      collectors.push_back(creator());
+    for (const auto &entry : creators_) {
+      if (!only.empty() &&
+          std::find(only.begin(), only.end(), entry.name) == only.end())
+        continue;
+      const std::string *backend = nullptr;
+      for (const auto &choice : selected) {
+        if (choice.collector == entry.name)
+          backend = &choice.backend; // 后面的覆盖前面的
+      }
+      const Backend *b = backend ? find_backend(entry.name, *backend) : nullptr;
+      auto collector = b ? b->creator() : entry.creator();
+      collector->set_interval(entry.interval);
+      collectors.push_back(std::move(collector));
     }
     return collectors;
   }
@@ -51,8 +122,30 @@ public:
 
 private:
   CollectorFactory() = default;
+
+  struct Entry {
+    const char *name;
+    CreatorFunc creator;
+    std::chrono::milliseconds interval;
+  };
+  struct Backend {
+    std::string collector;
+    std::string backend;
+    CreatorFunc creator;
+  };
+
+  const Backend *find_backend(const std::string &collector,
+                              const std::string &backend) const {
+    for (const auto &b : backends_) {
+      if (b.collector == collector && b.backend == backend)
+        return &b;
+    }
+    return nullptr;
+  }
+
   // 使用 vector 保持注册顺序
-  std::vector<CreatorFunc> creators_;
+  std::vector<Entry> creators_;
+  std::vector<Backend> backends_;
 };
 
 /**
@@ -63,10 +156,20 @@ private:
  */
 template <typename T> class CollectorRegistrar {
 public:
-  // 构造函数不需要名字了
-  CollectorRegistrar() {
+  // 名字取自 T::NAME，不需要构造采集器
+  explicit CollectorRegistrar(
+      std::chrono::milliseconds interval = CollectorFactory::DEFAULT_INTERVAL) {
     CollectorFactory::instance().register_collector(
-        []() { return std::make_unique<T>(); });
+        T::NAME, []() { return std::make_unique<T>(); }, interval);
+  }
+};
+
+// 替代实现的自注册
+template <typename T> class CollectorBackendRegistrar {
+public:
+  CollectorBackendRegistrar(const char *collector, const char *backend) {
+    CollectorFactory::instance().register_backend(
+        collector, backend, []() { return std::make_unique<T>(); });
   }
 };
 
@@ -77,4 +180,12 @@ public:
 #define REGISTER_COLLECTOR(type)                                               \
   static CollectorRegistrar<type> registrar_##type
 
+// 指定默认采样周期（毫秒）
+#define REGISTER_COLLECTOR_EVERY(type, ms)                                     \
+  static CollectorRegistrar<type> registrar_##type{std::chrono::milliseconds(ms)}
+
+// 注册替代实现，例如 REGISTER_COLLECTOR_BACKEND(NetlinkNetworkCollector, "network", "netlink")
+#define REGISTER_COLLECTOR_BACKEND(type, collector, backend)                   \
+  static CollectorBackendRegistrar<type> registrar_##type{collector, backend}
+
 #endif // COLLECTOR_FACTORY_H
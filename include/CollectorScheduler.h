@@ -0,0 +1,62 @@
+#ifndef COLLECTOR_SCHEDULER_H
+#define COLLECTOR_SCHEDULER_H
+
+#include "Collectors.h"
+#include "ThreadPool.h"
+#include "TickArena.h"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/**
+ * 采集器调度器
+ *
+ * 目的：互不依赖的采集器并发执行 update()，tick 延迟从"所有采集器之和"
+ * 降到"最慢的那个采集器"（关键路径）
+ *
+ * update() 仍然是模板方法，调度器只负责分发和等待；run() 返回时所有
+ * 采集器都已完成，调用方可以按原有顺序 print_result()。
+ *
+ * 启用 io_uring 后，分发之前先通过 Collector::prefetch() 收集本次要读取的
+ * ProcFile，一次提交全部读取，采集器的 do_collect() 直接拿到结果。
+ *
+ * 设置了 TickArena 时，分发的任务和采集器的 tick_memory() 都从 arena 分配，
+ * 调用方在本 tick 的输出完成后 reset()。
+ */
+class CollectorScheduler {
+public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    // jobs <= 1 时在调用线程上顺序执行
+    explicit CollectorScheduler(size_t jobs);
+
+    // 运行 collectors 中每个采集器的 update()，全部完成后返回
+    void run(const std::vector<Collector*>& collectors);
+
+    // 启用 ProcFile 批量读取，内核不支持时返回 false
+    bool enable_io_uring();
+    const ProcFileBatch* batch() const { return batch_.get(); }
+
+    // 本 tick 临时对象的内存来源，nullptr 表示 new/delete
+    void set_arena(TickArena* arena) { arena_ = arena; }
+
+    // 最近一次 run() 的统计
+    Duration wall_time() const { return wall_time_; }
+    Duration critical_path() const { return critical_path_; }
+    // 关键路径上的采集器，没有运行任何采集器时为 nullptr
+    const Collector* critical_collector() const { return critical_; }
+
+    size_t jobs() const { return pool_ ? pool_->size() : 1; }
+
+private:
+    std::unique_ptr<ThreadPool> pool_;
+    std::unique_ptr<ProcFileBatch> batch_;
+    TickArena* arena_ = nullptr;
+    TaskGroup pending_;
+    std::vector<Duration> durations_;
+    Duration wall_time_{};
+    Duration critical_path_{};
+    const Collector* critical_ = nullptr;
+};
+
+#endif // COLLECTOR_SCHEDULER_H
@@ -0,0 +1,57 @@
+#ifndef COLLECTOR_WARMUP_H
+#define COLLECTOR_WARMUP_H
+
+#include "Collectors.h"
+#include "EventLoop.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * 后台首次采集 (Progressive Startup)
+ *
+ * 目的：几万个 PID 的主机上，进程采集器的第一次 update() 要好几秒；
+ * 之前所有采集器都要完成第一次采集才出第一帧
+ *
+ * 实现要点：
+ * 1. slow_start() 为 true 的采集器在一个后台线程上依次 update()，
+ *    其余采集器照常在主线程上采集，第一帧立即显示
+ * 2. 后台线程完成后写 eventfd，完成回调在事件循环线程上执行
+ *    （发布指标、刷新画面），主线程不需要加锁
+ * 3. 首次采集完成之前，filter() 把这些采集器从本轮的 due 中去掉，
+ *    主线程不会和后台线程同时 update() 同一个采集器
+ *
+ * print_result() 只读快照，首次采集期间调用方显示占位行即可。
+ * 析构时等待后台线程结束。
+ */
+class CollectorWarmup {
+public:
+    using DoneHandler = std::function<void(const std::vector<Collector*>& collectors)>;
+
+    explicit CollectorWarmup(EventLoop& loop);
+    ~CollectorWarmup();
+
+    CollectorWarmup(const CollectorWarmup&) = delete;
+    CollectorWarmup& operator=(const CollectorWarmup&) = delete;
+
+    // 在后台线程上 update() collectors，完成后在事件循环线程上调用 done；
+    // 失败时返回 false，调用方改为同步采集
+    bool start(std::vector<Collector*> collectors, DoneHandler done);
+
+    bool running() const { return running_; }
+    bool pending(const Collector* collector) const;
+    // 从 due 中去掉还在后台首次采集的采集器
+    void filter(std::vector<Collector*>& due) const;
+
+private:
+    void on_done();
+
+    EventLoop& loop_;
+    int efd_ = -1;
+    std::thread thread_;
+    std::vector<Collector*> collectors_;
+    DoneHandler done_;
+    bool running_ = false;
+};
+
+#endif // COLLECTOR_WARMUP_H
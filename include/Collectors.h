@@ -1,22 +1,60 @@
 #ifndef COLLECTORS_H
 #define COLLECTORS_H
 
+#include "AllocCounter.h"
+#include "CpuStats.h"
+#include "DeviceTable.h"
+#include "LatencyHistogram.h"
+#include "MemInfo.h"
+#include "MetricStore.h"
+#include "Options.h"
+#include "ProcFile.h"
+#include "ProcessScanner.h"
+#include "Snapshot.h"
+#include "ThreadPool.h"
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
+#include <chrono>
 #include <cstdint>
-#include <dirent.h>
 
-// 数据源路径
-#define CPU_PATH "/proc/stat"
-#define MEMORY_PATH "/proc/meminfo"
-#define NETWORK_PATH "/proc/net/dev"
-#define DISK_PATH "/proc/diskstats"
-#define UPTIME_PATH "/proc/uptime"
-#define LOADAVG_PATH "/proc/loadavg"
-#define PROC_PATH "/proc"
+// 数据源：相对于 proc 根目录的文件名
+constexpr const char* CPU_FILE = "stat";
+constexpr const char* MEMORY_FILE = "meminfo";
+constexpr const char* NETWORK_FILE = "net/dev";
+constexpr const char* DISK_FILE = "diskstats";
+constexpr const char* UPTIME_FILE = "uptime";
+constexpr const char* LOADAVG_FILE = "loadavg";
+constexpr const char* DEFAULT_PROC_ROOT = "/proc";
+
+// proc 根目录可注入：采集器构造时传入，不传则使用默认根目录。
+// 工厂创建的采集器使用默认根目录，--proc-root 可以把它指向 fixture 目录。
+const std::string& default_proc_root();
+void set_default_proc_root(std::string root);
+std::string proc_path(const std::string& root, const char* file);
+
+class Collector;
+
+/**
+ * 原始输入的记录方（--record）
+ *
+ * replayable() 的采集器每次 update() 之后调用一次 record()，
+ * 可能在多个调度线程上同时调用。
+ */
+class RawSink {
+public:
+    virtual ~RawSink() = default;
+    virtual void record(const Collector& collector,
+                        std::chrono::steady_clock::time_point sampled_at,
+                        std::string_view raw) = 0;
+};
 
 /**
  * 模板方法模式 (Template Method Pattern)
@@ -28,6 +66,19 @@
  * - do_collect() : 抽象方法，子类必须实现
  * - do_parse() : 抽象方法，子类必须实现  
  * - do_calculate() : 钩子方法，子类可选覆盖，有默认空实现
+ * - configure() : 钩子方法，采集器从命令行选项中读取自己关心的配置
+ * - publish() / do_publish() : 把数值写入 MetricStore（headless 模式的输出路径）
+ * - do_snapshot() : 钩子方法，update() 最后把结果发布到采集器的 SnapshotBuffer
+ *
+ * 快照 (Snapshot)：print_result()、do_publish() 和 get_usage() 之类的读取方
+ * 只读取最近发布的快照，不读取 update() 正在修改的成员，
+ * 因此可以在其他线程上与 update() 并发执行，双方都不加锁。
+ *
+ * update() 顺便记录每个阶段的耗时和分配次数（自监控，见 phase_stats()）。
+ *
+ * 记录与回放：原始输入全部在 raw_data_ 里的采集器（replayable()）可以把它交给
+ * RawSink 记录下来，之后由 replay() 代替 do_collect() 重新喂给 do_parse()；
+ * 计算速率用 sample_time() 而不是当前时间，回放的结果与记录时一致。
  */
 class Collector {
 public:
@@ -36,19 +87,110 @@ public:
     // 模板方法 - 定义采集流程的骨架
     // 非虚函数，子类无法覆盖
     void update() {
-        do_collect();    // 步骤1: 采集原始数据
-        do_parse();      // 步骤2: 解析数据
-        do_calculate();  // 步骤3: 计算结果（可选）
+        run_phases([this] { do_collect(); },     // 步骤1: 采集原始数据
+                   [this] { do_parse(); },       // 步骤2: 解析数据
+                   [this] {
+                       do_calculate();           // 步骤3: 计算结果（可选）
+                       do_snapshot();            // 步骤4: 发布快照给读取方
+                   });
+        if (raw_sink_ && replayable())
+            raw_sink_->record(*this, sample_time_, raw_data_);
     }
 
+    // 回放：raw 代替 do_collect() 的结果，sampled_at 是记录时的采样时间。
+    // raw 在下一次 update()/replay() 之前必须有效
+    void replay(std::string_view raw, std::chrono::steady_clock::time_point sampled_at) {
+        run_phases([this, raw, sampled_at] {
+                       raw_data_ = raw;
+                       sample_time_ = sampled_at;
+                   },
+                   [this] { do_parse(); },
+                   [this] {
+                       do_calculate();
+                       do_snapshot();
+                   });
+    }
+
+    // 原始输入是否全部在 raw_data_ 里、do_parse() 是否只读 raw_data_（钩子方法）
+    virtual bool replayable() const { return false; }
+    void set_raw_sink(RawSink* sink) { raw_sink_ = sink; }
+
+    // 各阶段耗时直方图（多线程写入安全）
+    const PhaseStats& phase_stats() const { return phase_stats_; }
+
     // 获取采集器名称 - 用于工厂模式注册
     virtual std::string get_name() const = 0;
 
-    // 打印结果
-    virtual void print_result() const = 0;
+    // 输出结果到 out（渲染器的帧缓冲区），换行用 '\n'，不要 flush
+    virtual void print_result(std::ostream& out) const = 0;
+
+    // 应用命令行选项（钩子方法，默认忽略）
+    virtual void configure(const MonitorOptions& /*options*/) {}
+
+    // 把本次 do_collect() 要读取的 ProcFile 加入调度器的批量读取（钩子方法）
+    virtual void prefetch(ProcFileBatch& /*batch*/) {}
+
+    // 第一次 update() 可能很慢（要遍历所有 PID、磁盘或接口，钩子方法）：
+    // 启动时放到后台执行，先显示其他采集器
+    virtual bool slow_start() const { return false; }
+
+    // 只活到本 tick 结束的临时对象从 memory 分配（调度器设置为 TickArena），
+    // 未设置时为 new/delete
+    void set_tick_memory(std::pmr::memory_resource* memory) { tick_memory_ = memory; }
+
+    // 采样周期：默认值来自工厂注册参数，可以被 --interval 覆盖
+    std::chrono::milliseconds interval() const { return interval_; }
+    void set_interval(std::chrono::milliseconds interval) { interval_ = interval; }
+
+    // 把最近一次 update() 的结果写入 store，时间戳为 timestamp_ms
+    void publish(MetricStore& store, int64_t timestamp_ms) {
+        MetricWriter writer(store, metric_bindings_, store.capacity_for(interval_),
+                            timestamp_ms);
+        do_publish(writer);
+        writer.finish();
+    }
 
 protected:
-    std::string raw_data_;  // 原始数据
+    // 原始数据：指向采集器自有 ProcFile 缓冲区的视图，下次采集前有效
+    std::string_view raw_data_;
+
+    std::pmr::memory_resource* tick_memory() const { return tick_memory_; }
+    // 本次采样的时间：do_collect() 之前的时刻，回放时是记录下来的时间
+    std::chrono::steady_clock::time_point sample_time() const { return sample_time_; }
+    // 本次 update() 交给其他线程执行的部分（例如分片任务）在那个线程上的分配次数，
+    // run_phases() 只能数到调用线程上的分配
+    void add_worker_allocations(uint64_t count) {
+        phase_stats_.allocations.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // update() 的骨架：依次执行三个阶段并记录耗时和分配次数。
+    // 各阶段由调用方传入，知道具体类型的调用方（StaticCollectorSet）
+    // 可以传入非虚调用，让 do_* 内联进来
+    template <typename Collect, typename Parse, typename Calculate>
+    void run_phases(Collect&& collect, Parse&& parse, Calculate&& calculate) {
+        using Clock = std::chrono::steady_clock;
+        uint64_t allocs_before = AllocCounter::thread_count();
+
+        auto t0 = Clock::now();
+        sample_time_ = t0;
+        collect();
+        auto t1 = Clock::now();
+        parse();
+        auto t2 = Clock::now();
+        calculate();
+        auto t3 = Clock::now();
+
+        auto ns = [](Clock::duration d) {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        };
+        phase_stats_.collect.record(ns(t1 - t0));
+        phase_stats_.parse.record(ns(t2 - t1));
+        phase_stats_.calculate.record(ns(t3 - t2));
+        phase_stats_.total.record(ns(t3 - t0));
+        phase_stats_.allocations.fetch_add(AllocCounter::thread_count() - allocs_before,
+                                           std::memory_order_relaxed);
+    }
 
     // 抽象方法 - 子类必须实现
     virtual void do_collect() = 0;
@@ -56,132 +198,381 @@ protected:
 
     // 钩子方法 - 子类可选覆盖
     virtual void do_calculate() {}
+    virtual void do_snapshot() {}
+    virtual void do_publish(MetricWriter& /*out*/) const {}
+
+private:
+    std::chrono::milliseconds interval_{1000};
+    std::pmr::memory_resource* tick_memory_ = std::pmr::new_delete_resource();
+    std::chrono::steady_clock::time_point sample_time_{};
+    RawSink* raw_sink_ = nullptr;
+    PhaseStats phase_stats_;
+    std::vector<MetricWriter::Binding> metric_bindings_;
 };
 
 // ==================== CPU 采集器 ====================
 class CPUCollector : public Collector {
 public:
-    std::string get_name() const override { return "cpu"; }
-    void print_result() const override;
-    double get_usage() const { return usage_percent_; }
+    explicit CPUCollector(const std::string& proc_root = default_proc_root());
+
+    // 发布给读取方的结果
+    struct Snapshot {
+        std::vector<int> core_ids;
+        std::vector<std::string> core_labels;
+        CpuUsage usage;
+        double usage_percent = 0.0;
+    };
+
+    static constexpr const char* NAME = "cpu";
+    std::string get_name() const override { return NAME; }
+    bool replayable() const override { return true; }
+    void print_result(std::ostream& out) const override;
+    void prefetch(ProcFileBatch& batch) override;
+    double get_usage() const;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
 
 protected:
     void do_collect() override;
     void do_parse() override;
+    void do_publish(MetricWriter& out) const override;
     void do_calculate() override;
+    void do_snapshot() override;
 
 private:
-    unsigned long long prev_idle_ = 0;
-    unsigned long long prev_total_ = 0;
-    unsigned long long curr_idle_ = 0;
-    unsigned long long curr_total_ = 0;
+    ProcFile file_;
+    // 下标 0 是汇总行，之后按 /proc/stat 中的顺序排列各核心
+    std::vector<int> core_ids_;   // -1 表示汇总行
+    std::vector<std::string> core_labels_;  // 指标标签："all"、"0"、"1"...
+    CpuTimes prev_;
+    CpuTimes curr_;
+    CpuUsage usage_;
     double usage_percent_ = 0.0;
+    SnapshotBuffer<Snapshot> snapshot_;
 };
 
 // ==================== 内存采集器 ====================
+// 进程里唯一读取 /proc/meminfo 的采集器：解析全部字段（MemInfo.h），
+// 大页、slab、脏页等全局详情也从这里发布
 class MemoryCollector : public Collector {
 public:
-    std::string get_name() const override { return "memory"; }
-    void print_result() const override;
-    double get_usage() const { return usage_percent_; }
+    explicit MemoryCollector(const std::string& proc_root = default_proc_root());
+
+    struct Snapshot {
+        uint64_t total_kb = 0;
+        uint64_t free_kb = 0;
+        uint64_t available_kb = 0;
+        uint64_t buffers_kb = 0;
+        uint64_t cached_kb = 0;
+        uint64_t used_kb = 0;
+        double usage_percent = 0.0;
+        uint64_t fields[meminfo::FIELD_COUNT] = {};  // 全部字段（大页、slab、脏页等）
+    };
+
+    static constexpr const char* NAME = "memory";
+    std::string get_name() const override { return NAME; }
+    bool replayable() const override { return true; }
+    void print_result(std::ostream& out) const override;
+    void prefetch(ProcFileBatch& batch) override;
+    double get_usage() const;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
 
 protected:
     void do_collect() override;
     void do_parse() override;
+    void do_publish(MetricWriter& out) const override;
     void do_calculate() override;
+    void do_snapshot() override;
 
 private:
-    uint64_t total_kb_ = 0;
-    uint64_t free_kb_ = 0;
-    uint64_t available_kb_ = 0;
-    uint64_t buffers_kb_ = 0;
-    uint64_t cached_kb_ = 0;
+    ProcFile file_;
+    uint64_t fields_[meminfo::FIELD_COUNT] = {};
     uint64_t used_kb_ = 0;
     double usage_percent_ = 0.0;
+    SnapshotBuffer<Snapshot> snapshot_;
 };
 
 // ==================== 磁盘采集器 ====================
 class DiskCollector : public Collector {
 public:
-    std::string get_name() const override { return "disk"; }
-    void print_result() const override;
+    explicit DiskCollector(const std::string& proc_root = default_proc_root());
+
+    // 每块盘在 DeviceTable 中的计数器
+    enum Field {
+        READS_COMPLETED,
+        WRITES_COMPLETED,
+        SECTORS_READ,
+        SECTORS_WRITTEN,
+        FIELD_COUNT
+    };
+    static constexpr uint64_t SECTOR_BYTES = 512;  // diskstats 的扇区固定为 512 字节
+
+    // disks 的速率：次数/秒（IOPS）和扇区/秒
+    struct Snapshot {
+        DeviceSnapshot disks;
+    };
+
+    static constexpr const char* NAME = "disk";
+    std::string get_name() const override { return NAME; }
+    bool replayable() const override { return true; }
+    bool slow_start() const override { return true; }
+    void print_result(std::ostream& out) const override;
+    void prefetch(ProcFileBatch& batch) override;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
 
 protected:
     void do_collect() override;
     void do_parse() override;
+    void do_calculate() override;
+    void do_publish(MetricWriter& out) const override;
+    void do_snapshot() override;
 
 private:
-    struct DiskStats {
-        std::string name;
-        uint64_t reads_completed = 0;
-        uint64_t writes_completed = 0;
-        uint64_t sectors_read = 0;
-        uint64_t sectors_written = 0;
-    };
-    std::vector<DiskStats> disks_;
+    ProcFile file_;
+    DeviceTable disks_{FIELD_COUNT};
+    SnapshotBuffer<Snapshot> snapshot_;
 };
 
 // ==================== 网络采集器 ====================
 class NetworkCollector : public Collector {
 public:
-    std::string get_name() const override { return "network"; }
-    void print_result() const override;
+    explicit NetworkCollector(const std::string& proc_root = default_proc_root());
+
+    // 每个接口在 DeviceTable 中的计数器
+    enum Field {
+        RX_BYTES,
+        TX_BYTES,
+        RX_PACKETS,
+        TX_PACKETS,
+        FIELD_COUNT
+    };
+
+    // interfaces 的速率：字节/秒和包/秒
+    struct Snapshot {
+        DeviceSnapshot interfaces;
+    };
+
+    static constexpr const char* NAME = "network";
+    std::string get_name() const override { return NAME; }
+    bool replayable() const override { return true; }
+    bool slow_start() const override { return true; }
+    void print_result(std::ostream& out) const override;
+    void prefetch(ProcFileBatch& batch) override;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
 
 protected:
     void do_collect() override;
     void do_parse() override;
+    void do_calculate() override;
+    void do_publish(MetricWriter& out) const override;
+    void do_snapshot() override;
+
+    // do_parse() 的结果，替代后端按同样的方式填写
+    DeviceTable interfaces_{FIELD_COUNT};
 
 private:
-    struct InterfaceStats {
-        std::string name;
-        uint64_t rx_bytes = 0;
-        uint64_t tx_bytes = 0;
-        uint64_t rx_packets = 0;
-        uint64_t tx_packets = 0;
-    };
-    std::vector<InterfaceStats> interfaces_;
+    ProcFile file_;
+    SnapshotBuffer<Snapshot> snapshot_;
 };
 
 // ==================== 进程采集器 ====================
 class ProcessCollector : public Collector {
 public:
-    std::string get_name() const override { return "process"; }
-    void print_result() const override;
+    explicit ProcessCollector(const std::string& proc_root = default_proc_root());
+
+    // 线程下钻：Top N 进程中 CPU 最高的一个线程
+    struct ThreadEntry {
+        int tid = 0;
+        std::string name;
+        double cpu_percent = 0.0;
+    };
+    // Top N 中的一个进程
+    struct TopEntry {
+        int pid = 0;
+        std::string name;
+        int64_t rss = 0;             // 页数
+        int64_t rss_delta = 0;
+        double cpu_percent = 0.0;
+        std::vector<ThreadEntry> threads;  // 按 CPU 降序，未开启下钻时为空
+    };
+    struct Snapshot {
+        std::vector<TopEntry> top;   // 按 RSS 降序
+        size_t top_n = 0;
+        size_t thread_top = 0;
+        size_t threads_scanned = 0;  // 本 tick 读取的线程 stat 数
+        size_t sample_stride = 1;
+        int total_processes = 0;
+        int running_processes = 0;
+    };
+
+    static constexpr const char* NAME = "process";
+    std::string get_name() const override { return NAME; }
+    bool slow_start() const override { return true; }
+    void print_result(std::ostream& out) const override;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
+    void configure(const MonitorOptions& options) override;
+    void set_top_n(size_t n) { top_n_ = n; }
+    size_t top_n() const { return top_n_; }
+    // 抽样：每个 tick 只读取 pid % stride 等于当前轮次的进程的 stat，
+    // stride 个 tick 轮完一遍；其余进程保留上一次的数值。1 表示全部读取
+    void set_sample_stride(size_t stride);
+    size_t sample_stride() const { return stride_; }
+    // 扫描线程数，1 表示在调用线程上顺序扫描
+    void set_scan_threads(size_t threads);
+    // 线程下钻：每个 tick 只枚举上一轮 Top N 进程的 /proc/<pid>/task，
+    // 每个进程显示 CPU 最高的 n 个线程。0 表示关闭
+    void set_thread_top(size_t n) { thread_top_ = n; }
+    size_t thread_top() const { return thread_top_; }
+    // 用 io_uring 批量读取 stat，内核不支持时返回 false 并保持原来的路径
+    bool set_io_uring(bool enable);
 
 protected:
     void do_collect() override;
     void do_parse() override;
+    void do_publish(MetricWriter& out) const override;
+    void do_calculate() override;
+    void do_snapshot() override;
+
+    // 列出本次要扫描的 PID（钩子方法）：默认用 getdents64 枚举 /proc，
+    // 替代后端可以增量维护
+    virtual bool list_pids(std::vector<int>& pids);
+    // 进程表里有、本轮 list_pids() 却没有列出的进程是否保留（钩子方法）：
+    // 默认视为已退出；只列出活跃进程的后端返回 true，保留的进程本轮 CPU 记为 0
+    virtual bool keep_unlisted(int /*pid*/) const { return false; }
+    ProcessScanner& scanner() { return scanner_; }
 
 private:
+    // 进程表条目，槽位跨 tick 复用（包括 name 的容量）
     struct ProcessInfo {
-        int pid;
+        int pid = 0;                 // 0 表示空闲槽位
+        uint64_t starttime = 0;      // 与 pid 一起唯一标识进程，防止 PID 复用
         std::string name;
-        char state;
-        uint64_t vsize;
-        int64_t rss;
+        char state = '?';
+        uint64_t vsize = 0;
+        int64_t rss = 0;             // 页数
+        uint64_t utime = 0;          // 时钟滴答
+        uint64_t stime = 0;
+
+        // 上一次采样，用于计算增量
+        bool has_prev = false;
+        uint64_t prev_cpu_ticks = 0;
+        int64_t prev_rss = 0;
+
+        double cpu_percent = 0.0;
+        int64_t rss_delta = 0;
+        uint64_t generation = 0;     // 最后一次被扫描到的代数
+        std::chrono::steady_clock::time_point sampled_at{};  // 上一次读取 stat 的时间
+    };
+
+    struct ProcessKey {
+        int pid;
+        uint64_t starttime;
+        bool operator==(const ProcessKey& other) const {
+            return pid == other.pid && starttime == other.starttime;
+        }
+    };
+    struct ProcessKeyHash {
+        size_t operator()(const ProcessKey& key) const {
+            return std::hash<uint64_t>()(key.starttime * 0x9E3779B97F4A7C15ULL ^
+                                         static_cast<uint64_t>(key.pid));
+        }
     };
+
+    // 一个分片的扫描结果，每个线程只写自己的分片，跨 tick 复用
+    struct ScanShard {
+        std::vector<ProcStat> stats;
+        std::unique_ptr<StatBatchReader> batch;  // 启用 io_uring 时非空
+    };
+
+    // 线程下钻的一个样本，按 (pid, tid) 排序后与上一轮归并计算增量
+    struct ThreadSample {
+        int pid = 0;
+        int tid = 0;
+        uint64_t starttime = 0;
+        uint64_t cpu_ticks = 0;
+        double cpu_percent = 0.0;
+        char name[16] = {};          // 线程名最长 15 字节
+        uint8_t name_len = 0;
+    };
+
+    void scan_shard(size_t begin, size_t end, ScanShard& shard) const;
+    void merge_sample(const ProcStat& stat);
+    void scan_threads();
+    void calculate_threads();
+
+    ProcessScanner scanner_;
+    std::vector<int> pids_;                // do_collect 得到的 PID 列表
+    std::vector<int> sampled_;             // 抽样模式下本轮要读取的 PID
+    const std::vector<int>* targets_ = &pids_;  // 本轮实际读取的列表
+    size_t stride_ = 1;
+    size_t phase_ = 0;                     // 抽样轮次，0..stride_-1
+    std::vector<ScanShard> shards_;
+    std::unique_ptr<ThreadPool> pool_;     // 分片 1..n-1 的工作线程
+    TaskGroup shard_tasks_;
+
+    // 持久进程表：(pid, starttime) -> processes_ 中的槽位。
+    // 进程创建和退出时索引节点从池里取用和归还，不经过 malloc
     std::vector<ProcessInfo> processes_;
+    std::pmr::unsynchronized_pool_resource index_pool_;
+    std::pmr::unordered_map<ProcessKey, size_t, ProcessKeyHash> index_{&index_pool_};
+    std::vector<size_t> free_slots_;
+    std::vector<size_t> top_;              // 按 RSS 降序的前 top_n_ 个槽位
+    uint64_t generation_ = 0;
+    std::chrono::steady_clock::time_point scan_time_{};
+
+    // 线程下钻：两轮样本交替使用，容量跨 tick 复用
+    size_t thread_top_ = 0;
+    std::vector<int> drill_pids_;          // 上一轮的 Top N，本轮枚举它们的线程
+    std::vector<int> tids_;
+    std::vector<ThreadSample> threads_;
+    std::vector<ThreadSample> prev_threads_;
+    std::vector<size_t> hot_threads_;      // 每个 Top N 进程最热的线程下标，连续存放
+    std::vector<size_t> hot_begin_;        // 第 i 个进程的线程在 hot_threads_ 中的起点
+    std::chrono::steady_clock::time_point thread_scan_time_{};
+    std::chrono::steady_clock::time_point prev_thread_scan_time_{};
+
+    size_t top_n_ = 5;
+    bool io_uring_ = false;
     int total_processes_ = 0;
     int running_processes_ = 0;
+    SnapshotBuffer<Snapshot> snapshot_;
 };
 
 // ==================== 系统信息采集器 ====================
 class SystemCollector : public Collector {
 public:
-    std::string get_name() const override { return "system"; }
-    void print_result() const override;
+    explicit SystemCollector(const std::string& proc_root = default_proc_root());
+
+    struct Snapshot {
+        double uptime_seconds = 0.0;
+        double load_1min = 0.0;
+        double load_5min = 0.0;
+        double load_15min = 0.0;
+        int running_tasks = 0;
+        int total_tasks = 0;
+    };
+
+    static constexpr const char* NAME = "system";
+    std::string get_name() const override { return NAME; }
+    void print_result(std::ostream& out) const override;
+    void prefetch(ProcFileBatch& batch) override;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
 
 protected:
     void do_collect() override;
     void do_parse() override;
+    void do_publish(MetricWriter& out) const override;
+    void do_snapshot() override;
 
 private:
+    ProcFile uptime_file_;
+    ProcFile loadavg_file_;
     double uptime_seconds_ = 0.0;
     double load_1min_ = 0.0;
     double load_5min_ = 0.0;
     double load_15min_ = 0.0;
     int running_tasks_ = 0;
     int total_tasks_ = 0;
+    SnapshotBuffer<Snapshot> snapshot_;
 };
 
 #endif // COLLECTORS_H
\ No newline at end of file
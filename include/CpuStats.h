@@ -0,0 +1,66 @@
+#ifndef CPU_STATS_H
+#define CPU_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * CPU 时间计数器 (Structure of Arrays)
+ *
+ * /proc/stat 中每个 cpu 行有 8 个计数器。按字段而不是按 CPU 存放：
+ * 每个字段一段连续的 uint64_t 数组，下标 0 是汇总行 "cpu"，之后是各个核心。
+ * 这样差值和百分比可以按数组整段计算，编译器/SIMD 一次处理多个核心。
+ */
+enum CpuField {
+    CPU_USER,
+    CPU_NICE,
+    CPU_SYSTEM,
+    CPU_IDLE,
+    CPU_IOWAIT,
+    CPU_IRQ,
+    CPU_SOFTIRQ,
+    CPU_STEAL,
+    CPU_FIELD_COUNT
+};
+
+struct CpuTimes {
+    std::array<std::vector<uint64_t>, CPU_FIELD_COUNT> fields;
+
+    size_t size() const { return fields[0].size(); }
+    void resize(size_t n) {
+        for (auto& f : fields) f.resize(n);
+    }
+};
+
+// 两次采样之间各类时间占比（百分比），同样是 SoA
+struct CpuUsage {
+    std::vector<double> total;   // 100 - idle - iowait
+    std::vector<double> user;    // user + nice
+    std::vector<double> system;  // system + irq + softirq
+    std::vector<double> iowait;
+    std::vector<double> steal;
+
+    size_t size() const { return total.size(); }
+    void resize(size_t n) {
+        total.resize(n);
+        user.resize(n);
+        system.resize(n);
+        iowait.resize(n);
+        steal.resize(n);
+    }
+};
+
+// 计算 prev -> curr 的使用率，out 需已 resize 到相同大小。
+// 计数器回退（例如 iowait 在部分内核上会减小）按 0 处理。
+// 运行时检测 CPU：支持 AVX2 时使用向量实现，否则使用标量实现。
+void compute_cpu_usage(const CpuTimes& prev, const CpuTimes& curr, CpuUsage& out);
+
+// 具体实现，供基准测试对比
+void compute_cpu_usage_scalar(const CpuTimes& prev, const CpuTimes& curr, CpuUsage& out);
+#if defined(__x86_64__) || defined(__i386__)
+void compute_cpu_usage_avx2(const CpuTimes& prev, const CpuTimes& curr, CpuUsage& out);
+#endif
+
+#endif // CPU_STATS_H
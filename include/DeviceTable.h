@@ -0,0 +1,84 @@
+#ifndef DEVICE_TABLE_H
+#define DEVICE_TABLE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * 设备计数器表 (Device-Indexed Delta Table)
+ *
+ * 目的：磁盘和网卡的计数器是累计值，速率要用相邻两次采样的差值计算；
+ * 每次按名字查找上一次的同一设备需要字符串比较和哈希，设备多时成了主要开销
+ *
+ * 实现要点：
+ * 1. 每个设备一个槽位（slot），各字段按槽位连续存放在 prev/curr 两个扁平数组中，
+ *    速率按下标直接计算 curr[i] - prev[i]，不涉及名字
+ * 2. /proc 中设备的顺序是稳定的：解析时第 k 行只与槽位 k 的名字比较一次，
+ *    全部一致就沿用原有槽位。不一致（热插拔）时才重建槽位：仍然存在的设备
+ *    把上一次的计数器搬到新槽位，新出现的设备本次速率为 0
+ * 3. 计数器回绕：curr < prev 且 prev 位于 32 位计数器的上半区时按 2^32 回绕计算，
+ *    否则视为计数器被重置（设备重新注册），增量取 curr
+ * 4. 设备集合稳定后所有数组都不再分配；generation() 在设备集合变化时递增，
+ *    快照据此决定是否需要重新复制名字
+ */
+class DeviceTable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit DeviceTable(size_t fields) : fields_(fields) {}
+
+    size_t fields() const { return fields_; }
+    size_t size() const { return names_.size(); }
+    uint64_t generation() const { return generation_; }
+
+    const std::string& name(size_t slot) const { return names_[slot]; }
+    const uint64_t* counters(size_t slot) const { return &curr_[slot * fields_]; }
+    const double* rates(size_t slot) const { return &rates_[slot * fields_]; }
+
+    // 解析：begin_rows() 之后每个设备按文件顺序调用一次 row(name)，
+    // 向返回的 fields() 个计数器写入本次的值（已清零），最后调用 end_rows()
+    void begin_rows();
+    uint64_t* row(std::string_view name);
+    void end_rows();
+
+    // 用本次和上一次的计数器计算每秒速率，now 为本次采样时间
+    void compute_rates(Clock::time_point now);
+
+    // prev -> curr 的增量，处理 32 位回绕和计数器重置
+    static uint64_t counter_delta(uint64_t prev, uint64_t curr);
+
+private:
+    size_t fields_;
+    size_t rows_ = 0;          // 本次解析到的设备数
+    bool changed_ = false;     // 本次解析的设备序列与槽位不一致
+    uint64_t generation_ = 0;
+    std::vector<std::string> names_;          // 槽位 -> 名字
+    std::vector<std::string> pending_names_;  // 设备集合变化时本次的名字
+    std::vector<uint64_t> prev_;
+    std::vector<uint64_t> curr_;
+    std::vector<uint64_t> remap_;             // 重建槽位时搬运 prev_ 的临时数组
+    std::vector<double> rates_;
+    std::vector<uint8_t> fresh_;              // 1 表示没有上一次的计数器
+    Clock::time_point prev_time_{};
+};
+
+// 发布给读取方的设备表副本：名字只在设备集合变化时复制，计数器和速率是整段复制
+struct DeviceSnapshot {
+    uint64_t generation = 0;
+    size_t fields = 0;
+    std::vector<std::string> names;
+    std::vector<uint64_t> counters;
+    std::vector<double> rates;
+
+    size_t size() const { return names.size(); }
+    uint64_t counter(size_t slot, size_t field) const { return counters[slot * fields + field]; }
+    double rate(size_t slot, size_t field) const { return rates[slot * fields + field]; }
+
+    void assign(const DeviceTable& table);
+};
+
+#endif // DEVICE_TABLE_H
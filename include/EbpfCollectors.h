@@ -0,0 +1,99 @@
+#ifndef EBPF_COLLECTORS_H
+#define EBPF_COLLECTORS_H
+
+#include "Collectors.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * eBPF 后端 (eBPF Backend)
+ *
+ * 目的：大部分 PID 在一个 tick 内根本没有运行，逐个读取它们的 stat 是白费；
+ * 调度器本身知道谁运行过，在内核里聚合之后用户态只需要读 map
+ *
+ * 实现要点：
+ * 1. 三个 raw tracepoint 程序（sched_switch、sched_wakeup/_new、sched_process_exit）
+ *    用 bpf::Assembler 手写，不需要 clang 和 libbpf
+ * 2. sched_switch 按线程组累加 CPU 时间（cpu_ns，tgid -> ns），
+ *    每个 tick 用 LOOKUP_AND_DELETE_BATCH 一次取空：键就是本轮运行过的进程
+ * 3. 每个 CPU 上正在运行的线程组记在 PERCPU map 里，一直没有被切换出去的进程也会被列出
+ * 4. 唤醒到开始运行的时间（运行队列延迟）在内核里按 log2 微秒分桶，用户态只读 32 个计数
+ * 5. 之后每个 tick 只读取活跃进程的 stat：没运行的进程 CPU 为 0，RSS 保持上一次的值；
+ *    退出事件（exited map）把进程移出进程表，每 RESYNC_TICKS 个 tick 完整扫描一次兜底
+ *
+ * 需要 CAP_BPF + CAP_PERFMON 和内核 BTF；加载失败或 proc 根目录不是 /proc 时
+ * 退回每个 tick 完整扫描。已退出、尚未回收的僵尸进程不显示；
+ * 同一 tick 内退出又被复用的 PID 要等新进程下次运行才会出现。
+ */
+class EbpfProcessCollector : public ProcessCollector {
+public:
+    static constexpr int HIST_SLOTS = 32;      // 第 i 个桶是 [2^i, 2^(i+1)) 微秒，0 号含 0~1
+    static constexpr size_t RESYNC_TICKS = 60;
+
+    // 运行队列延迟：本 tick 的增量
+    struct SchedSnapshot {
+        bool enabled = false;
+        std::array<uint64_t, HIST_SLOTS> hist{};
+        uint64_t wakeups = 0;        // 本 tick 被调度上 CPU 的唤醒次数
+        uint64_t p50_us = 0;         // 所在桶的上界
+        uint64_t p99_us = 0;
+        uint64_t max_us = 0;
+        size_t active_processes = 0; // 本 tick 运行过的进程数
+        bool full_scan = false;
+    };
+
+    explicit EbpfProcessCollector(const std::string& proc_root = default_proc_root());
+    ~EbpfProcessCollector() override;
+
+    void print_result(std::ostream& out) const override;
+    SnapshotBuffer<SchedSnapshot>::Reader sched_snapshot() const { return sched_.read(); }
+    bool attached() const { return attached_; }
+
+protected:
+    bool list_pids(std::vector<int>& pids) override;
+    bool keep_unlisted(int pid) const override;
+    void do_publish(MetricWriter& out) const override;
+    void do_snapshot() override;
+
+private:
+    // 每个 CPU 一个：上一次切换的时间和正在运行的线程组
+    struct OnCpu {
+        uint64_t start_ns;
+        uint32_t tgid;
+        uint32_t pad;
+    };
+
+    bool attach();
+    void detach();
+    bool load_programs(uint32_t pid_off, uint32_t tgid_off);
+    void read_histogram();
+
+    bool use_bpf_;              // false 时每个 tick 完整扫描
+    bool attached_ = false;
+    int wakeup_map_ = -1;       // pid -> 唤醒时间
+    int oncpu_map_ = -1;        // PERCPU：OnCpu
+    int cpu_map_ = -1;          // tgid -> 本 tick 的 CPU 时间
+    int hist_map_ = -1;         // 运行队列延迟的累计计数
+    int exit_map_ = -1;         // 本 tick 退出的 tgid
+    std::vector<int> fds_;      // 程序和挂载点，关闭即卸载
+
+    size_t ticks_ = 0;
+    bool full_scan_ = true;     // 本轮 list_pids() 是完整扫描
+    std::vector<uint32_t> keys_;          // cpu_ns 的键：本 tick 运行过的进程
+    std::vector<uint64_t> cpu_ns_;
+    std::vector<uint32_t> exit_keys_;
+    std::vector<uint32_t> exit_values_;
+    std::vector<OnCpu> oncpu_;
+    std::vector<int> exited_;   // 本 tick 退出的进程，有序
+    std::array<uint64_t, HIST_SLOTS> hist_{};       // 内核里的累计值
+    std::array<uint64_t, HIST_SLOTS> hist_delta_{};
+    uint64_t wakeups_ = 0;
+    uint64_t p50_us_ = 0;
+    uint64_t p99_us_ = 0;
+    uint64_t max_us_ = 0;
+    size_t active_ = 0;
+    SnapshotBuffer<SchedSnapshot> sched_;
+};
+
+#endif // EBPF_COLLECTORS_H
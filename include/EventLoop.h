@@ -0,0 +1,60 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * epoll 事件循环 (Reactor Pattern)
+ *
+ * 目的：把 main() 里手写的 epoll_create / epoll_ctl / epoll_wait 收拢到一处，
+ * 定时器、以后的网络监听等 fd 都注册到同一个 epfd 上
+ *
+ * 用法：
+ *   EventLoop loop;
+ *   loop.add_timer(std::chrono::milliseconds(100), [](uint64_t) { ... });
+ *   while (loop.run_once()) { ... 本轮事件分发完毕后的工作 ... }
+ *
+ * 所有回调都在调用 run_once() 的线程上执行。
+ */
+class EventLoop {
+public:
+    using Handler = std::function<void(uint32_t events)>;
+    using TimerHandler = std::function<void(uint64_t expirations)>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool valid() const { return epfd_ != -1; }
+    int fd() const { return epfd_; }
+
+    // 注册/修改/移除 fd，fd 的所有权仍属于调用方
+    bool add(int fd, uint32_t events, Handler handler);
+    bool modify(int fd, uint32_t events);
+    void remove(int fd);
+
+    // 创建周期性 timerfd 并注册，首次立即触发；armed 为 false 时先不启动，
+    // 用 set_timer() 启动。timerfd 由事件循环持有，返回 timerfd，失败返回 -1
+    int add_timer(std::chrono::nanoseconds interval, TimerHandler handler,
+                  bool armed = true);
+    // 修改已注册定时器的周期（下一次在 interval 后触发），interval 为 0 时停止
+    bool set_timer(int tfd, std::chrono::nanoseconds interval);
+
+    // 等待并分发一批事件；timeout_ms 为 -1 时一直等待
+    // 返回 false 表示 epoll_wait 出错
+    bool run_once(int timeout_ms = -1);
+
+private:
+    int epfd_ = -1;
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+    std::vector<int> timers_;
+};
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,93 @@
+#ifndef FRAME_RENDERER_H
+#define FRAME_RENDERER_H
+
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * 帧缓冲区：ostream 写入预分配的内存，不触发任何系统调用
+ *
+ * 容量不足时翻倍，达到稳定大小后不再分配。
+ */
+class FrameBuffer : public std::streambuf {
+public:
+    explicit FrameBuffer(size_t capacity);
+
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+    // 清空内容，保留容量
+    void reset();
+
+    std::string_view view() const {
+        return std::string_view(pbase(), static_cast<size_t>(pptr() - pbase()));
+    }
+
+protected:
+    int_type overflow(int_type ch) override;
+
+private:
+    std::vector<char> buf_;
+};
+
+/**
+ * 差分渲染器 (Frame Diffing Renderer)
+ *
+ * 目的：替代每帧清屏 + 全量重绘，消除闪烁并减少通过 SSH 发送的字节数
+ *
+ * 实现要点：
+ * 1. begin_frame() 返回写入帧缓冲区的 ostream，各采集器 print_result() 写入其中
+ * 2. end_frame() 按行与上一帧比较，只输出变化的行：
+ *    光标定位 "\033[<行>;1H" + 行内容 + 清除到行尾 "\033[K"，
+ *    相邻的变化行直接换行，不重复定位；帧变短时清除多出的行
+ * 3. 转义序列和变化行拼接到同一个缓冲区，每帧只调用一次 write()
+ * 4. 两帧缓冲区交替使用，稳定后不再分配
+ *
+ * 第一帧清屏后全量输出。假设每行不超过终端宽度（否则自动换行会打乱行号）。
+ */
+class FrameRenderer {
+public:
+    explicit FrameRenderer(int fd = 1, size_t capacity = 64 * 1024);
+
+    FrameRenderer(const FrameRenderer&) = delete;
+    FrameRenderer& operator=(const FrameRenderer&) = delete;
+
+    // 开始新的一帧，返回的流在 end_frame() 之前有效
+    std::ostream& begin_frame();
+
+    // 与上一帧比较并输出差异，写入失败返回 false
+    bool end_frame();
+
+    // 下一帧清屏后全量输出（例如终端被其他输出弄乱之后）
+    void invalidate() { full_redraw_ = true; }
+
+    // 上一帧实际写出的字节数和变化的行数
+    size_t last_bytes() const { return last_bytes_; }
+    size_t last_changed_lines() const { return last_changed_lines_; }
+
+private:
+    struct LineSpan {
+        size_t offset;
+        size_t length;
+    };
+
+    static void split_lines(std::string_view frame, std::vector<LineSpan>& lines);
+    void append_cursor_move(size_t line);
+    bool write_all(std::string_view data);
+
+    int fd_;
+    FrameBuffer buffers_[2];
+    std::ostream stream_;
+    int current_ = 0;                  // 正在写入的缓冲区下标
+    std::vector<LineSpan> lines_[2];
+    std::string out_;                  // 本帧要写出的字节
+    bool full_redraw_ = true;
+    size_t last_bytes_ = 0;
+    size_t last_changed_lines_ = 0;
+};
+
+#endif // FRAME_RENDERER_H
@@ -0,0 +1,288 @@
+#ifndef GORILLA_H
+#define GORILLA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Gorilla 时间序列压缩 (Facebook Gorilla, VLDB 2015)
+ *
+ * 目的：把 (时间戳, 浮点数) 样本压缩到每个样本几个比特
+ *
+ * 实现要点：
+ * 1. 第一个样本原样写入 64 位时间戳和 64 位数值
+ * 2. 时间戳写 delta-of-delta（本次间隔减上次间隔），按大小分 5 档：
+ *    '0' | '10'+7 位 | '110'+9 位 | '1110'+12 位 | '1111'+32 位（补码）
+ * 3. 数值与上一个值按位异或：相同写 '0'；落在上一次的有效位窗口内写
+ *    '10' + 窗口内的位；否则写 '11' + 5 位前导零个数 + 6 位有效位数 + 有效位
+ *
+ * 编码器和解码器都只操作调用方提供的缓冲区，不分配内存；
+ * 解码器可以直接读取 mmap 的文件内容。
+ */
+
+// 按高位在前写入比特，缓冲区由调用方提供
+class BitWriter {
+public:
+    BitWriter(uint8_t* buf, size_t capacity_bytes) : buf_(buf), capacity_(capacity_bytes) {
+        reset();
+    }
+
+    void reset() {
+        std::memset(buf_, 0, capacity_);
+        bit_pos_ = 0;
+    }
+
+    // 写入 value 的低 bits 位（1~64）
+    void write(uint64_t value, int bits) {
+        while (bits > 0) {
+            int room = 8 - static_cast<int>(bit_pos_ & 7);
+            int take = bits < room ? bits : room;
+            unsigned chunk = static_cast<unsigned>(value >> (bits - take)) & ((1u << take) - 1);
+            buf_[bit_pos_ >> 3] |= static_cast<uint8_t>(chunk << (room - take));
+            bit_pos_ += static_cast<size_t>(take);
+            bits -= take;
+        }
+    }
+
+    size_t bit_count() const { return bit_pos_; }
+    size_t byte_count() const { return (bit_pos_ + 7) / 8; }
+    size_t capacity_bits() const { return capacity_ * 8; }
+    const uint8_t* data() const { return buf_; }
+
+private:
+    uint8_t* buf_;
+    size_t capacity_;
+    size_t bit_pos_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t bit_count) : data_(data), bit_count_(bit_count) {}
+
+    bool has(size_t bits) const { return bit_pos_ + bits <= bit_count_; }
+
+    uint64_t read(int bits) {
+        uint64_t value = 0;
+        while (bits > 0) {
+            int room = 8 - static_cast<int>(bit_pos_ & 7);
+            int take = bits < room ? bits : room;
+            unsigned chunk = (static_cast<unsigned>(data_[bit_pos_ >> 3]) >> (room - take)) &
+                             ((1u << take) - 1);
+            value = (value << take) | chunk;
+            bit_pos_ += static_cast<size_t>(take);
+            bits -= take;
+        }
+        return value;
+    }
+
+    bool read_bit() { return read(1) != 0; }
+
+private:
+    const uint8_t* data_;
+    size_t bit_count_;
+    size_t bit_pos_ = 0;
+};
+
+class GorillaEncoder {
+public:
+    // 单个样本最多占用的比特数：'1111'+32 位时间戳，'11'+5+6+64 位数值
+    static constexpr size_t MAX_SAMPLE_BITS = 4 + 32 + 2 + 5 + 6 + 64;
+
+    GorillaEncoder(uint8_t* buf, size_t capacity_bytes) : writer_(buf, capacity_bytes) {}
+
+    // 追加一个样本；缓冲区剩余空间不足或间隔变化超出 32 位时返回 false，
+    // 调用方应当封存当前块后 reset() 重新开始
+    bool append(int64_t timestamp_ms, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        if (count_ == 0) {
+            if (writer_.capacity_bits() < 128)
+                return false;
+            writer_.write(static_cast<uint64_t>(timestamp_ms), 64);
+            writer_.write(bits, 64);
+            first_ts_ = timestamp_ms;
+        } else {
+            if (writer_.bit_count() + MAX_SAMPLE_BITS > writer_.capacity_bits())
+                return false;
+            int64_t delta = timestamp_ms - prev_ts_;
+            int64_t dod = delta - prev_delta_;
+            if (dod < INT32_MIN || dod > INT32_MAX)
+                return false;
+            write_dod(dod);
+            write_xor(bits ^ prev_value_);
+            prev_delta_ = delta;
+        }
+        prev_ts_ = timestamp_ms;
+        prev_value_ = bits;
+        ++count_;
+        return true;
+    }
+
+    void reset() {
+        writer_.reset();
+        count_ = 0;
+        prev_delta_ = 0;
+        leading_ = 64;
+        trailing_ = 64;
+    }
+
+    uint32_t count() const { return count_; }
+    int64_t first_timestamp() const { return first_ts_; }
+    int64_t last_timestamp() const { return prev_ts_; }
+    size_t bit_count() const { return writer_.bit_count(); }
+    size_t byte_count() const { return writer_.byte_count(); }
+    const uint8_t* data() const { return writer_.data(); }
+
+private:
+    void write_dod(int64_t dod) {
+        uint64_t u = static_cast<uint64_t>(dod);
+        if (dod == 0) {
+            writer_.write(0, 1);
+        } else if (dod >= -64 && dod <= 63) {
+            writer_.write(0b10, 2);
+            writer_.write(u, 7);
+        } else if (dod >= -256 && dod <= 255) {
+            writer_.write(0b110, 3);
+            writer_.write(u, 9);
+        } else if (dod >= -2048 && dod <= 2047) {
+            writer_.write(0b1110, 4);
+            writer_.write(u, 12);
+        } else {
+            writer_.write(0b1111, 4);
+            writer_.write(u, 32);
+        }
+    }
+
+    void write_xor(uint64_t x) {
+        if (x == 0) {
+            writer_.write(0, 1);
+            return;
+        }
+        int leading = __builtin_clzll(x);
+        int trailing = __builtin_ctzll(x);
+        if (leading > 31)
+            leading = 31; // 5 位字段
+        if (leading >= leading_ && trailing >= trailing_) {
+            writer_.write(0b10, 2);
+            writer_.write(x >> trailing_, 64 - leading_ - trailing_);
+        } else {
+            int significant = 64 - leading - trailing;
+            writer_.write(0b11, 2);
+            writer_.write(static_cast<uint64_t>(leading), 5);
+            writer_.write(static_cast<uint64_t>(significant & 63), 6); // 64 记为 0
+            writer_.write(x >> trailing, significant);
+            leading_ = leading;
+            trailing_ = trailing;
+        }
+    }
+
+    BitWriter writer_;
+    uint32_t count_ = 0;
+    int64_t first_ts_ = 0;
+    int64_t prev_ts_ = 0;
+    int64_t prev_delta_ = 0;
+    uint64_t prev_value_ = 0;
+    int leading_ = 64; // 上一个有效位窗口，64 表示还没有窗口
+    int trailing_ = 64;
+};
+
+class GorillaDecoder {
+public:
+    GorillaDecoder(const uint8_t* data, size_t bit_count, uint32_t count)
+        : reader_(data, bit_count), remaining_(count) {}
+
+    // 依次取出样本，结束或数据损坏时返回 false
+    bool next(int64_t& timestamp_ms, double& value) {
+        if (remaining_ == 0)
+            return false;
+
+        if (first_) {
+            if (!reader_.has(128))
+                return false;
+            prev_ts_ = static_cast<int64_t>(reader_.read(64));
+            prev_value_ = reader_.read(64);
+            first_ = false;
+        } else {
+            int64_t dod;
+            uint64_t x;
+            if (!read_dod(dod) || !read_xor(x))
+                return false;
+            prev_delta_ += dod;
+            prev_ts_ += prev_delta_;
+            prev_value_ ^= x;
+        }
+        --remaining_;
+        timestamp_ms = prev_ts_;
+        std::memcpy(&value, &prev_value_, sizeof(value));
+        return true;
+    }
+
+private:
+    static int64_t sign_extend(uint64_t v, int bits) {
+        uint64_t sign = 1ULL << (bits - 1);
+        return static_cast<int64_t>((v ^ sign) - sign);
+    }
+
+    bool read_dod(int64_t& dod) {
+        static constexpr int WIDTHS[] = {7, 9, 12, 32};
+        int prefix = 0;
+        while (prefix < 4) {
+            if (!reader_.has(1))
+                return false;
+            if (!reader_.read_bit())
+                break;
+            ++prefix;
+        }
+        if (prefix == 0) {
+            dod = 0;
+            return true;
+        }
+        int width = WIDTHS[prefix - 1];
+        if (!reader_.has(static_cast<size_t>(width)))
+            return false;
+        dod = sign_extend(reader_.read(width), width);
+        return true;
+    }
+
+    bool read_xor(uint64_t& x) {
+        if (!reader_.has(1))
+            return false;
+        if (!reader_.read_bit()) {
+            x = 0;
+            return true;
+        }
+        if (!reader_.has(1))
+            return false;
+        if (reader_.read_bit()) {
+            if (!reader_.has(11))
+                return false;
+            leading_ = static_cast<int>(reader_.read(5));
+            int significant = static_cast<int>(reader_.read(6));
+            if (significant == 0)
+                significant = 64;
+            trailing_ = 64 - leading_ - significant;
+            if (trailing_ < 0)
+                return false;
+        } else if (leading_ + trailing_ >= 64) {
+            return false; // 还没有窗口
+        }
+        int significant = 64 - leading_ - trailing_;
+        if (!reader_.has(static_cast<size_t>(significant)))
+            return false;
+        x = reader_.read(significant) << trailing_;
+        return true;
+    }
+
+    BitReader reader_;
+    uint32_t remaining_;
+    bool first_ = true;
+    int64_t prev_ts_ = 0;
+    int64_t prev_delta_ = 0;
+    uint64_t prev_value_ = 0;
+    int leading_ = 64;
+    int trailing_ = 0;
+};
+
+#endif // GORILLA_H
@@ -0,0 +1,91 @@
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+/**
+ * io_uring 的最小封装（直接使用系统调用，不依赖 liburing）
+ *
+ * 目的：把一个 tick 内的多次读取合并成一次 io_uring_enter，
+ * 减少 /proc 采集路径上的系统调用次数
+ *
+ * 实现要点：
+ * 1. init() 调用 io_uring_setup 并映射 SQ/CQ 环，内核不支持或被 seccomp
+ *    禁止时返回 false，调用方退回 pread 路径
+ * 2. get_sqe() 只在用户态填充提交队列，submit_and_wait() 一次系统调用
+ *    提交全部 SQE 并等待指定数量的完成事件
+ * 3. 支持注册缓冲区（READ_FIXED）和稀疏的固定文件表（OPENAT 直接描述符）
+ *
+ * 一个 IoUring 只能由一个线程使用。
+ */
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // 创建至少 entries 个提交槽位的环，失败返回 false
+    bool init(unsigned entries);
+    bool ready() const { return ring_fd_ != -1; }
+
+    // 当前进程能否使用 io_uring（探测一次后缓存结果）
+    static bool supported();
+
+    // 注册缓冲区，替换之前注册的（READ_FIXED 的 buf_index 指向这里）
+    bool register_buffers(const iovec* iovs, unsigned count);
+    // 注册 count 个空的固定文件槽位，供 OPENAT 的 file_index 使用
+    bool register_sparse_files(unsigned count);
+
+    // 取一个清零的 SQE，提交队列满时返回 nullptr
+    io_uring_sqe* get_sqe();
+    unsigned sq_entries() const { return sq_entries_; }
+
+    // 提交所有已填充的 SQE，并等待至少 wait_nr 个完成事件；失败返回 -errno
+    int submit_and_wait(unsigned wait_nr);
+
+    // 依次处理已完成的事件 fn(user_data, res)，返回处理的数量
+    template <typename F>
+    unsigned drain(F&& fn) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned count = 0;
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            fn(cqe.user_data, cqe.res);
+            ++head;
+            ++count;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+private:
+    void release();
+
+    int ring_fd_ = -1;
+    unsigned sq_entries_ = 0;
+    unsigned pending_ = 0;  // 已填充、尚未提交的 SQE 数
+
+    void* sq_ring_ = nullptr;
+    size_t sq_ring_bytes_ = 0;
+    void* cq_ring_ = nullptr;   // 与 sq_ring_ 共用一次映射时为 nullptr
+    size_t cq_ring_bytes_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_bytes_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+#endif // IO_URING_H
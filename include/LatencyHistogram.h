@@ -0,0 +1,87 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * 无锁对数分桶延迟直方图
+ *
+ * 以纳秒记录。桶按 2 的幂划分，每个 2 的幂再细分为 SUB_BUCKETS 份，
+ * 相对误差不超过 1/SUB_BUCKETS。record() 只做 relaxed 原子操作，
+ * 多个线程可以同时写入，读取方拿到的是近似一致的快照。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 2;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int BUCKETS = 64 * SUB_BUCKETS;
+
+    void record(uint64_t ns) {
+        buckets_[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (ns > prev &&
+               !max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    uint64_t mean() const {
+        uint64_t n = count();
+        return n ? sum_.load(std::memory_order_relaxed) / n : 0;
+    }
+
+    // 第 p (0~100) 百分位，返回所在桶的上界，结果不超过 max()
+    uint64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p / 100.0 * static_cast<double>(n));
+        if (target >= n) target = n - 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += buckets_[b].load(std::memory_order_relaxed);
+            if (seen > target) {
+                uint64_t upper = bucket_upper(b);
+                return upper < max() ? upper : max();
+            }
+        }
+        return max();
+    }
+
+private:
+    // 小于 SUB_BUCKETS 的值各占一个桶；其余按最高位 + 之后 SUB_BITS 位分桶
+    static int bucket_of(uint64_t v) {
+        if (v < SUB_BUCKETS) return static_cast<int>(v);
+        int msb = 63 - __builtin_clzll(v);
+        int sub = static_cast<int>((v >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1));
+        return (msb - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t bucket_upper(int b) {
+        if (b < SUB_BUCKETS) return static_cast<uint64_t>(b);
+        int msb = b / SUB_BUCKETS + SUB_BITS - 1;
+        uint64_t sub = static_cast<uint64_t>(b % SUB_BUCKETS);
+        uint64_t base = (1ULL << msb) | (sub << (msb - SUB_BITS));
+        return base + (1ULL << (msb - SUB_BITS)) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// 一个采集器 update() 各阶段的统计
+struct PhaseStats {
+    LatencyHistogram collect;
+    LatencyHistogram parse;
+    LatencyHistogram calculate;
+    LatencyHistogram total;
+    std::atomic<uint64_t> allocations{0};  // 所有 update() 的分配次数之和
+};
+
+#endif // LATENCY_HISTOGRAM_H
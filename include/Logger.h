@@ -1,22 +1,36 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
-#include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
+
+// 编译期日志级别下限（0=DEBUG 1=INFO 2=WARNING 3=ERROR），默认 Release 去掉 DEBUG；
+// 低于下限的 LOG_* 调用连同消息参数的构造一起被编译器删除
+#ifndef SYSMON_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define SYSMON_LOG_MIN_LEVEL 1
+#else
+#define SYSMON_LOG_MIN_LEVEL 0
+#endif
+#endif
 
 /**
  * 单例模式 (Singleton Pattern)
- * 
+ *
  * 目的：确保一个类只有一个实例，并提供全局访问点
- * 
+ *
  * 实现要点：
  * 1. 私有构造函数 - 防止外部创建实例
  * 2. 删除拷贝构造和赋值运算符 - 防止复制
  * 3. 静态成员函数返回唯一实例
  * 4. C++11 的 static 局部变量是线程安全的
+ *
+ * 异步模式 (start_async)：调用线程只把格式化好的定长记录放进无锁队列，
+ * 后台线程批量写到文件或 stderr；队列满时丢弃并计数，调用线程永远不阻塞。
+ * 时间戳按线程缓存，同一秒内不再调用 localtime_r。
+ * 入队前后各一次原子计数，stop_async() 等计数清零后才释放队列。
  */
 class Logger {
 public:
@@ -28,6 +42,13 @@ public:
         ERROR
     };
 
+    static constexpr Level COMPILED_LEVEL = static_cast<Level>(SYSMON_LOG_MIN_LEVEL);
+
+    // 单条记录的最大字节数（含时间戳和级别），超出部分截断
+    static constexpr size_t RECORD_BYTES = 256;
+    // 异步队列容量（条）
+    static constexpr size_t QUEUE_RECORDS = 1024;
+
     // 获取单例实例 - 这是单例模式的核心
     static Logger& instance() {
         static Logger inst;  // C++11 保证线程安全的懒汉式单例
@@ -38,8 +59,25 @@ public:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    ~Logger();
+
+    static constexpr bool compiled_in(Level level) { return level >= COMPILED_LEVEL; }
+
     // 设置日志级别
-    void set_level(Level level) { current_level_ = level; }
+    void set_level(Level level) { current_level_.store(level, std::memory_order_relaxed); }
+    bool enabled(Level level) const {
+        return level >= current_level_.load(std::memory_order_relaxed);
+    }
+
+    // 切换到异步模式，path 为空时写 stderr；失败返回 false 并保持同步模式。
+    // 应在创建其他线程之前调用
+    bool start_async(const std::string& path = std::string());
+    // 写完队列中剩余的记录并停止后台线程，回到同步模式。
+    // 其他线程可以继续写日志：正在入队的调用结束之前不释放队列，之后的调用走同步输出
+    void stop_async();
+
+    // 异步模式下因队列满而丢弃的记录数
+    uint64_t dropped() const;
 
     // 日志输出方法
     void debug(const std::string& msg) {
@@ -59,43 +97,32 @@ public:
     }
 
 private:
+    struct AsyncSink;  // 队列和后台线程，定义在 Logger.cpp
+
     // 私有构造函数 - 单例模式的关键
-    Logger() : current_level_(Level::INFO) {}
-
-    Level current_level_;
-
-    void log(Level level, const std::string& msg) {
-        if (level < current_level_) return;
-
-        // 获取时间戳
-        auto now = std::time(nullptr);
-        auto tm = std::localtime(&now);
-        
-        std::ostringstream oss;
-        oss << "[" << std::put_time(tm, "%H:%M:%S") << "] ";
-        
-        // 级别标签
-        switch (level) {
-            case Level::DEBUG:   oss << "[DEBUG] "; break;
-            case Level::INFO:    oss << "[INFO] "; break;
-            case Level::WARNING: oss << "[WARN] "; break;
-            case Level::ERROR:   oss << "[ERROR] "; break;
-        }
-        
-        oss << msg;
-        
-        if (level >= Level::WARNING) {
-            std::cerr << oss.str() << std::endl;
-        } else {
-            std::cout << oss.str() << std::endl;
-        }
-    }
+    Logger();
+
+    void log(Level level, const std::string& msg);
+
+    std::atomic<Level> current_level_;
+    std::unique_ptr<AsyncSink> async_;
+    std::atomic<AsyncSink*> active_{nullptr};  // 异步模式下指向 async_
+    std::atomic<uint32_t> writers_{0};         // 正在使用 active_ 的 log() 调用数
 };
 
-// 便捷宏，简化日志调用
-#define LOG_DEBUG(msg) Logger::instance().debug(msg)
-#define LOG_INFO(msg)  Logger::instance().info(msg)
-#define LOG_WARN(msg)  Logger::instance().warning(msg)
-#define LOG_ERROR(msg) Logger::instance().error(msg)
+// 便捷宏，简化日志调用；级别关闭时不构造消息字符串
+#define SYSMON_LOG(level, method, msg)                          \
+    do {                                                        \
+        if constexpr (Logger::compiled_in(level)) {             \
+            Logger& sysmon_logger_ = Logger::instance();        \
+            if (sysmon_logger_.enabled(level))                  \
+                sysmon_logger_.method(msg);                     \
+        }                                                       \
+    } while (0)
+
+#define LOG_DEBUG(msg) SYSMON_LOG(Logger::Level::DEBUG, debug, msg)
+#define LOG_INFO(msg)  SYSMON_LOG(Logger::Level::INFO, info, msg)
+#define LOG_WARN(msg)  SYSMON_LOG(Logger::Level::WARNING, warning, msg)
+#define LOG_ERROR(msg) SYSMON_LOG(Logger::Level::ERROR, error, msg)
 
 #endif // LOGGER_H
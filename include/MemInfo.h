@@ -0,0 +1,92 @@
+#ifndef MEM_INFO_H
+#define MEM_INFO_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * meminfo 字段表
+ *
+ * /proc/meminfo 和 /sys/devices/system/node/node<N>/meminfo 共用一张表：
+ * MemoryCollector 解析全局文件（整个进程里只有它读 /proc/meminfo），
+ * NumaCollector 解析节点文件。字段名通过编译期完美哈希（PerfectHash.h）查找，
+ * 每个文件逐行扫描一遍，每行一次哈希和一次比较。
+ *
+ * 数值单位是 KB，HugePages_* 是页数；文件里没有的字段为 0。
+ */
+namespace meminfo {
+
+enum Field {
+    MEM_TOTAL,
+    MEM_FREE,
+    MEM_AVAILABLE,
+    MEM_USED,             // 只在节点文件中
+    BUFFERS,
+    CACHED,
+    SWAP_CACHED,
+    ACTIVE,
+    INACTIVE,
+    ACTIVE_ANON,
+    INACTIVE_ANON,
+    ACTIVE_FILE,
+    INACTIVE_FILE,
+    UNEVICTABLE,
+    MLOCKED,
+    SWAP_TOTAL,
+    SWAP_FREE,
+    ZSWAP,
+    ZSWAPPED,
+    DIRTY,
+    WRITEBACK,
+    FILE_PAGES,           // 只在节点文件中
+    ANON_PAGES,
+    MAPPED,
+    SHMEM,
+    KRECLAIMABLE,
+    SLAB,
+    SRECLAIMABLE,
+    SUNRECLAIM,
+    KERNEL_STACK,
+    SHADOW_CALL_STACK,
+    PAGE_TABLES,
+    SEC_PAGE_TABLES,
+    NFS_UNSTABLE,
+    BOUNCE,
+    WRITEBACK_TMP,
+    COMMIT_LIMIT,
+    COMMITTED_AS,
+    VMALLOC_TOTAL,
+    VMALLOC_USED,
+    VMALLOC_CHUNK,
+    PERCPU,
+    HARDWARE_CORRUPTED,
+    ANON_HUGE_PAGES,
+    SHMEM_HUGE_PAGES,
+    SHMEM_PMD_MAPPED,
+    FILE_HUGE_PAGES,
+    FILE_PMD_MAPPED,
+    CMA_TOTAL,
+    CMA_FREE,
+    UNACCEPTED,
+    BALLOON,
+    HUGEPAGES_TOTAL,      // 页数
+    HUGEPAGES_FREE,
+    HUGEPAGES_RSVD,
+    HUGEPAGES_SURP,
+    HUGEPAGE_SIZE,        // Hugepagesize，KB
+    HUGETLB,
+    DIRECT_MAP_4K,
+    DIRECT_MAP_2M,
+    DIRECT_MAP_1G,
+    FIELD_COUNT
+};
+
+// 字段在文件中的键名（不含冒号）
+std::string_view key(Field field);
+
+// 单遍解析一个 meminfo（节点文件每行带 "Node <N> " 前缀），没出现的字段不修改
+void parse(std::string_view raw, uint64_t* values);
+
+} // namespace meminfo
+
+#endif // MEM_INFO_H
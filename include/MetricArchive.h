@@ -0,0 +1,247 @@
+#ifndef METRIC_ARCHIVE_H
+#define METRIC_ARCHIVE_H
+
+#include "Gorilla.h"
+#include "MetricStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * 归档段文件格式
+ *
+ *   SegmentHeader | Record | Record | ...
+ *
+ * 每条记录以 RecordHeader 开头，按 8 字节对齐。METRIC 记录定义段内的
+ * 指标 id，BLOCK 记录保存一个指标的一段 Gorilla 压缩样本。
+ * 段内某个指标的 METRIC 记录总是出现在它的第一条 BLOCK 记录之前。
+ * 头部的 used 在每条记录写完后用 release 语义更新，读取方只看 used 之前的内容。
+ */
+namespace archive {
+
+constexpr char MAGIC[8] = {'S', 'M', 'A', 'R', 'C', 'H', '0', '1'};
+constexpr uint32_t VERSION = 1;
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t capacity;    // 文件大小
+    uint64_t used;        // 有效内容的字节数（含头部）
+    int64_t created_ms;
+};
+
+enum RecordType : uint32_t {
+    RECORD_METRIC = 1,
+    RECORD_BLOCK = 2,
+};
+
+struct RecordHeader {
+    uint32_t type;
+    uint32_t size;  // 记录体字节数，不含 RecordHeader 和对齐填充
+};
+
+// METRIC 记录体：MetricRecord 之后依次是 name、label_key、label_value
+struct MetricRecord {
+    uint32_t id;
+    uint16_t name_len;
+    uint16_t key_len;
+    uint16_t value_len;
+    uint16_t reserved;
+};
+
+// BLOCK 记录体：BlockRecord 之后是 Gorilla 比特流
+struct BlockRecord {
+    uint32_t metric_id;
+    uint32_t count;
+    int64_t first_ts;
+    int64_t last_ts;
+    uint32_t bit_count;
+    uint32_t reserved;
+};
+
+inline size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+} // namespace archive
+
+/**
+ * 段文件写入器：posix_fallocate 预先分配固定大小的磁盘块后 mmap，追加记录就是
+ * memcpy；空间不足在 open() 时失败，而不是写映射时 SIGBUS。
+ * close() 封存段：msync 写回脏页，解除映射，ftruncate 到有效长度，再 fdatasync
+ */
+class SegmentWriter {
+public:
+    SegmentWriter() = default;
+    ~SegmentWriter() { close(); }
+
+    SegmentWriter(const SegmentWriter&) = delete;
+    SegmentWriter& operator=(const SegmentWriter&) = delete;
+
+    bool open(const std::string& path, size_t capacity, int64_t created_ms);
+
+    // 追加一条记录，记录体由两段拼接；空间不足返回 false
+    bool append(uint32_t type, const void* head, size_t head_len, const void* body,
+                size_t body_len);
+
+    // 写回脏页、截断到有效长度并落盘，然后解除映射
+    void close();
+
+    bool is_open() const { return base_ != nullptr; }
+    size_t used() const;
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    int fd_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+/**
+ * 指标归档 (Metric Archive)
+ *
+ * 目的：在没有 TSDB 的主机上保留数小时到数天的历史样本，用于事后分析
+ *
+ * 实现要点：
+ * 1. 作为 MetricSink 挂在 MetricStore 之后，采集器代码不变
+ * 2. 每个指标一个固定大小的块缓冲区，样本先用 Gorilla 编码写入缓冲区，
+ *    块写满或跨度超过 MAX_BLOCK_SPAN_MS 时作为一条 BLOCK 记录追加到段文件
+ * 3. 段文件写满后封存（msync + 截断 + fdatasync），在同一目录下按时间戳新建下一个段
+ * 4. 新段的空间用 posix_fallocate 预先分配，磁盘满时在这里失败而不是写映射时 SIGBUS；
+ *    写入失败时记录错误并停止归档，不影响采集
+ *
+ * 进程退出前的未封存样本在析构（或 flush()）时写出。
+ */
+class MetricArchive : public MetricSink {
+public:
+    static constexpr size_t DEFAULT_SEGMENT_BYTES = 64 << 20;
+    static constexpr size_t BLOCK_BYTES = 1024;
+    // 限制块的时间跨度：崩溃时最多丢失这么长时间的样本
+    static constexpr int64_t MAX_BLOCK_SPAN_MS = 10 * 60 * 1000;
+
+    explicit MetricArchive(std::string dir, size_t segment_bytes = DEFAULT_SEGMENT_BYTES);
+    ~MetricArchive() override;
+
+    MetricArchive(const MetricArchive&) = delete;
+    MetricArchive& operator=(const MetricArchive&) = delete;
+
+    void append(size_t id, const MetricInfo& info, int64_t timestamp_ms, double value) override;
+
+    // 封存所有未写出的块
+    void flush();
+
+    bool failed() const { return failed_; }
+    const std::string& segment_path() const { return segment_.path(); }
+    size_t segments_created() const { return segments_created_; }
+
+private:
+    struct Stream {
+        std::unique_ptr<uint8_t[]> buf;
+        std::unique_ptr<GorillaEncoder> encoder;
+        MetricInfo info;
+        bool defined = false;  // 当前段中是否已写过 METRIC 记录
+    };
+
+    bool seal(size_t id);
+    bool write_block(size_t id);
+    bool define(size_t id);
+    bool roll(int64_t timestamp_ms);
+
+    std::string dir_;
+    size_t segment_bytes_;
+    SegmentWriter segment_;
+    std::vector<Stream> streams_;
+    size_t segments_created_ = 0;
+    bool failed_ = false;
+};
+
+/**
+ * 段文件读取器：mmap 整个文件，直接在映射上遍历记录和解码，不复制数据
+ */
+class SegmentReader {
+public:
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    SegmentReader() = default;
+    ~SegmentReader();
+
+    SegmentReader(const SegmentReader&) = delete;
+    SegmentReader& operator=(const SegmentReader&) = delete;
+
+    bool open(const std::string& path);
+
+    // 遍历段内定义的指标：fn(id, name, label_key, label_value)
+    template <typename F>
+    void for_each_metric(F&& fn) const {
+        for_each_record([&](uint32_t type, const uint8_t* body, size_t size) {
+            if (type != archive::RECORD_METRIC || size < sizeof(archive::MetricRecord))
+                return;
+            archive::MetricRecord m;
+            std::memcpy(&m, body, sizeof(m));
+            if (sizeof(m) + m.name_len + m.key_len + m.value_len > size)
+                return;
+            const char* text = reinterpret_cast<const char*>(body + sizeof(m));
+            fn(static_cast<size_t>(m.id), std::string_view(text, m.name_len),
+               std::string_view(text + m.name_len, m.key_len),
+               std::string_view(text + m.name_len + m.key_len, m.value_len));
+        });
+    }
+
+    // 按名字和标签值查找段内的指标 id
+    size_t find(std::string_view name, std::string_view label_value = {}) const;
+
+    // 按时间顺序回调 [from_ms, to_ms] 内的样本：fn(timestamp_ms, value)，返回样本数
+    template <typename F>
+    size_t scan(size_t id, int64_t from_ms, int64_t to_ms, F&& fn) const {
+        size_t n = 0;
+        for_each_record([&](uint32_t type, const uint8_t* body, size_t size) {
+            if (type != archive::RECORD_BLOCK || size < sizeof(archive::BlockRecord))
+                return;
+            archive::BlockRecord b;
+            std::memcpy(&b, body, sizeof(b));
+            if (b.metric_id != id || b.last_ts < from_ms || b.first_ts > to_ms ||
+                (b.bit_count + 7) / 8 > size - sizeof(b))
+                return;
+            GorillaDecoder decoder(body + sizeof(b), b.bit_count, b.count);
+            int64_t ts;
+            double value;
+            while (decoder.next(ts, value)) {
+                if (ts > to_ms)
+                    break;
+                if (ts >= from_ms) {
+                    fn(ts, value);
+                    ++n;
+                }
+            }
+        });
+        return n;
+    }
+
+    // 有效内容的字节数
+    size_t used() const;
+
+private:
+    template <typename F>
+    void for_each_record(F&& fn) const {
+        size_t end = used();
+        size_t off = sizeof(archive::SegmentHeader);
+        while (off + sizeof(archive::RecordHeader) <= end) {
+            archive::RecordHeader h;
+            std::memcpy(&h, base_ + off, sizeof(h));
+            size_t body = off + sizeof(h);
+            if (body + h.size > end)
+                break;
+            fn(h.type, base_ + body, static_cast<size_t>(h.size));
+            off = archive::align8(body + h.size);
+        }
+    }
+
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // METRIC_ARCHIVE_H
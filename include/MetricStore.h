@@ -0,0 +1,249 @@
+#ifndef METRIC_STORE_H
+#define METRIC_STORE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 缓存行大小：时间戳和数值数组按缓存行对齐
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * 单个指标的环形缓冲区（结构数组布局）
+ *
+ * 样本按块存放，每块 CHUNK_SAMPLES 个（容量更小时就是一块），块内时间戳和
+ * 数值分别是两个按缓存行对齐的数组。块在第一次写到它时才分配：长时间保留、
+ * 短采样周期的指标不会在创建时一次占满内存，写满一圈之后不再分配。
+ * 写满后覆盖最旧的样本。
+ *
+ * 范围查询假设时间戳单调不减（同一采集器按时间顺序写入）。
+ */
+class MetricRing {
+public:
+    // 256 个样本一块：时间戳和数值各 2 KB，一块正好 4 KB
+    static constexpr size_t CHUNK_SHIFT = 8;
+    static constexpr size_t CHUNK_SAMPLES = size_t(1) << CHUNK_SHIFT;
+
+    // capacity 向上取整到块大小的整数倍；allocated_bytes 非空时累加分配的字节数
+    explicit MetricRing(size_t capacity, size_t* allocated_bytes = nullptr);
+
+    MetricRing(const MetricRing&) = delete;
+    MetricRing& operator=(const MetricRing&) = delete;
+
+    void push(int64_t timestamp_ms, double value) {
+        size_t offset = pos_ & chunk_mask_;
+        if (offset == 0) {
+            // 进入下一块：第一次写到时分配
+            current_ = &chunks_[pos_ >> chunk_shift_];
+            if (!current_->timestamps) {
+                allocate(*current_);
+            }
+        }
+        current_->timestamps[offset] = timestamp_ms;
+        current_->values[offset] = value;
+        ++head_;
+        if (++pos_ == capacity_) {
+            pos_ = 0;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return head_ < capacity_ ? head_ : capacity_; }
+    bool empty() const { return head_ == 0; }
+    // 已经分配的块占用的字节数
+    size_t memory_bytes() const;
+
+    // 第 i 个样本（0 = 当前保留的最旧样本）
+    int64_t timestamp_at(size_t i) const { return timestamp_of(slot(i)); }
+    double value_at(size_t i) const { return value_of(slot(i)); }
+
+    int64_t latest_timestamp() const { return timestamp_of(latest_slot()); }
+    double latest_value() const { return value_of(latest_slot()); }
+
+    // 复制 [from_ms, to_ms] 内的样本，最多 max 个（从最旧的开始），返回个数
+    size_t read_range(int64_t from_ms, int64_t to_ms, int64_t* timestamps,
+                      double* values, size_t max) const;
+
+    // 第一个时间戳 >= timestamp_ms 的样本下标，没有则返回 size()
+    size_t lower_bound(int64_t timestamp_ms) const;
+
+private:
+    struct AlignedDelete {
+        void operator()(void* p) const;
+    };
+    struct Chunk {
+        std::unique_ptr<void, AlignedDelete> memory;
+        int64_t* timestamps = nullptr;
+        double* values = nullptr;
+    };
+
+    void allocate(Chunk& chunk);
+    // 块内一个数组的字节数（按缓存行取整）
+    size_t array_bytes() const;
+
+    // 第 i 个样本所在的位置（0..capacity_-1）
+    size_t slot(size_t i) const {
+        size_t s = (head_ < capacity_ ? 0 : pos_) + i;
+        return s >= capacity_ ? s - capacity_ : s;
+    }
+    size_t latest_slot() const { return (pos_ == 0 ? capacity_ : pos_) - 1; }
+    int64_t timestamp_of(size_t s) const {
+        return chunks_[s >> chunk_shift_].timestamps[s & chunk_mask_];
+    }
+    double value_of(size_t s) const {
+        return chunks_[s >> chunk_shift_].values[s & chunk_mask_];
+    }
+
+    size_t chunk_shift_;
+    size_t chunk_mask_;
+    size_t capacity_;
+    size_t pos_ = 0;     // 下一个写入位置
+    uint64_t head_ = 0;  // 已写入的样本总数
+    std::vector<Chunk> chunks_;
+    Chunk* current_ = nullptr;  // pos_ 所在的块
+    size_t* allocated_bytes_;
+};
+
+// 指标的可选标签，例如 {"device", "nvme0n1"}；key 必须是字符串字面量
+struct MetricLabel {
+    const char* key = nullptr;
+    std::string_view value;
+};
+
+// 指标类型：COUNTER 是只增不减的累计值（计数器回退表示重置），其余都是 GAUGE
+enum class MetricType : uint8_t { GAUGE, COUNTER };
+
+// 指标描述
+struct MetricInfo {
+    std::string name;         // 例如 "disk_reads_completed"
+    std::string label_key;    // 没有标签时为空
+    std::string label_value;
+    MetricType type = MetricType::GAUGE;
+};
+
+/**
+ * 样本的下游存储（例如磁盘归档）
+ *
+ * MetricStore 写入环形缓冲区之后对每个样本调用一次 append()，
+ * 采集器不需要知道下游的存在。
+ */
+class MetricSink {
+public:
+    virtual ~MetricSink() = default;
+    virtual void append(size_t id, const MetricInfo& info, int64_t timestamp_ms, double value) = 0;
+};
+
+/**
+ * 指标存储 (Metric Store)
+ *
+ * 目的：headless 模式下保留最近一段时间的数值样本，替代文本输出
+ *
+ * 实现要点：
+ * 1. 每个指标（名字 + 标签）一个 MetricRing，首次出现时按保留时长和
+ *    采样周期计算容量；内存按块随写入分配，保留时长写满一圈之后不再分配，
+ *    memory_bytes() 是实际分配的字节数
+ * 2. 指标用整数 id 引用，采集器通过 MetricWriter 缓存 id，
+ *    稳定状态下发布样本不做哈希查找
+ * 3. 查询接口：按名字查找指标，按时间范围复制样本
+ * 4. 可选的 MetricSink 接收每个样本，用于持久化（见 MetricArchive）
+ *
+ * 不是线程安全的：发布和查询都在主线程进行。
+ */
+class MetricStore {
+public:
+    using MetricId = size_t;
+    static constexpr MetricId NOT_FOUND = static_cast<MetricId>(-1);
+
+    explicit MetricStore(std::chrono::milliseconds retention);
+
+    MetricStore(const MetricStore&) = delete;
+    MetricStore& operator=(const MetricStore&) = delete;
+
+    // 保存 retention 时长的样本所需的容量
+    size_t capacity_for(std::chrono::milliseconds interval) const;
+
+    // 查找或创建指标；type 只在创建时记录
+    MetricId intern(std::string_view name, MetricLabel label, size_t capacity,
+                    MetricType type = MetricType::GAUGE);
+
+    MetricId find(std::string_view name, std::string_view label_value = {}) const;
+
+    void push(MetricId id, int64_t timestamp_ms, double value) {
+        rings_[id]->push(timestamp_ms, value);
+        if (sink_)
+            sink_->append(id, infos_[id], timestamp_ms, value);
+    }
+
+    // 设置下游存储，nullptr 表示不转发；sink 的生命周期由调用方管理
+    void set_sink(MetricSink* sink) { sink_ = sink; }
+
+    size_t metric_count() const { return infos_.size(); }
+    const MetricInfo& info(MetricId id) const { return infos_[id]; }
+    const MetricRing& ring(MetricId id) const { return *rings_[id]; }
+
+    // 所有环形缓冲区已经分配的字节数
+    size_t memory_bytes() const { return memory_bytes_; }
+
+    std::chrono::milliseconds retention() const { return retention_; }
+
+private:
+    static std::string make_key(std::string_view name, std::string_view label_value);
+
+    std::chrono::milliseconds retention_;
+    std::vector<MetricInfo> infos_;
+    std::vector<std::unique_ptr<MetricRing>> rings_;
+    std::unordered_map<std::string, MetricId> index_; // "name\0label_value" -> id
+    size_t memory_bytes_ = 0;
+    MetricSink* sink_ = nullptr;
+};
+
+/**
+ * 采集器发布样本的写入器
+ *
+ * 采集器每次按相同顺序调用 gauge()/counter()，写入器按调用序号缓存上次解析出的
+ * 指标 id：名字指针、标签 key 指针和标签值都相同时直接写入，
+ * 否则（第一次发布、设备增减）回到 MetricStore 查找或创建。
+ */
+class MetricWriter {
+public:
+    struct Binding {
+        const char* name = nullptr;
+        const char* label_key = nullptr;
+        std::string label_value;
+        MetricStore::MetricId id = MetricStore::NOT_FOUND;
+    };
+
+    MetricWriter(MetricStore& store, std::vector<Binding>& bindings,
+                 size_t capacity, int64_t timestamp_ms)
+        : store_(store), bindings_(bindings), capacity_(capacity),
+          timestamp_ms_(timestamp_ms) {}
+
+    // name 必须是字符串字面量（按指针比较）
+    void gauge(const char* name, double value) { gauge(name, MetricLabel{}, value); }
+    void gauge(const char* name, MetricLabel label, double value) {
+        write(name, label, value, MetricType::GAUGE);
+    }
+    // 累计值（字节数、I/O 次数等），/metrics 中标为 counter
+    void counter(const char* name, MetricLabel label, double value) {
+        write(name, label, value, MetricType::COUNTER);
+    }
+
+    // 发布结束：丢弃本次没有用到的缓存项
+    void finish() { bindings_.resize(next_); }
+
+private:
+    void write(const char* name, MetricLabel label, double value, MetricType type);
+
+    MetricStore& store_;
+    std::vector<Binding>& bindings_;
+    size_t capacity_;
+    int64_t timestamp_ms_;
+    size_t next_ = 0;
+};
+
+#endif // METRIC_STORE_H
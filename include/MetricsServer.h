@@ -0,0 +1,95 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "MetricStore.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class EventLoop;
+
+/**
+ * Prometheus /metrics 端点
+ *
+ * 目的：让 Prometheus（包括 HA 成对部署的多个抓取方）直接抓取本机指标，
+ * 不需要额外的线程
+ *
+ * 实现要点：
+ * 1. 监听 socket 和所有连接都注册在 main() 的 EventLoop 上，全部非阻塞
+ * 2. 每个 tick 调用 update()，把 MetricStore 的最新值序列化成文本格式，
+ *    存入缓存的响应体；下一个 tick 之前的所有抓取共用这一份
+ * 3. 响应头写在连接自带的小缓冲区里，和缓存的响应体一起 writev() 发出，
+ *    响应体不复制；没写完的连接持有响应体的引用，update() 不会覆盖它
+ * 4. 每个连接只处理一个请求，响应后关闭（Connection: close）；对方发完请求后
+ *    半关闭（shutdown(SHUT_WR)）时照常响应
+ * 5. 每个连接从 accept 起有 REQUEST_TIMEOUT 的期限，每秒检查一次，超时关闭；
+ *    连接数满时关闭最早的、还没收完请求的连接，慢速连接占不满 MAX_CONNECTIONS
+ *
+ * 只支持 GET /metrics，其他路径返回 404。
+ */
+class MetricsServer {
+public:
+    static constexpr size_t MAX_CONNECTIONS = 64;
+    static constexpr size_t MAX_REQUEST_BYTES = 4096;
+    // 从 accept 到响应发完的期限（抓取方的超时通常是 10 秒）
+    static constexpr std::chrono::seconds REQUEST_TIMEOUT{5};
+
+    explicit MetricsServer(EventLoop& loop);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // 监听 "[HOST:]PORT"（IPv4，HOST 默认 0.0.0.0），失败返回 false
+    bool listen(const std::string& address);
+
+    // 用 store 中各指标的最新值重新生成响应体
+    void update(const MetricStore& store);
+
+    // 实际监听的端口（listen 端口为 0 时由内核分配）
+    uint16_t port() const { return port_; }
+    uint64_t requests_served() const { return requests_served_; }
+    size_t body_size() const { return body_ ? body_->size() : 0; }
+
+private:
+    struct Connection {
+        int fd = -1;
+        char request[MAX_REQUEST_BYTES];
+        size_t request_len = 0;
+        bool responding = false;
+        char header[256];
+        size_t header_len = 0;
+        std::shared_ptr<const std::string> body;  // 404 时为空
+        size_t sent = 0;  // 已发送的字节数（响应头 + 响应体）
+        std::chrono::steady_clock::time_point deadline{};
+    };
+
+    void on_accept();
+    void on_event(int fd, uint32_t events);
+    bool read_request(Connection& conn);
+    void start_response(Connection& conn);
+    bool write_response(Connection& conn);
+    void close_connection(int fd);
+    void close_expired();
+    // 关闭最早的、还在读请求的连接，没有这样的连接时返回 false
+    bool evict_oldest_reader();
+
+    void rebuild_order(const MetricStore& store);
+
+    EventLoop& loop_;
+    int listen_fd_ = -1;
+    int sweep_fd_ = -1;
+    uint16_t port_ = 0;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+
+    std::shared_ptr<std::string> body_;    // 当前缓存的响应体
+    std::shared_ptr<std::string> spare_;   // 上一份响应体，没有连接引用时复用
+    std::vector<MetricStore::MetricId> order_;  // 按名字分组后的输出顺序
+    uint64_t requests_served_ = 0;
+};
+
+#endif // METRICS_SERVER_H
@@ -0,0 +1,91 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "MetricStore.h"   // CACHE_LINE_SIZE
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * 有界无锁多生产者单消费者队列 (MPSC Queue)
+ *
+ * 目的：任意线程（tick 线程、线程池、扫描线程）把定长记录交给一个后台线程，
+ * 入队不加锁、不分配、不阻塞；队列满时直接返回 false，由调用方决定丢弃
+ *
+ * 实现要点：
+ * 1. 容量向上取整到 2 的幂，每个单元格带一个序号（Vyukov 有界队列）：
+ *    序号等于写位置时单元格可写，等于写位置 + 1 时可读
+ * 2. 生产者用 CAS 抢占写位置，在单元格里原地填充记录，再用 release 写序号发布
+ * 3. 唯一的消费者按顺序读取，读完把序号推进一圈，单元格交还给生产者
+ * 4. 写位置和读位置分别独占缓存行，避免生产者和消费者互相失效
+ *
+ * T 必须可默认构造；单元格在构造时一次性分配，之后原地复用。
+ */
+template <typename T>
+class MpscQueue {
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+public:
+    explicit MpscQueue(size_t capacity) {
+        capacity_ = 1;
+        while (capacity_ < capacity)
+            capacity_ <<= 1;
+        mask_ = capacity_ - 1;
+        cells_ = std::make_unique<Cell[]>(capacity_);
+        for (size_t i = 0; i < capacity_; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // 生产者：用 fill(T&) 原地填充一个单元格；队列满时返回 false
+    template <typename F>
+    bool push(F&& fill) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;  // 消费者还没读完上一圈
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        fill(cell->value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：把队首记录交给 consume(const T&)；队列为空时返回 false
+    template <typename F>
+    bool pop(F&& consume) {
+        Cell& cell = cells_[head_ & mask_];
+        if (cell.seq.load(std::memory_order_acquire) != head_ + 1)
+            return false;
+        consume(static_cast<const T&>(cell.value));
+        cell.seq.store(head_ + capacity_, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    alignas(CACHE_LINE_SIZE) size_t head_ = 0;  // 只有消费者访问
+};
+
+#endif // MPSC_QUEUE_H
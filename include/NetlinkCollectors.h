@@ -0,0 +1,105 @@
+#ifndef NETLINK_COLLECTORS_H
+#define NETLINK_COLLECTORS_H
+
+#include "Collectors.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * netlink 后端 (Alternative Backends)
+ *
+ * 目的：接口和进程都很多的主机上，解析 /proc 文本本身就是采集的主要开销；
+ * 内核通过 netlink 直接提供二进制结构，不需要逐字符解析
+ *
+ * 两个采集器都继承默认实现，只替换数据来源，显示、快照和指标发布不变；
+ * 通过工厂注册为替代后端，用 --backend network=netlink,process=connector 选择。
+ */
+
+// ==================== rtnetlink 网络采集器 ====================
+/**
+ * 实现要点：
+ * 1. 持有一个 NETLINK_ROUTE socket，每次采集发送 RTM_GETSTATS 转储请求，
+ *    过滤掩码只要 IFLA_STATS_LINK_64：每个接口的回复只有一个
+ *    rtnl_link_stats64（64 位计数器），不带 RTM_GETLINK 的几十个其他属性
+ * 2. RTM_GETSTATS 只给 ifindex：名字表用 RTM_GETLINK 转储建立，
+ *    只在出现未知 ifindex 或接口数量变化时刷新
+ * 3. 回复收进复用的缓冲区，do_parse() 按 nlmsghdr/rtattr 遍历，
+ *    结果写入 NetworkCollector::interfaces_ 设备表，速率计算与 /proc/net/dev 后端共用
+ *
+ * 接口改名（ifindex 不变）要等名字表下一次刷新才会反映出来。
+ */
+class NetlinkNetworkCollector : public NetworkCollector {
+public:
+    explicit NetlinkNetworkCollector(const std::string& proc_root = default_proc_root());
+    ~NetlinkNetworkCollector() override;
+
+    void prefetch(ProcFileBatch& /*batch*/) override {}  // 不读取 /proc
+    // ifindex -> 名字的表在 do_collect() 里建立，不在 raw_data_ 里
+    bool replayable() const override { return false; }
+
+protected:
+    void do_collect() override;
+    void do_parse() override;
+
+private:
+    bool open_socket();
+    // 发送一个转储请求，把全部回复收进 buf[0, used)
+    bool dump(uint16_t type, const void* body, size_t body_len,
+              std::vector<char>& buf, size_t& used);
+    void refresh_names();
+
+    int fd_ = -1;
+    uint32_t seq_ = 0;
+    uint32_t stats_seq_ = 0;   // raw_data_ 对应的 RTM_GETSTATS 请求序号
+    std::vector<char> buffer_;       // RTM_GETSTATS 回复
+    std::vector<char> link_buffer_;  // RTM_GETLINK 回复
+    std::unordered_map<int, std::string> names_;  // ifindex -> 名字
+};
+
+// ==================== proc connector 进程采集器 ====================
+/**
+ * 实现要点：
+ * 1. 订阅 netlink proc connector（NETLINK_CONNECTOR / CN_IDX_PROC），
+ *    内核在 fork/exit 时推送事件
+ * 2. 第一次采集完整扫描一次 /proc，之后每个 tick 只处理积压的事件，
+ *    增量维护存活的 PID 集合，不再 getdents64 遍历 /proc
+ * 3. 只跟踪线程组首线程（pid == tgid），线程的创建和退出不影响进程表
+ * 4. exit 事件发生时进程还是僵尸，/proc 里仍然有它：先记下，
+ *    等 /proc/<pid> 消失（被回收）才移出集合，结果与完整扫描一致
+ * 5. socket 缓冲区溢出（ENOBUFS，丢了事件）时重新完整扫描一次
+ *
+ * 订阅需要 CAP_NET_ADMIN；订阅失败或 proc 根目录不是 /proc 时
+ * 退回每个 tick 完整扫描。各进程的 stat 仍然逐个读取（CPU 和 RSS 没有事件）。
+ */
+class ConnectorProcessCollector : public ProcessCollector {
+public:
+    explicit ConnectorProcessCollector(const std::string& proc_root = default_proc_root());
+    ~ConnectorProcessCollector() override;
+
+    // 累计处理的事件数和完整扫描次数
+    uint64_t events() const { return events_; }
+    uint64_t rescans() const { return rescans_; }
+
+protected:
+    bool list_pids(std::vector<int>& pids) override;
+
+private:
+    bool subscribe();
+    bool rescan();
+    bool drain_events();  // 返回 false 表示丢了事件，需要重新扫描
+    void reap_exited();   // 移除已经被回收的进程
+
+    bool use_events_;     // false 时每个 tick 完整扫描
+    int fd_ = -1;
+    bool synced_ = false;
+    std::unordered_set<int> live_;
+    std::unordered_set<int> exited_;  // 收到 exit 事件、可能还是僵尸的进程
+    std::vector<char> buffer_;
+    uint64_t events_ = 0;
+    uint64_t rescans_ = 0;
+};
+
+#endif // NETLINK_COLLECTORS_H
@@ -0,0 +1,137 @@
+#ifndef NUMA_COLLECTOR_H
+#define NUMA_COLLECTOR_H
+
+#include "Collectors.h"
+#include "MemInfo.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// NUMA 节点目录：node<N>/meminfo 和 node<N>/numastat
+constexpr const char* NODE_ROOT = "/sys/devices/system/node";
+constexpr const char* VMSTAT_FILE = "vmstat";
+
+/**
+ * 内存详情采集器 (NUMA / Hugepages / vmstat)
+ *
+ * 目的：内存问题常常出在某一个 NUMA 节点用完或缺页/回收速率上，
+ * 需要每个节点的完整 meminfo、numastat 和 /proc/vmstat 的事件速率
+ *
+ * 实现要点：
+ * 1. 节点的 meminfo 与 MemoryCollector 的 /proc/meminfo 共用字段表（MemInfo.h），
+ *    /proc/meminfo 本身只由 MemoryCollector 读取（全局的大页、slab 等字段在那里）；
+ *    /proc/vmstat 和 numastat 各一张表；字段名通过编译期完美哈希（PerfectHash.h）
+ *    查找，每个文件逐行扫描一遍，每行一次哈希和一次比较
+ * 2. 节点目录只在构造时枚举一次（内存热插拔新增的节点需要重启监控器）；
+ *    没有 NUMA 支持的内核上只显示全局数据
+ * 3. vmstat 和 numastat 是累计计数，速率按两次 sample_time() 之间的增量计算，
+ *    计数回退（内核重置）时该次速率记为 0
+ * 4. 所有文件都是 ProcFile，可参与 io_uring 批量读取；稳定后不分配
+ */
+class NumaCollector : public Collector {
+public:
+    explicit NumaCollector(const std::string& proc_root = default_proc_root(),
+                           const std::string& node_root = NODE_ROOT);
+
+    // /proc/vmstat 中显示和发布速率的事件计数
+    enum VmstatField {
+        PGPGIN,
+        PGPGOUT,
+        PSWPIN,
+        PSWPOUT,
+        PGFAULT,
+        PGMAJFAULT,
+        PGFREE,
+        PGSCAN_KSWAPD,
+        PGSCAN_DIRECT,
+        PGSTEAL_KSWAPD,
+        PGSTEAL_DIRECT,
+        OOM_KILL,
+        NUMA_HIT,
+        NUMA_MISS,
+        NUMA_FOREIGN,
+        NUMA_INTERLEAVE,
+        NUMA_LOCAL,
+        NUMA_OTHER,
+        NUMA_PAGES_MIGRATED,
+        PGMIGRATE_SUCCESS,
+        THP_FAULT_ALLOC,
+        THP_FAULT_FALLBACK,
+        THP_COLLAPSE_ALLOC,
+        COMPACT_STALL,
+        WORKINGSET_REFAULT_ANON,
+        WORKINGSET_REFAULT_FILE,
+        VMSTAT_FIELD_COUNT
+    };
+
+    // node<N>/numastat
+    enum NumaStatField {
+        NODE_NUMA_HIT,
+        NODE_NUMA_MISS,
+        NODE_NUMA_FOREIGN,
+        NODE_INTERLEAVE_HIT,
+        NODE_LOCAL_NODE,
+        NODE_OTHER_NODE,
+        NUMASTAT_FIELD_COUNT
+    };
+
+    static std::string_view vmstat_key(VmstatField field);
+    static std::string_view numastat_key(NumaStatField field);
+
+    struct Node {
+        std::string name;                              // 节点编号，如 "0"
+        uint64_t meminfo[meminfo::FIELD_COUNT] = {};   // KB，HugePages_* 为页数
+        uint64_t numastat[NUMASTAT_FIELD_COUNT] = {};  // 累计页数
+        double numastat_rate[NUMASTAT_FIELD_COUNT] = {};  // 页/秒
+    };
+
+    struct Snapshot {
+        bool has_rates = false;    // 第一次采样之后才有速率
+        uint64_t vmstat[VMSTAT_FIELD_COUNT] = {};
+        double vmstat_rate[VMSTAT_FIELD_COUNT] = {};  // 每秒
+        std::vector<Node> nodes;
+    };
+
+    static constexpr const char* NAME = "numa";
+    std::string get_name() const override { return NAME; }
+    void print_result(std::ostream& out) const override;
+    void prefetch(ProcFileBatch& batch) override;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
+
+    // 单遍解析 "key value" 格式的 vmstat / numastat
+    static void parse_vmstat(std::string_view raw, uint64_t* values);
+    static void parse_numastat(std::string_view raw, uint64_t* values);
+
+protected:
+    void do_collect() override;
+    void do_parse() override;
+    void do_calculate() override;
+    void do_publish(MetricWriter& out) const override;
+    void do_snapshot() override;
+
+private:
+    struct NodeFiles {
+        explicit NodeFiles(const std::string& dir)
+            : meminfo(dir + "/meminfo"), numastat(dir + "/numastat", 512) {}
+
+        ProcFile meminfo;
+        ProcFile numastat;
+        std::string_view meminfo_raw;
+        std::string_view numastat_raw;
+        uint64_t prev_numastat[NUMASTAT_FIELD_COUNT] = {};
+    };
+
+    ProcFile vmstat_file_;       // 内容在 raw_data_
+    std::vector<NodeFiles> node_files_;
+    std::vector<Node> nodes_;
+    bool has_rates_ = false;
+    bool warned_ = false;
+    uint64_t vmstat_[VMSTAT_FIELD_COUNT] = {};
+    uint64_t prev_vmstat_[VMSTAT_FIELD_COUNT] = {};
+    double vmstat_rate_[VMSTAT_FIELD_COUNT] = {};
+    std::chrono::steady_clock::time_point prev_time_{};
+    SnapshotBuffer<Snapshot> snapshot_;
+};
+
+#endif // NUMA_COLLECTOR_H
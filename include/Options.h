@@ -0,0 +1,62 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// --interval 的一项：collector 为空表示所有采集器
+struct IntervalOverride {
+    std::string collector;
+    size_t interval_ms = 0;
+};
+
+// --backend 的一项：collector 使用名为 backend 的实现
+struct BackendOverride {
+    std::string collector;
+    std::string backend;
+};
+
+/**
+ * 命令行选项
+ *
+ * main() 解析一次，然后通过 Collector::configure() 分发给各个采集器，
+ * 采集器只读取自己关心的字段。
+ */
+struct MonitorOptions {
+    size_t top_n = 5;         // 进程采集器显示的 Top N
+    size_t thread_top = 0;    // 每个 Top N 进程显示 CPU 最高的线程数，0 表示不下钻
+    size_t scan_threads = 1;  // 进程扫描线程数，1 表示不并行
+    size_t jobs = 0;          // 并发执行采集器的线程数，0 表示自动
+    std::vector<IntervalOverride> intervals;  // 按顺序应用，后面的覆盖前面的
+    bool stats = false;       // 在画面下方显示自监控统计
+    std::string proc_root;    // 非空时替换默认的 /proc
+    std::string cgroup_root;  // 非空时替换自动找到的 cgroup v2 挂载点
+    bool headless = false;    // 不输出画面，只把样本写入 MetricStore
+    size_t retention_s = 3600;  // headless 模式保留的样本时长（秒）
+    std::string archive_dir;  // 非空时把样本压缩归档到该目录下的段文件
+    std::string listen;       // 非空时在 [HOST:]PORT 上提供 Prometheus /metrics
+    std::string push;         // 非空时把每个 tick 的指标推给 HOST:PORT 上的汇聚端
+    std::string host_name;    // 推送时的主机名，空表示 gethostname()
+    std::string aggregate;    // 非空时作为汇聚端在 [HOST:]PORT 上接收推送，不采集本机
+    std::string record;       // 非空时把可回放采集器每个 tick 的原始输入写入该文件（覆盖）
+    std::string replay;       // 非空时回放该记录文件并报告吞吐，不采集本机
+    std::string log_file;     // 日志追加写入的文件，空表示 stderr
+    bool io_uring = false;    // 用 io_uring 批量读取 /proc（不支持时退回 pread）
+    std::vector<BackendOverride> backends;  // 后面的覆盖前面的
+    std::vector<std::string> collectors;    // 只创建这些采集器（get_name()），空表示全部
+    double cpu_budget = 0.0;  // 自身 CPU 预算（单核百分比），大于 0 时启用自适应采样
+    double hot_cpu = 90.0;    // 主机 CPU 使用率不低于此值视为繁忙
+    double hot_load = 1.0;    // 1 分钟负载 / CPU 数 不低于此值视为繁忙
+    std::string psi_trigger = "some 150000 1000000";  // PSI 触发器，空表示不启用
+    size_t burst_interval_ms = 100;   // PSI 触发后的采样周期
+    size_t burst_duration_ms = 2000;  // 每次触发后高频采样持续的时间
+};
+
+// 命令行解析结果：HELP 表示已经打印用法、应以 0 退出，INVALID 表示参数有误
+enum class ParseResult { RUN, HELP, INVALID };
+
+// 解析命令行，出错或 --help 时打印用法
+ParseResult parse_options(int argc, char* argv[], MonitorOptions& options);
+
+#endif // OPTIONS_H
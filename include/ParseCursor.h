@@ -0,0 +1,105 @@
+#ifndef PARSE_CURSOR_H
+#define PARSE_CURSOR_H
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * 零分配文本解析游标
+ *
+ * 目的：替代 stringstream/getline，解析 /proc 文本时不创建流对象和临时字符串
+ *
+ * 用法：
+ *   ParseCursor cur(raw_data_);
+ *   std::string_view line;
+ *   while (cur.next_line(line)) {
+ *       ParseCursor lc(line);
+ *       std::string_view key;
+ *       uint64_t value;
+ *       if (lc.next_token(key) && lc.parse_u64(value)) { ... }
+ *   }
+ *
+ * 所有返回的 string_view 都指向原始数据，不做任何拷贝。
+ * 数值解析基于 std::from_chars，失败时返回 false 且不移动游标。
+ */
+class ParseCursor {
+public:
+    ParseCursor() = default;
+    explicit ParseCursor(std::string_view data) : data_(data) {}
+
+    bool eof() const { return pos_ >= data_.size(); }
+    std::string_view rest() const { return data_.substr(pos_); }
+
+    // 跳过空格和制表符（不跨行）
+    void skip_ws() {
+        while (pos_ < data_.size() && (data_[pos_] == ' ' || data_[pos_] == '\t')) {
+            ++pos_;
+        }
+    }
+
+    // 如果下一个字符是 c 则跳过它
+    bool consume(char c) {
+        if (pos_ < data_.size() && data_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    // 下一个以空白分隔的 token
+    bool next_token(std::string_view& token) {
+        skip_ws();
+        size_t start = pos_;
+        while (pos_ < data_.size() && !is_space(data_[pos_])) {
+            ++pos_;
+        }
+        token = data_.substr(start, pos_ - start);
+        return !token.empty();
+    }
+
+    // 跳过 n 个 token
+    bool skip_tokens(int n) {
+        std::string_view token;
+        for (int i = 0; i < n; ++i) {
+            if (!next_token(token)) return false;
+        }
+        return true;
+    }
+
+    // 下一行（不含 '\n'），游标移到下一行开头
+    bool next_line(std::string_view& line) {
+        if (eof()) return false;
+        size_t end = data_.find('\n', pos_);
+        if (end == std::string_view::npos) end = data_.size();
+        line = data_.substr(pos_, end - pos_);
+        pos_ = end < data_.size() ? end + 1 : end;
+        return true;
+    }
+
+    bool parse_u64(uint64_t& value) { return parse_number(value); }
+    bool parse_i64(int64_t& value) { return parse_number(value); }
+    bool parse_int(int& value) { return parse_number(value); }
+    bool parse_double(double& value) { return parse_number(value); }
+
+private:
+    static bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    template <typename T>
+    bool parse_number(T& value) {
+        skip_ws();
+        const char* first = data_.data() + pos_;
+        const char* last = data_.data() + data_.size();
+        auto [ptr, ec] = std::from_chars(first, last, value);
+        if (ec != std::errc()) return false;
+        pos_ += static_cast<size_t>(ptr - first);
+        return true;
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+#endif // PARSE_CURSOR_H
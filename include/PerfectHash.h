@@ -0,0 +1,92 @@
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * 编译期完美哈希 (Compile-Time Perfect Hash)
+ *
+ * 目的：/proc/meminfo、/proc/vmstat 这类 "键 值" 文件每行都要按键名找到字段；
+ * if/else 链每行平均要比较几十次字符串，字段越多越慢
+ *
+ * 实现要点：
+ * 1. 键表是 constexpr 数组，字段编号就是数组下标；constexpr 构造函数在编译期
+ *    逐个尝试种子，直到所有键落在不同的槽里（找不到时编译失败）
+ * 2. 槽数取键数 8 倍以上的 2 的幂，几十个种子内就能找到；每个槽 1 字节，
+ *    60 个键的表 512 字节
+ * 3. find() 是一次 FNV-1a 哈希、一次查表和一次与候选键的比较，
+ *    不在表里的键（新内核增加的字段）通常在长度比较时就被排除
+ *
+ * 用法：
+ *   constexpr std::string_view KEYS[] = {"MemTotal", "MemFree"};
+ *   constexpr PerfectHash<std::size(KEYS)> INDEX(KEYS);
+ *   int field = INDEX.find(key);   // -1 表示不认识
+ */
+template <size_t N> class PerfectHash {
+    static_assert(N > 0 && N < 255, "键的下标存放在 uint8_t 里");
+
+    static constexpr size_t slot_count() {
+        size_t slots = 1;
+        while (slots < N * 8) {
+            slots <<= 1;
+        }
+        return slots;
+    }
+
+public:
+    static constexpr size_t SLOTS = slot_count();
+    static constexpr uint8_t EMPTY = 0xFF;
+    static constexpr uint32_t MAX_SEED = 4096;
+
+    constexpr explicit PerfectHash(const std::string_view (&keys)[N]) : keys_(keys) {
+        for (uint32_t seed = 1; seed < MAX_SEED; ++seed) {
+            if (try_seed(seed)) {
+                seed_ = seed;
+                return;
+            }
+        }
+        // 只在常量求值中使用：走到这里时编译报错
+        throw "PerfectHash: no collision-free seed";
+    }
+
+    // key 在键表中的下标，不在表中时返回 -1
+    constexpr int find(std::string_view key) const {
+        uint8_t index = slots_[hash(key, seed_) & (SLOTS - 1)];
+        return index != EMPTY && keys_[index] == key ? index : -1;
+    }
+
+    static constexpr size_t size() { return N; }
+    constexpr std::string_view key(size_t index) const { return keys_[index]; }
+
+private:
+    static constexpr uint32_t hash(std::string_view key, uint32_t seed) {
+        uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (char c : key) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+
+    constexpr bool try_seed(uint32_t seed) {
+        for (size_t i = 0; i < SLOTS; ++i) {
+            slots_[i] = EMPTY;
+        }
+        for (size_t i = 0; i < N; ++i) {
+            uint8_t& slot = slots_[hash(keys_[i], seed) & (SLOTS - 1)];
+            if (slot != EMPTY) {
+                return false;
+            }
+            slot = static_cast<uint8_t>(i);
+        }
+        return true;
+    }
+
+    const std::string_view* keys_;
+    uint32_t seed_ = 0;
+    uint8_t slots_[SLOTS] = {};
+};
+
+#endif // PERFECT_HASH_H
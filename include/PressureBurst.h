@@ -0,0 +1,71 @@
+#ifndef PRESSURE_BURST_H
+#define PRESSURE_BURST_H
+
+#include "EventLoop.h"
+#include "PressureCollector.h"
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * 压力触发的突发采样 (Event-Driven Burst Sampling)
+ *
+ * 目的：按秒轮询会错过短暂的停顿，空闲时又白白唤醒；由内核的 PSI 触发器
+ * 决定何时需要细看，平时保持原来的采样周期
+ *
+ * 实现要点：
+ * 1. PressureCollector 的触发器 fd 以 EPOLLPRI 注册到 main() 的事件循环，
+ *    与采样定时器共用同一个 epfd
+ * 2. 触发时立即把目标采集器（CPU、内存、进程和 PSI 本身）加入本轮的 due，
+ *    并启动一个高频 timerfd（默认 100ms），持续 duration（默认 2 秒）；
+ *    期间再次触发只延长结束时间
+ * 3. 结束后停止 timerfd，没有停顿时事件循环只由原来的定时器唤醒
+ *
+ * due 里可能同时有常规定时器和突发定时器加入的同一个采集器，由调用方去重。
+ */
+class PressureBurst {
+public:
+    struct Config {
+        std::chrono::milliseconds interval{100};
+        std::chrono::milliseconds duration{2000};
+    };
+
+    // targets 在突发期间按 config.interval 采样，加入 due
+    PressureBurst(EventLoop& loop, PressureCollector& pressure,
+                  std::vector<Collector*> targets, std::vector<Collector*>& due,
+                  const Config& config);
+    ~PressureBurst();
+
+    PressureBurst(const PressureBurst&) = delete;
+    PressureBurst& operator=(const PressureBurst&) = delete;
+
+    // 注册触发器并把 fd 加入事件循环，一个都没有成功时返回 false
+    bool start(std::string_view trigger_spec);
+
+    bool active() const { return active_; }
+    uint64_t bursts() const { return bursts_; }
+
+    // 一行状态，显示在画面下方
+    void print(std::ostream& out) const;
+
+private:
+    void on_trigger(PressureCollector::Resource resource, uint32_t events);
+    void on_tick();
+    void schedule_targets();
+
+    EventLoop& loop_;
+    PressureCollector& pressure_;
+    std::vector<Collector*> targets_;
+    std::vector<Collector*>& due_;
+    Config config_;
+    int tfd_ = -1;
+    std::vector<int> registered_;
+    bool active_ = false;
+    std::chrono::steady_clock::time_point until_{};
+    uint64_t bursts_ = 0;
+    uint64_t burst_ticks_ = 0;
+};
+
+#endif // PRESSURE_BURST_H
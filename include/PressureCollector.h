@@ -0,0 +1,97 @@
+#ifndef PRESSURE_COLLECTOR_H
+#define PRESSURE_COLLECTOR_H
+
+#include "Collectors.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * 压力停顿采集器 (Pressure Stall Information)
+ *
+ * 目的：CPU 使用率和负载看不出任务是否在等资源；/proc/pressure/{cpu,memory,io}
+ * 直接给出任务因资源不足而停顿的时间比例
+ *
+ * 实现要点：
+ * 1. 每次 update() 读取三个文件（ProcFile，可参与 io_uring 批量读取），
+ *    解析 some/full 两行的 avg10/avg60/avg300 和累计停顿时间 total，
+ *    total 的增量除以采样间隔得到本次的停顿百分比
+ * 2. arm_triggers() 为每种资源另开一个 fd 写入触发器（"some 150000 1000000"：
+ *    1 秒窗口内停顿超过 150ms 时该 fd 上出现 EPOLLPRI），fd 由调用方
+ *    注册到事件循环（见 PressureBurst）
+ * 3. 没有 CAP_SYS_RESOURCE 时内核只接受 2 秒整数倍的窗口：窗口向上取整，
+ *    阈值按同样比例放大后重试
+ *
+ * 内核没有启用 PSI 时各资源标记为不可用，画面上只显示一行提示。
+ */
+class PressureCollector : public Collector {
+public:
+    explicit PressureCollector(const std::string& proc_root = default_proc_root());
+    ~PressureCollector() override;
+
+    enum Resource { CPU, MEMORY, IO, RESOURCE_COUNT };
+    static const char* resource_name(Resource resource);
+
+    // 一行 "some ..." 或 "full ..."，百分比
+    struct Stall {
+        bool present = false;
+        double avg10 = 0.0;
+        double avg60 = 0.0;
+        double avg300 = 0.0;
+        uint64_t total_us = 0;
+        double percent = 0.0;    // 上一次采样以来的停顿比例
+    };
+
+    struct Snapshot {
+        bool available[RESOURCE_COUNT] = {};
+        Stall some[RESOURCE_COUNT];
+        Stall full[RESOURCE_COUNT];
+        uint64_t triggers[RESOURCE_COUNT] = {};
+        std::string trigger_spec;    // 实际写入内核的触发器，空表示没有启用
+    };
+
+    static constexpr const char* NAME = "pressure";
+    std::string get_name() const override { return NAME; }
+    void print_result(std::ostream& out) const override;
+    void prefetch(ProcFileBatch& batch) override;
+    SnapshotBuffer<Snapshot>::Reader snapshot() const { return snapshot_.read(); }
+
+    // 触发器规格 "some|full <阈值 us> <窗口 us>"，格式正确时填入各字段
+    static bool parse_trigger(std::string_view spec, bool& full, uint64_t& threshold_us,
+                              uint64_t& window_us);
+
+    // 为每种资源打开触发器 fd，返回成功的数量
+    size_t arm_triggers(std::string_view spec);
+    int trigger_fd(Resource resource) const { return trigger_fds_[resource]; }
+    // 事件循环收到 EPOLLPRI 后调用；EPOLLERR 时调用 disarm()
+    void record_trigger(Resource resource) { ++triggers_[resource]; }
+    void disarm(Resource resource);
+
+protected:
+    void do_collect() override;
+    void do_parse() override;
+    void do_calculate() override;
+    void do_publish(MetricWriter& out) const override;
+    void do_snapshot() override;
+
+private:
+    bool write_trigger(Resource resource, const std::string& spec);
+
+    std::string proc_root_;
+    ProcFile files_[RESOURCE_COUNT];
+    std::string_view raw_[RESOURCE_COUNT];
+    bool available_[RESOURCE_COUNT] = {};
+    bool warned_ = false;
+    Stall some_[RESOURCE_COUNT];
+    Stall full_[RESOURCE_COUNT];
+    uint64_t prev_some_us_[RESOURCE_COUNT] = {};
+    uint64_t prev_full_us_[RESOURCE_COUNT] = {};
+    std::chrono::steady_clock::time_point prev_time_{};
+    int trigger_fds_[RESOURCE_COUNT] = {-1, -1, -1};
+    uint64_t triggers_[RESOURCE_COUNT] = {};
+    std::string trigger_spec_;
+    SnapshotBuffer<Snapshot> snapshot_;
+};
+
+#endif // PRESSURE_COLLECTOR_H
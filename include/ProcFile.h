@@ -0,0 +1,99 @@
+#ifndef PROC_FILE_H
+#define PROC_FILE_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <vector>
+
+class IoUring;
+
+/**
+ * /proc 文件句柄 (Persistent File Handle)
+ *
+ * 目的：避免每次采集都 open/close 文件并构造 ifstream
+ *
+ * 实现要点：
+ * 1. 构造后首次 read() 时打开文件，之后一直持有 fd
+ * 2. 每次采集用 pread(fd, buf, n, 0) 从头重新读取，procfs 会重新生成内容
+ * 3. 缓冲区由句柄持有并预分配，内容超出容量时翻倍后重读，稳定后不再分配
+ * 4. 读取失败（文件消失、fd 失效）时关闭并重新打开一次
+ *
+ * read() 返回的 string_view 指向内部缓冲区，下一次 read() 之前有效，
+ * 且保证末尾有 '\0'，可以安全交给 C 风格的解析函数。
+ *
+ * 加入 ProcFileBatch 后，下一次 read() 直接返回批量读取的结果，不再 pread。
+ */
+class ProcFile {
+public:
+    explicit ProcFile(std::string path, size_t initial_capacity = 4096);
+    ~ProcFile();
+
+    // 持有 fd，禁止拷贝，允许移动
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+
+    // 读取整个文件，失败返回空视图
+    std::string_view read();
+
+    const std::string& path() const { return path_; }
+    bool is_open() const { return fd_ != -1; }
+
+private:
+    friend class ProcFileBatch;
+
+    bool open();
+    void close();
+
+    std::string path_;
+    int fd_ = -1;
+    std::vector<char> buffer_;
+    long prefetched_ = -1;  // 批量读取的结果（字节数），-1 表示没有
+    int batch_index_ = -1;  // 在 ProcFileBatch 注册缓冲区中的下标
+};
+
+/**
+ * ProcFile 批量读取 (io_uring)
+ *
+ * 目的：调度器在分发采集器之前，把本 tick 所有 ProcFile 的读取
+ * 合并成一次 io_uring_enter，采集器的 do_collect() 拿到的是已经填好的缓冲区
+ *
+ * 实现要点：
+ * 1. 每个 ProcFile 的缓冲区注册为固定缓冲区，用 READ_FIXED 读取；
+ *    出现新文件或缓冲区扩容后重新注册，稳定后不再注册
+ * 2. 读满缓冲区或读取失败的文件不记录结果，read() 照常走 pread 路径扩容重读
+ *
+ * 加入过批量读取的 ProcFile 必须比 ProcFileBatch 活得久，且之后不能移动。
+ */
+class ProcFileBatch {
+public:
+    ProcFileBatch();
+    ~ProcFileBatch();
+
+    ProcFileBatch(const ProcFileBatch&) = delete;
+    ProcFileBatch& operator=(const ProcFileBatch&) = delete;
+
+    // 创建 io_uring，内核不支持时返回 false
+    bool init();
+
+    // 本次批量读取 file（尚未打开的文件在这里打开）
+    void add(ProcFile& file);
+
+    // 提交 add() 过的所有读取并等待全部完成
+    void submit();
+
+    uint64_t submissions() const { return submissions_; }
+
+private:
+    std::unique_ptr<IoUring> ring_;
+    std::vector<ProcFile*> pending_;     // 本次要读取的文件
+    std::vector<ProcFile*> registered_;  // 按 batch_index_ 排列
+    std::vector<iovec> iovs_;
+    bool dirty_ = false;                 // 需要重新注册缓冲区
+    uint64_t submissions_ = 0;
+};
+
+#endif // PROC_FILE_H
@@ -0,0 +1,118 @@
+#ifndef PROCESS_SCANNER_H
+#define PROCESS_SCANNER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// /proc/<pid>/stat 中需要的字段（定长，不涉及堆分配）
+struct ProcStat {
+    int pid = 0;
+    char state = '?';
+    char comm[64] = {};
+    uint8_t comm_len = 0;
+    uint64_t utime = 0;
+    uint64_t stime = 0;
+    int64_t num_threads = 0;
+    uint64_t starttime = 0;
+    uint64_t vsize = 0;
+    int64_t rss = 0;
+
+    std::string_view name() const { return std::string_view(comm, comm_len); }
+};
+
+/**
+ * 进程扫描器
+ *
+ * 目的：在数万 PID 的主机上快速遍历 /proc
+ *
+ * 实现要点：
+ * 1. 持有 /proc 的目录 fd，每次扫描 lseek 回开头后用 getdents64 批量读取目录项
+ * 2. 用 openat(root_fd, "<pid>/stat") + read 读取到栈上缓冲区，不拼接 std::string
+ * 3. 只解析需要的字段，跳过其余字段
+ * 4. 线程（/proc/<pid>/task/<tid>/stat）走同样的路径，只在调用方指定的进程上枚举
+ *
+ * read_stat() 不修改扫描器状态，可以在多个线程中并发调用。
+ */
+class ProcessScanner {
+public:
+    explicit ProcessScanner(std::string root);
+    ~ProcessScanner();
+
+    ProcessScanner(const ProcessScanner&) = delete;
+    ProcessScanner& operator=(const ProcessScanner&) = delete;
+
+    // 列出所有 PID，结果覆盖写入 pids（复用容量）
+    bool list_pids(std::vector<int>& pids);
+
+    // 读取并解析 <root>/<pid>/stat，进程已退出时返回 false
+    bool read_stat(int pid, ProcStat& out) const;
+
+    // 列出进程的所有线程（<root>/<pid>/task），结果覆盖写入 tids
+    bool list_tasks(int pid, std::vector<int>& tids);
+
+    // 读取并解析 <root>/<pid>/task/<tid>/stat，out.pid 为 tid
+    bool read_task_stat(int pid, int tid, ProcStat& out) const;
+
+    // 解析一行 stat 内容
+    static bool parse_stat(std::string_view line, ProcStat& out);
+
+    const std::string& root() const { return root_; }
+    // list_pids() 打开的目录 fd，尚未打开时为 -1
+    int root_fd() const { return root_fd_; }
+
+private:
+    bool open_root();
+    // 用 getdents64 列出目录下的数字子目录（PID 或 TID）
+    bool list_numeric(int dir_fd, const char* what, std::vector<int>& ids);
+    bool read_stat_at(const char* path, int id, ProcStat& out) const;
+
+    std::string root_;
+    int root_fd_ = -1;
+    std::vector<char> dents_buf_;
+};
+
+class IoUring;
+
+/**
+ * io_uring 批量读取 /proc/<pid>/stat
+ *
+ * 目的：逐个 PID 的 openat + read + close 是每个进程三次系统调用，
+ * 数万进程时系统调用本身就是扫描的主要开销
+ *
+ * 实现要点：
+ * 1. 每个 PID 提交一条链：OPENAT 到固定文件槽位 → READ_FIXED → CLOSE，
+ *    用 IOSQE_IO_HARDLINK 连接，读不满缓冲区（短读）也不会取消后面的 CLOSE
+ * 2. 一次提交 BATCH 个 PID，读取到一块注册过的缓冲区中各自的分段
+ * 3. 打开失败（进程已退出）的 PID 直接跳过；其他错误退回 read_stat()
+ *
+ * 每个线程一个读取器；需要 Linux 5.19 以上（稀疏固定文件表），
+ * init() 失败时调用方使用 read_stat()。
+ */
+class StatBatchReader {
+public:
+    static constexpr size_t BATCH = 256;
+
+    StatBatchReader();
+    ~StatBatchReader();
+
+    StatBatchReader(const StatBatchReader&) = delete;
+    StatBatchReader& operator=(const StatBatchReader&) = delete;
+
+    bool init();
+
+    // 读取并解析 pids[0, count) 的 stat，成功的追加到 out
+    void read(const ProcessScanner& scanner, const int* pids, size_t count,
+              std::vector<ProcStat>& out);
+
+private:
+    std::unique_ptr<IoUring> ring_;
+    std::vector<char> buffers_;   // BATCH 个分段，注册为一个固定缓冲区
+    std::vector<char> paths_;     // BATCH 个 "<pid>/stat"，提交完成前必须有效
+    std::vector<int> open_results_;
+    std::vector<int> read_results_;
+};
+
+#endif // PROCESS_SCANNER_H
@@ -0,0 +1,119 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "Collectors.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * 原始输入记录文件格式
+ *
+ *   MAGIC | Record | Record | ...
+ *
+ * 每条记录是 [类型 1 字节][varint 记录体长度][记录体]，整数都是 varint：
+ * - SOURCE：id、采集器名（get_name()），在这个采集器的第一条 INPUT 之前出现
+ * - INPUT：id、采样时间（相对记录开始的纳秒）、raw_data_ 的原始字节
+ * - TICK：一个 tick 结束的时间（纳秒），回放按它统计 tick 数和每 tick 耗时
+ *
+ * 写入方每个 tick 整体追加一次，进程中途被杀时文件末尾最多少半个 tick。
+ */
+namespace replay {
+
+constexpr char MAGIC[8] = {'S', 'M', 'R', 'A', 'W', '0', '0', '1'};
+// SOURCE id 的上限（不含）：每个采集器一个 id，远多于注册的采集器数；
+// 记录里更大的 id 说明文件已损坏
+constexpr uint64_t MAX_SOURCES = 64;
+
+enum RecordType : uint8_t {
+    RECORD_SOURCE = 1,
+    RECORD_INPUT = 2,
+    RECORD_TICK = 3,
+};
+
+} // namespace replay
+
+/**
+ * 原始输入记录器 (--record)
+ *
+ * 目的：从生产主机上带回采集器真实的输入，离线重现监控器自身的性能问题
+ *
+ * 实现要点：
+ * 1. 作为 RawSink 挂在 replayable() 的采集器上，update() 之后把 raw_data_ 复制进缓冲区；
+ *    调度器的多个线程（以及后台首次采集）可能同时调用，用一把互斥锁保护
+ * 2. end_tick() 追加 TICK 记录后一次 write() 写出整个 tick，文件按 tick 完整
+ * 3. 写入失败时记录错误并停止记录，不影响采集
+ */
+class RawRecorder : public RawSink {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RawRecorder() = default;
+    ~RawRecorder() override;
+
+    RawRecorder(const RawRecorder&) = delete;
+    RawRecorder& operator=(const RawRecorder&) = delete;
+
+    bool open(const std::string& path);
+
+    void record(const Collector& collector, Clock::time_point sampled_at,
+                std::string_view raw) override;
+
+    // 一个 tick 的输出完成：追加 TICK 记录并写出缓冲区
+    void end_tick(Clock::time_point now);
+
+    bool failed() const { return failed_; }
+    uint64_t bytes_written() const { return written_; }
+
+private:
+    uint64_t since_start(Clock::time_point t) const;
+    void append_record(uint8_t type, const std::vector<uint8_t>& head,
+                       std::string_view body);
+
+    std::mutex mutex_;
+    int fd_ = -1;
+    Clock::time_point start_{};
+    std::vector<const Collector*> sources_;  // 下标就是 SOURCE id
+    std::vector<uint8_t> buffer_;            // 本 tick 还没写出的记录
+    std::vector<uint8_t> head_;
+    uint64_t written_ = 0;
+    bool failed_ = false;
+};
+
+/**
+ * 记录文件读取器 (--replay)：mmap 整个文件，INPUT 的原始字节直接指向映射，不复制
+ */
+class ReplayReader {
+public:
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual void on_source(uint64_t id, std::string_view name) = 0;
+        virtual void on_input(uint64_t id, uint64_t timestamp_ns, std::string_view raw) = 0;
+        virtual void on_tick(uint64_t timestamp_ns) = 0;
+    };
+
+    ReplayReader() = default;
+    ~ReplayReader();
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    bool open(const std::string& path);
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // 按顺序回调 [data, data + size) 中的记录；不是记录文件或记录损坏（包括 id 不小于
+    // replay::MAX_SOURCES）时返回 false，末尾不完整的记录（记录方被中途杀死）直接忽略
+    static bool decode(const uint8_t* data, size_t size, Handler& handler);
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,122 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 无锁快照缓冲区 (Snapshot Buffer)
+ *
+ * 目的：采集器在 tick 线程上写入结果，渲染器、导出器、HTTP 等读取方
+ * 在任意线程上读取一致的快照，双方都不加锁，写入方永远不会等待读取方
+ *
+ * 实现要点：
+ * 1. 固定 SLOTS 个槽位，每个槽位一个 T 和一个读者引用计数；
+ *    latest_ 指向最近发布的槽位
+ * 2. 写入方挑一个既不是 latest_、也没有读者持有的槽位填充，
+ *    然后一次原子写 latest_ 发布；找不到空闲槽位（读者太慢）时放弃本次发布
+ * 3. 读取方先给 latest_ 指向的槽位加引用，再确认 latest_ 没有变化，
+ *    变化了就放掉重试；持有引用期间写入方不会复用这个槽位
+ *
+ * 槽位里的 T 跨多次发布复用，填充函数必须覆盖全部字段；
+ * 容器复用已有容量，稳定状态下发布不分配内存。
+ *
+ * 只允许一个写入方；读取方数量不限，但同时持有的快照越多，
+ * 写入方越可能因为没有空闲槽位而跳过发布。
+ */
+template <typename T, size_t SLOTS = 3>
+class SnapshotBuffer {
+    static_assert(SLOTS >= 2, "至少需要两个槽位");
+
+    static constexpr uint32_t NONE = ~0u;
+
+    struct Slot {
+        T value;
+        std::atomic<uint32_t> readers{0};
+    };
+
+public:
+    // 读取方持有的快照，析构时释放槽位；read() 在尚未发布时返回空快照
+    class Reader {
+    public:
+        Reader() = default;
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader(Reader&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+        Reader& operator=(Reader&& other) noexcept {
+            if (this != &other) {
+                release();
+                slot_ = other.slot_;
+                other.slot_ = nullptr;
+            }
+            return *this;
+        }
+        ~Reader() { release(); }
+
+        explicit operator bool() const { return slot_ != nullptr; }
+        const T& operator*() const { return slot_->value; }
+        const T* operator->() const { return &slot_->value; }
+
+    private:
+        friend class SnapshotBuffer;
+        explicit Reader(Slot* slot) : slot_(slot) {}
+
+        void release() {
+            if (slot_) {
+                slot_->readers.fetch_sub(1, std::memory_order_release);
+                slot_ = nullptr;
+            }
+        }
+
+        Slot* slot_ = nullptr;
+    };
+
+    SnapshotBuffer() = default;
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    // 取得最近发布的快照（无锁，不会阻塞写入方）
+    Reader read() const {
+        while (true) {
+            uint32_t index = latest_.load(std::memory_order_seq_cst);
+            if (index == NONE)
+                return Reader();
+            Slot& slot = slots_[index];
+            slot.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (latest_.load(std::memory_order_seq_cst) == index)
+                return Reader(&slot);
+            // 加引用之前写入方已经发布了新的槽位：这个槽位可能正在被改写
+            slot.readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // 用 fill(T&) 填充一个空闲槽位并发布；没有空闲槽位时返回 false
+    template <typename F>
+    bool publish(F&& fill) {
+        uint32_t latest = latest_.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < SLOTS; ++i) {
+            if (i == latest || slots_[i].readers.load(std::memory_order_seq_cst) != 0)
+                continue;
+            fill(slots_[i].value);
+            latest_.store(i, std::memory_order_seq_cst);
+            ++published_;
+            return true;
+        }
+        ++skipped_;
+        return false;
+    }
+
+    // 仅供写入方线程读取的统计
+    uint64_t published() const { return published_; }
+    uint64_t skipped() const { return skipped_; }
+
+private:
+    mutable std::array<Slot, SLOTS> slots_;
+    std::atomic<uint32_t> latest_{NONE};
+    uint64_t published_ = 0;
+    uint64_t skipped_ = 0;
+};
+
+#endif // SNAPSHOT_H
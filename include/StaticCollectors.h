@@ -0,0 +1,109 @@
+#ifndef STATIC_COLLECTORS_H
+#define STATIC_COLLECTORS_H
+
+#include "CgroupCollector.h"
+#include "Collectors.h"
+#include "NumaCollector.h"
+#include "PressureCollector.h"
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * 编译期注册表 (Compile-Time Registry)
+ *
+ * 目的：CollectorFactory 通过 std::function 创建采集器，update() 的每个阶段
+ * 都是一次虚调用，编译器看不到具体类型，无法内联。采集器集合在编译期已知时
+ * （嵌入到其他程序、固定配置的代理），可以用类型列表代替运行时注册
+ *
+ * 实现要点：
+ * 1. CollectorList<Ts...> 是类型列表，StaticCollectorSet 把它展开成
+ *    std::tuple<Sealed<Ts>...>，采集器按值存放在一起，没有单独的堆分配
+ * 2. Sealed<T> 是 T 的 final 子类：具体类型在编译期已知，
+ *    update_inline() 用限定名调用 T::do_collect() 等，不经过虚表，可以内联
+ * 3. update_all() / for_each() 用折叠表达式按列表顺序展开，
+ *    整个 tick 循环是一段直线代码
+ * 4. 各阶段的耗时和分配统计与 Collector::update() 相同（共用 run_phases()）
+ *
+ * 采集器本身不标记 final：替代后端（NetlinkNetworkCollector 等）和基准里的
+ * 测试夹具都从它们派生。需要运行时注册的插件、--backend 和 --interval
+ * 仍然走 CollectorFactory，REGISTER_COLLECTOR 不受影响。
+ */
+
+template <typename... Ts> struct CollectorList {};
+
+// 每种采集器的构造参数：默认是 proc 根目录；数据不在 /proc 下的采集器特化它，
+// 否则 CgroupCollector 会把 /proc 当成 cgroup 层级遍历
+template <typename T> struct CollectorRoot {
+    static std::string get(const std::string& proc_root) { return proc_root; }
+};
+
+template <> struct CollectorRoot<CgroupCollector> {
+    static std::string get(const std::string& /*proc_root*/) { return default_cgroup_root(); }
+};
+
+template <typename T> class Sealed final : public T {
+public:
+    using T::T;
+
+    // update() 的静态分发版本
+    void update_inline() {
+        this->run_phases([this] { T::do_collect(); },
+                         [this] { T::do_parse(); },
+                         [this] {
+                             T::do_calculate();
+                             T::do_snapshot();
+                         });
+    }
+};
+
+template <typename List> class StaticCollectorSet;
+
+template <typename... Ts> class StaticCollectorSet<CollectorList<Ts...>> {
+public:
+    static constexpr size_t SIZE = sizeof...(Ts);
+
+    // 读取 /proc 的采集器从 proc_root 读取，其余的见 CollectorRoot
+    explicit StaticCollectorSet(const std::string& proc_root = default_proc_root())
+        : collectors_(CollectorRoot<Ts>::get(proc_root)...) {}
+
+    StaticCollectorSet(const StaticCollectorSet&) = delete;
+    StaticCollectorSet& operator=(const StaticCollectorSet&) = delete;
+
+    // 按列表顺序更新所有采集器
+    void update_all() {
+        std::apply([](auto&... c) { (c.update_inline(), ...); }, collectors_);
+    }
+
+    // 按列表顺序对每个采集器调用 fn(具体类型的引用)
+    template <typename Fn> void for_each(Fn&& fn) {
+        std::apply([&fn](auto&... c) { (fn(c), ...); }, collectors_);
+    }
+    template <typename Fn> void for_each(Fn&& fn) const {
+        std::apply([&fn](const auto&... c) { (fn(c), ...); }, collectors_);
+    }
+
+    template <typename T> T& get() { return std::get<Sealed<T>>(collectors_); }
+    template <typename T> const T& get() const { return std::get<Sealed<T>>(collectors_); }
+
+    // 基类指针视图，供 CollectorScheduler 和显示代码使用
+    std::vector<Collector*> pointers() {
+        std::vector<Collector*> out;
+        out.reserve(SIZE);
+        for_each([&out](Collector& c) { out.push_back(&c); });
+        return out;
+    }
+
+private:
+    std::tuple<Sealed<Ts>...> collectors_;
+};
+
+// 默认的九个采集器，顺序与 Collectors.cpp 中的注册顺序一致
+using DefaultCollectorList = CollectorList<SystemCollector, CPUCollector, MemoryCollector,
+                                           NumaCollector, DiskCollector, NetworkCollector,
+                                           ProcessCollector, CgroupCollector, PressureCollector>;
+using DefaultStaticCollectors = StaticCollectorSet<DefaultCollectorList>;
+
+#endif // STATIC_COLLECTORS_H
@@ -0,0 +1,181 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * 一组任务的完成等待
+ *
+ * 与 submit() 返回的 std::future 相比不需要共享状态，提交和等待都不分配。
+ * 任务抛出的第一个异常在 wait() 中重新抛出。
+ */
+class TaskGroup {
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // 等待已提交的任务全部完成
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return pending_ == 0; });
+        if (error_) {
+            std::exception_ptr error = std::move(error_);
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    friend class ThreadPool;
+
+    void add() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_;
+    }
+    void done(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error && !error_) error_ = std::move(error);
+        if (--pending_ == 0) cv_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t pending_ = 0;
+    std::exception_ptr error_;
+};
+
+/**
+ * 固定大小线程池
+ *
+ * 目的：让采集器把可并行的工作（分片扫描、独立采集器）交给常驻线程，
+ * 不必每个 tick 创建和销毁线程
+ *
+ * 用法：
+ *   ThreadPool pool(4);
+ *   auto f = pool.submit([] { ... });
+ *   f.get();  // 等待完成，任务中的异常在这里重新抛出
+ *
+ * 每个 tick 都要提交的任务用 TaskGroup 版本：任务对象从调用方给的
+ * memory_resource（通常是 TickArena）分配，队列是复用的环形数组，
+ * 稳定后提交一个任务不触发堆分配。
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads) {
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // 提交任务，返回的 future 在任务完成后就绪
+    template <typename F>
+    std::future<void> submit(F&& task) {
+        auto packaged = std::make_shared<std::packaged_task<void()>>(std::forward<F>(task));
+        std::future<void> result = packaged->get_future();
+        enqueue([packaged] { (*packaged)(); });
+        return result;
+    }
+
+    // 提交属于 group 的任务，任务对象从 memory 分配；完成后由 group.wait() 等待
+    template <typename F>
+    void submit(TaskGroup& group, std::pmr::memory_resource* memory, F&& task) {
+        using Task = std::decay_t<F>;
+        struct Stored {
+            Task task;
+            TaskGroup* group;
+            std::pmr::memory_resource* memory;
+        };
+        void* raw = memory->allocate(sizeof(Stored), alignof(Stored));
+        Stored* stored = new (raw) Stored{Task(std::forward<F>(task)), &group, memory};
+        group.add();
+        // 只捕获一个指针，std::function 直接存放在内部，不分配
+        enqueue([stored] {
+            std::exception_ptr error;
+            try {
+                stored->task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            TaskGroup* owner = stored->group;
+            std::pmr::memory_resource* memory = stored->memory;
+            stored->~Stored();
+            memory->deallocate(stored, sizeof(Stored), alignof(Stored));
+            owner->done(std::move(error));
+        });
+    }
+
+private:
+    void enqueue(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (count_ == ring_.size()) grow();
+            ring_[(head_ + count_) % ring_.size()] = std::move(task);
+            ++count_;
+        }
+        cv_.notify_one();
+    }
+
+    // 环形队列满时容量翻倍（调用方持有锁）
+    void grow() {
+        std::vector<std::function<void()>> larger(ring_.empty() ? 16 : ring_.size() * 2);
+        for (size_t i = 0; i < count_; ++i) {
+            larger[i] = std::move(ring_[(head_ + i) % ring_.size()]);
+        }
+        ring_.swap(larger);
+        head_ = 0;
+    }
+
+    void worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || count_ > 0; });
+                if (stopping_ && count_ == 0) return;
+                task = std::move(ring_[head_]);
+                ring_[head_] = nullptr;
+                head_ = (head_ + 1) % ring_.size();
+                --count_;
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::vector<std::function<void()>> ring_;  // 环形队列
+    size_t head_ = 0;
+    size_t count_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+#endif // THREAD_POOL_H
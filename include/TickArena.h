@@ -0,0 +1,60 @@
+#ifndef TICK_ARENA_H
+#define TICK_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/**
+ * 每 tick 的单调内存池 (Monotonic Arena)
+ *
+ * 目的：一个 tick 里只活到本 tick 结束的小对象（提交给线程池的任务等）
+ * 不必逐个 malloc/free，分配只是移动指针，tick 结束时一次性释放
+ *
+ * 实现要点：
+ * 1. std::pmr::monotonic_buffer_resource 建在一块跨 tick 复用的内存上，
+ *    deallocate() 是空操作
+ * 2. 本 tick 用量超过块大小时多出的部分向上游（new/delete）申请；
+ *    reset() 发现溢出就把块扩大到本 tick 的用量，之后的 tick 不再溢出
+ * 3. 采集器可能并发运行在调度器的线程上，allocate() 用互斥锁保护；
+ *    每个 tick 只有几十次分配，锁不会成为瓶颈
+ * 4. 跨 tick 的容器（ProcessCollector::processes_、磁盘和网卡的 DeviceTable）
+ *    不放在这里：reset() 会释放它们保存的上一次计数器；它们按槽位复用容量，
+ *    稳定后本来就不分配
+ *
+ * reset() 之前必须确认从这里分配的对象都已经不再使用
+ * （调度器 run() 返回、画面输出完成之后）。
+ */
+class TickArena : public std::pmr::memory_resource {
+public:
+    explicit TickArena(size_t initial_bytes = 16 * 1024);
+
+    TickArena(const TickArena&) = delete;
+    TickArena& operator=(const TickArena&) = delete;
+
+    // 释放本 tick 的所有分配，必要时扩大复用的内存块
+    void reset();
+
+    // 本 tick 已分配的字节数、复用块的大小、累计溢出到上游的 tick 数
+    size_t used_bytes() const { return used_; }
+    size_t capacity() const { return block_.size(); }
+    uint64_t overflows() const { return overflows_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::vector<std::byte> block_;
+    std::optional<std::pmr::monotonic_buffer_resource> resource_;
+    std::mutex mutex_;
+    size_t used_ = 0;
+    uint64_t overflows_ = 0;
+};
+
+#endif // TICK_ARENA_H
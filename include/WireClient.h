@@ -0,0 +1,83 @@
+#ifndef WIRE_CLIENT_H
+#define WIRE_CLIENT_H
+
+#include "MetricStore.h"
+#include "WireProtocol.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class EventLoop;
+
+/**
+ * 汇聚客户端 (Push Client)
+ *
+ * 目的：多台主机把指标推给一个汇聚端（见 Aggregator），而不是每台都被抓取；
+ * 每个节点只占每秒几百字节的带宽
+ *
+ * 实现要点：
+ * 1. 每个 tick 在 publish 之后调用 update()，用 wire::Encoder 把本 tick 变化的
+ *    指标编码成 SAMPLES 帧（新指标先发 DEFINE 帧），追加到发送缓冲区
+ * 2. socket 非阻塞，注册在 main() 的 EventLoop 上；发不完的部分留在缓冲区，
+ *    注册 EPOLLOUT 等可写时继续
+ * 3. 汇聚端不可达或太慢（缓冲区超过 MAX_PENDING_BYTES）时断开，
+ *    RETRY_INTERVAL 之后重连；重连后 Encoder 从头开始，发送完整的定义和数值
+ *
+ * 只支持 IPv4，地址在启动时解析一次。
+ */
+class WireClient {
+public:
+    static constexpr size_t MAX_PENDING_BYTES = 256 * 1024;
+    static constexpr std::chrono::seconds RETRY_INTERVAL{5};
+
+    // host_name 是汇聚端用来区分主机的名字，interval 是本机最短的采样周期
+    WireClient(EventLoop& loop, std::string host_name, std::chrono::milliseconds interval);
+    ~WireClient();
+
+    WireClient(const WireClient&) = delete;
+    WireClient& operator=(const WireClient&) = delete;
+
+    // 解析 "HOST:PORT"，失败返回 false；连接在第一次 update() 时建立
+    bool set_target(const std::string& address);
+
+    // 编码并发送 store 中本 tick 变化的指标
+    void update(const MetricStore& store, int64_t timestamp_ms);
+
+    bool connected() const { return state_ == State::CONNECTED; }
+    uint64_t bytes_sent() const { return bytes_sent_; }
+    uint64_t reconnects() const { return reconnects_; }
+
+    // 一行状态，显示在画面下方
+    void print(std::ostream& out) const;
+
+private:
+    enum class State { DISCONNECTED, CONNECTING, CONNECTED };
+
+    bool connect_target();
+    void on_event(uint32_t events);
+    bool flush();
+    void disconnect(const std::string& reason);
+
+    EventLoop& loop_;
+    std::string host_name_;
+    std::chrono::milliseconds interval_;
+    std::string address_;
+    sockaddr_in target_{};
+
+    int fd_ = -1;
+    State state_ = State::DISCONNECTED;
+    bool want_write_ = false;
+    std::chrono::steady_clock::time_point retry_at_{};
+
+    wire::Encoder encoder_;
+    std::vector<uint8_t> pending_;  // 还没写进 socket 的字节
+    size_t pending_offset_ = 0;
+    uint64_t bytes_sent_ = 0;
+    uint64_t reconnects_ = 0;
+};
+
+#endif // WIRE_CLIENT_H
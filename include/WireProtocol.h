@@ -0,0 +1,175 @@
+#ifndef WIRE_PROTOCOL_H
+#define WIRE_PROTOCOL_H
+
+#include "MetricStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 汇聚协议的帧格式
+ *
+ *   varint 帧体长度 | u8 帧类型 | 帧体
+ *
+ * 一条 TCP 连接上依次是一个 HELLO 帧，然后每个 tick 一个可选的 DEFINE 帧
+ * 和一个 SAMPLES 帧。所有整数都是 LEB128 varint，有符号数先做 zigzag。
+ *
+ * HELLO：  MAGIC(4 字节) | 版本 | 采样周期(ms) | 主机名长度 | 主机名
+ * DEFINE： 新字符串个数 | (长度 | 字节)... | 新指标个数 | (名字, 标签 key, 标签值)...
+ *          字符串按出现顺序编号，0 号是预置的空字符串；指标按出现顺序编号，
+ *          与客户端 MetricStore 的 id 一致
+ * SAMPLES：时间戳增量(zigzag, ms) | 个数 | ((id 间隔 << 1) | 千分位标志, 数值增量(zigzag))...
+ *          只包含与上次发送的值不同的指标，id 递增，间隔 = id - (上一个 id + 1)；
+ *          整数值按原值、其余按千分位取整后与该指标上次发送的量化值做差
+ *          （标志与上次不同时与 0 做差）
+ */
+namespace wire {
+
+constexpr char MAGIC[4] = {'S', 'M', 'W', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t MAX_FRAME_BYTES = 1 << 20;
+
+enum FrameType : uint8_t {
+    FRAME_HELLO = 1,
+    FRAME_DEFINE = 2,
+    FRAME_SAMPLES = 3,
+};
+
+inline void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// 读取一个 varint，越界或超过 10 字节时返回 false
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// 数值量化：整数原样返回（标志 false），其余取千分位（标志 true）；非有限值返回 false
+bool quantize(double value, int64_t& q, bool& milli);
+double dequantize(int64_t q, bool milli);
+
+/**
+ * 客户端编码器：每条连接一个，记住已发送的字符串、指标和数值
+ */
+class Encoder {
+public:
+    // 新连接：之后的 encode_tick() 重新发送所有字符串、指标和数值
+    void reset();
+
+    void encode_hello(std::string_view host, uint32_t interval_ms, std::vector<uint8_t>& out);
+
+    // 追加新指标的 DEFINE 帧（如果有）和变化值的 SAMPLES 帧，返回变化的指标数
+    size_t encode_tick(const MetricStore& store, int64_t timestamp_ms,
+                       std::vector<uint8_t>& out);
+
+private:
+    struct Last {
+        int64_t q = 0;
+        bool milli = false;
+        bool sent = false;
+    };
+
+    uint64_t intern(const std::string& text, size_t& new_strings);
+    void append_frame(FrameType type, std::vector<uint8_t>& out);
+
+    std::unordered_map<std::string, uint64_t> strings_;  // 字符串 -> 编号
+    size_t defined_ = 0;                                   // 已定义的指标数
+    std::vector<Last> last_;
+    int64_t last_ts_ = 0;
+    std::vector<uint8_t> strings_body_;
+    std::vector<uint8_t> body_;
+};
+
+// 一条连接上 DEFINE 可以累计定义的量，超出时解码失败、断开连接；默认不限制
+struct DecoderLimits {
+    size_t max_metrics = SIZE_MAX;
+    size_t max_strings = SIZE_MAX;       // 不含预置的空字符串
+    size_t max_string_bytes = SIZE_MAX;
+
+    // 按指标数推算：每个指标最多 3 个新字符串（名字、标签 key、标签值），
+    // 每个平均不超过 STRING_BYTES_PER_STRING 字节
+    static constexpr size_t STRING_BYTES_PER_STRING = 256;
+    static DecoderLimits for_metrics(size_t metrics) {
+        DecoderLimits limits;
+        limits.max_metrics = metrics;
+        limits.max_strings = metrics * 3;
+        limits.max_string_bytes = limits.max_strings * STRING_BYTES_PER_STRING;
+        return limits;
+    }
+};
+
+/**
+ * 汇聚端解码器：每条连接一个
+ *
+ * 已定义的字符串和指标在连接的生命周期内一直保留，总量受 DecoderLimits 限制：
+ * MAX_FRAME_BYTES 只限制单个帧，客户端可以发任意多个 DEFINE 帧。
+ */
+class Decoder {
+public:
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual bool on_hello(const std::string& host, uint32_t interval_ms) = 0;
+        virtual void on_define(uint64_t id, const std::string& name, const std::string& label_key,
+                               const std::string& label_value) = 0;
+        virtual void on_sample(uint64_t id, int64_t timestamp_ms, double value) = 0;
+    };
+
+    Decoder() { reset(); }
+    void reset();
+    // 之后的 DEFINE 帧按 limits 检查；reset() 不改变上限
+    void set_limits(const DecoderLimits& limits) { limits_ = limits; }
+
+    // 解析 data 开头的所有完整帧，返回消耗的字节数；协议错误返回 -1
+    long consume(const uint8_t* data, size_t size, Handler& handler);
+
+    const std::string& error() const { return error_; }
+    uint64_t frames() const { return frames_; }
+
+private:
+    bool decode_frame(uint8_t type, const uint8_t* p, const uint8_t* end, Handler& handler);
+    bool fail(const char* message);
+
+    struct Metric {
+        uint64_t name = 0;
+        uint64_t key = 0;
+        uint64_t value = 0;
+        int64_t q = 0;
+        bool milli = false;
+    };
+
+    DecoderLimits limits_;
+    bool hello_ = false;
+    std::vector<std::string> strings_;
+    size_t string_bytes_ = 0;  // strings_ 的总字节数
+    std::vector<Metric> metrics_;
+    int64_t last_ts_ = 0;
+    uint64_t frames_ = 0;
+    std::string error_;
+};
+
+} // namespace wire
+
+#endif // WIRE_PROTOCOL_H
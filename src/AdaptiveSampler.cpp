@@ -0,0 +1,107 @@
+#include "AdaptiveSampler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <iomanip>
+#include <sys/resource.h>
+#include <unistd.h>
+
+AdaptiveSampler::AdaptiveSampler(const Thresholds &thresholds,
+                                 const CPUCollector *cpu,
+                                 const SystemCollector *system,
+                                 ProcessCollector *process)
+    : thresholds_(thresholds), cpu_(cpu), system_(system), process_(process) {
+  if (process_)
+    base_top_n_ = process_->top_n();
+  long online = sysconf(_SC_NPROCESSORS_ONLN);
+  cpus_ = online > 0 ? static_cast<unsigned>(online) : 1;
+}
+
+uint64_t AdaptiveSampler::self_cpu_ns() {
+  // 包括所有线程：调度器、扫描分片和日志线程
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  auto ns = [](const timeval &tv) {
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000000ULL +
+           static_cast<uint64_t>(tv.tv_usec) * 1000ULL;
+  };
+  return ns(usage.ru_utime) + ns(usage.ru_stime);
+}
+
+void AdaptiveSampler::filter(std::vector<Collector *> &due) {
+  if (!process_ || LEVELS[level_].interval_factor == 1)
+    return;
+  auto it = std::find(due.begin(), due.end(), process_);
+  if (it == due.end())
+    return;
+  // 每 interval_factor 次到期只执行一次，跳过时显示上一次的快照
+  if (process_due_++ % LEVELS[level_].interval_factor != 0)
+    due.erase(it);
+}
+
+void AdaptiveSampler::update(std::chrono::steady_clock::time_point now) {
+  if (!process_)
+    return;
+  if (window_start_ == std::chrono::steady_clock::time_point{}) {
+    window_start_ = now;
+    window_cpu_ns_ = self_cpu_ns();
+    return;
+  }
+  auto wall = now - window_start_;
+  if (wall < EVAL_WINDOW)
+    return;
+
+  uint64_t cpu_ns = self_cpu_ns();
+  double wall_ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(wall).count());
+  self_cpu_percent_ = 100.0 * static_cast<double>(cpu_ns - window_cpu_ns_) / wall_ns;
+  window_start_ = now;
+  window_cpu_ns_ = cpu_ns;
+
+  double host_cpu = cpu_ ? cpu_->get_usage() : 0.0;
+  double load_per_cpu = 0.0;
+  if (system_) {
+    if (auto snap = system_->snapshot())
+      load_per_cpu = snap->load_1min / cpus_;
+  }
+  host_hot_ = host_cpu >= thresholds_.hot_cpu_percent ||
+              load_per_cpu >= thresholds_.hot_load_per_cpu;
+
+  size_t previous = level_;
+  bool over_budget = self_cpu_percent_ > thresholds_.cpu_budget_percent;
+  bool calm = !host_hot_ || self_cpu_percent_ < thresholds_.cpu_budget_percent / 2;
+  if (host_hot_ && over_budget) {
+    calm_windows_ = 0;
+    if (level_ < MAX_LEVEL)
+      ++level_;
+  } else if (calm && level_ > 0) {
+    if (++calm_windows_ >= CALM_WINDOWS) {
+      calm_windows_ = 0;
+      --level_;
+    }
+  } else {
+    calm_windows_ = 0;
+  }
+
+  if (level_ != previous) {
+    apply_level();
+    LOG_INFO("自适应采样: 级别 " + std::to_string(previous) + " -> " +
+             std::to_string(level_) + "，自身 CPU " +
+             std::to_string(self_cpu_percent_) + "%");
+  }
+}
+
+void AdaptiveSampler::apply_level() {
+  const Level &level = LEVELS[level_];
+  process_->set_top_n(std::max<size_t>(1, base_top_n_ / level.top_n_divisor));
+  process_->set_sample_stride(level.sample_stride);
+  process_due_ = 0;
+}
+
+void AdaptiveSampler::print(std::ostream &out) const {
+  const Level &level = LEVELS[level_];
+  out << "  自适应采样: 级别 " << level_ << "/" << MAX_LEVEL << " (进程间隔 x"
+      << level.interval_factor << ", 抽样 1/" << level.sample_stride
+      << "), 自身 CPU " << std::fixed << std::setprecision(2)
+      << self_cpu_percent_ << "% / 预算 " << thresholds_.cpu_budget_percent
+      << "%, 主机" << (host_hot_ ? "繁忙" : "正常") << "\n";
+}
@@ -0,0 +1,372 @@
+#include "Aggregator.h"
+#include "EventLoop.h"
+#include "Logger.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+constexpr size_t HOST_WIDTH = 24;
+
+// 死连接由 keepalive 在约 1 分钟内发现：空闲 30 秒后每 10 秒探测一次，3 次无响应断开
+void enable_keepalive(int fd) {
+  int one = 1, idle = 30, interval = 10, count = 3;
+  setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+  setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+  setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+  setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+}
+} // namespace
+
+Aggregator::Aggregator(EventLoop &loop, std::chrono::milliseconds retention,
+                       AggregatorLimits limits)
+    : loop_(loop), retention_(retention), limits_(limits) {}
+
+Aggregator::~Aggregator() {
+  if (sweep_fd_ != -1) {
+    loop_.set_timer(sweep_fd_, std::chrono::nanoseconds(0));
+    loop_.remove(sweep_fd_);
+  }
+  while (!connections_.empty())
+    close_connection(connections_.begin()->first);
+  if (listen_fd_ != -1) {
+    loop_.remove(listen_fd_);
+    close(listen_fd_);
+  }
+  if (spare_fd_ != -1)
+    close(spare_fd_);
+}
+
+bool Aggregator::listen(const std::string &address) {
+  std::string host = "0.0.0.0";
+  std::string_view port_text = address;
+  size_t colon = address.rfind(':');
+  if (colon != std::string::npos) {
+    host = address.substr(0, colon);
+    port_text = std::string_view(address).substr(colon + 1);
+  }
+
+  unsigned port = 0;
+  auto [ptr, ec] = std::from_chars(
+      port_text.data(), port_text.data() + port_text.size(), port);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  if (ec != std::errc() || ptr != port_text.data() + port_text.size() ||
+      port > 65535 || inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    LOG_ERROR("无效的汇聚地址: " + address);
+    return false;
+  }
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+
+  spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+  listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ == -1) {
+    LOG_ERROR(std::string("socket 失败: ") + strerror(errno));
+    return false;
+  }
+  int one = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+          -1 ||
+      ::listen(listen_fd_, SOMAXCONN) == -1) {
+    LOG_ERROR("监听 " + address + " 失败: " + strerror(errno));
+    close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  socklen_t len = sizeof(addr);
+  getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+  port_ = ntohs(addr.sin_port);
+
+  if (!loop_.add(listen_fd_, EPOLLIN, [this](uint32_t) { on_accept(); }))
+    return false;
+  sweep_fd_ = loop_.add_timer(std::chrono::seconds(1),
+                              [this](uint64_t) { close_idle(); });
+  return sweep_fd_ != -1;
+}
+
+void Aggregator::on_accept() {
+  while (true) {
+    int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+      if (errno == EINTR)
+        continue;
+      if ((errno == EMFILE || errno == ENFILE) && spare_fd_ != -1) {
+        // 不取走连接的话监听 socket 一直可读，事件循环会空转
+        close(spare_fd_);
+        int rejected = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (rejected != -1)
+          close(rejected);
+        spare_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        ++rejected_;
+        LOG_WARN("fd 已用完，拒绝新的汇聚连接");
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        LOG_WARN(std::string("accept 失败: ") + strerror(errno));
+      return;
+    }
+
+    enable_keepalive(fd);
+    auto conn = std::make_unique<Connection>();
+    conn->owner = this;
+    conn->fd = fd;
+    // 连接上定义的量不超过一台主机能保存的指标数，ids 也随之有上限
+    conn->decoder.set_limits(
+        wire::DecoderLimits::for_metrics(limits_.max_metrics_per_host));
+    conn->last_read = std::chrono::steady_clock::now();
+    if (!loop_.add(fd, EPOLLIN | EPOLLRDHUP,
+                   [this, fd](uint32_t events) { on_event(fd, events); })) {
+      close(fd);
+      continue;
+    }
+    connections_.emplace(fd, std::move(conn));
+  }
+}
+
+void Aggregator::on_event(int fd, uint32_t events) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end())
+    return;
+  // 先读完缓冲区里剩下的帧，再处理对端关闭
+  if (!read_frames(*it->second) || (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)))
+    close_connection(fd);
+}
+
+bool Aggregator::read_frames(Connection &conn) {
+  if (conn.input.empty())
+    conn.input.resize(INITIAL_BUFFER_BYTES);
+  while (true) {
+    if (conn.input_len == conn.input.size()) {
+      // 缓冲区里是一个很大的帧（通常是第一次的 DEFINE），按需扩大
+      if (conn.input.size() > wire::MAX_FRAME_BYTES) {
+        LOG_WARN("汇聚连接的帧过大，断开");
+        return false;
+      }
+      conn.input.resize(conn.input.size() * 2);
+    }
+    ssize_t n = read(conn.fd, conn.input.data() + conn.input_len,
+                     conn.input.size() - conn.input_len);
+    if (n == 0)
+      return false;
+    if (n == -1) {
+      if (errno == EINTR)
+        continue;
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    conn.input_len += static_cast<size_t>(n);
+    conn.last_read = std::chrono::steady_clock::now();
+
+    uint64_t frames_before = conn.decoder.frames();
+    long used = conn.decoder.consume(conn.input.data(), conn.input_len, conn);
+    if (used < 0) {
+      LOG_WARN("汇聚协议错误" +
+               (conn.host ? " (" + conn.host->name + ")" : std::string()) + ": " +
+               conn.decoder.error());
+      return false;
+    }
+    if (conn.host) {
+      conn.host->bytes += static_cast<uint64_t>(used);
+      if (conn.decoder.frames() != frames_before) {
+        conn.host->frames += conn.decoder.frames() - frames_before;
+        conn.host->last_frame = std::chrono::steady_clock::now();
+      }
+    }
+    size_t rest = conn.input_len - static_cast<size_t>(used);
+    if (used > 0 && rest > 0)
+      std::memmove(conn.input.data(), conn.input.data() + used, rest);
+    conn.input_len = rest;
+  }
+}
+
+void Aggregator::close_connection(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end())
+    return;
+  Host *host = it->second->host;
+  if (host && host->connection_fd == fd)
+    host->connection_fd = -1;
+  loop_.remove(fd);
+  close(fd);
+  connections_.erase(it);
+}
+
+void Aggregator::close_idle() {
+  auto now = std::chrono::steady_clock::now();
+  std::vector<int> idle;
+  for (auto &[fd, conn] : connections_) {
+    if (now - conn->last_read > conn->idle_limit)
+      idle.push_back(fd);
+  }
+  for (int fd : idle) {
+    const Host *host = connections_[fd]->host;
+    LOG_WARN("汇聚连接" + (host ? " (" + host->name + ")" : std::string()) +
+             " 超时无数据，断开");
+    close_connection(fd);
+  }
+}
+
+Aggregator::Host *Aggregator::host_for(const std::string &name) {
+  auto it = hosts_.find(name);
+  if (it != hosts_.end())
+    return it->second.get();
+
+  if (hosts_.size() >= limits_.max_hosts) {
+    // 淘汰最久没有数据的离线主机
+    auto victim = hosts_.end();
+    for (auto h = hosts_.begin(); h != hosts_.end(); ++h) {
+      if (h->second->connection_fd == -1 &&
+          (victim == hosts_.end() ||
+           h->second->last_frame < victim->second->last_frame))
+        victim = h;
+    }
+    if (victim == hosts_.end())
+      return nullptr;
+    LOG_WARN("主机数达到上限 " + std::to_string(limits_.max_hosts) + "，淘汰离线主机 " +
+             victim->first);
+    ring_bytes_ -= victim->second->ring_bytes;
+    hosts_.erase(victim);
+  }
+
+  auto host = std::make_unique<Host>();
+  host->name = name;
+  host->store = std::make_unique<MetricStore>(retention_);
+  return hosts_.emplace(name, std::move(host)).first->second.get();
+}
+
+bool Aggregator::reserve_metric(Host &host) {
+  size_t bytes = host.capacity * (sizeof(int64_t) + sizeof(double));
+  if (host.store->metric_count() >= limits_.max_metrics_per_host ||
+      ring_bytes_ + bytes > limits_.max_ring_bytes) {
+    ++dropped_metrics_;
+    return false;
+  }
+  ring_bytes_ += bytes;
+  host.ring_bytes += bytes;
+  return true;
+}
+
+const MetricStore *Aggregator::store(const std::string &host) const {
+  auto it = hosts_.find(host);
+  return it == hosts_.end() ? nullptr : it->second->store.get();
+}
+
+bool Aggregator::Connection::on_hello(const std::string &host_name,
+                                      uint32_t interval_ms) {
+  if (host || host_name.empty())
+    return false;
+  Host *found = owner->host_for(host_name);
+  if (!found) {
+    LOG_WARN("主机数达到上限且全部在线，拒绝主机 " + host_name);
+    return false;
+  }
+  Host &target = *found;
+  if (target.connection_fd != -1) {
+    // 旧连接的对端多半已经不在了（掉电、分区时不会有 FIN），以新连接为准
+    LOG_WARN("主机 " + host_name + " 重新连接，关闭旧连接");
+    owner->close_connection(target.connection_fd);
+  }
+  target.connection_fd = fd;
+  // 采样周期来自客户端：按下限计算容量，HELLO interval=1 不能让每个指标占用几十 MB
+  target.capacity = target.store->capacity_for(std::max<std::chrono::milliseconds>(
+      std::chrono::milliseconds(interval_ms), owner->limits_.min_interval));
+  idle_limit = std::max<std::chrono::milliseconds>(
+      MIN_IDLE, std::chrono::milliseconds(interval_ms) * IDLE_INTERVALS);
+  host = &target;
+  LOG_INFO("主机 " + host_name + " 已连接");
+  return true;
+}
+
+void Aggregator::Connection::on_define(uint64_t id, const std::string &name,
+                                       const std::string &label_key,
+                                       const std::string &label_value) {
+  // 远端 id 从 0 开始连续编号，重连的主机按名字找回原来的指标
+  MetricLabel label{label_key.empty() ? nullptr : label_key.c_str(), label_value};
+  MetricStore::MetricId local = host->store->find(name, label_value);
+  if (local == MetricStore::NOT_FOUND) {
+    if (owner->reserve_metric(*host)) {
+      local = host->store->intern(name, label, host->capacity);
+    } else if (!warned_limit) {
+      // 超出上限的指标在这个连接上一直丢弃，每个连接只报告一次
+      LOG_WARN("主机 " + host->name + " 的指标超出上限，丢弃 " + name + " 等新指标");
+      warned_limit = true;
+    }
+  }
+  if (ids.size() <= id)
+    ids.resize(id + 1, MetricStore::NOT_FOUND);
+  ids[id] = local;
+}
+
+void Aggregator::Connection::on_sample(uint64_t id, int64_t timestamp_ms,
+                                       double value) {
+  if (id < ids.size() && ids[id] != MetricStore::NOT_FOUND)
+    host->store->push(ids[id], timestamp_ms, value);
+}
+
+void Aggregator::print(std::ostream &out, size_t max_rows) {
+  auto now = std::chrono::steady_clock::now();
+  double elapsed = printed_at_ == std::chrono::steady_clock::time_point{}
+                       ? 0.0
+                       : std::chrono::duration<double>(now - printed_at_).count();
+  printed_at_ = now;
+
+  std::vector<Host *> rows;
+  rows.reserve(hosts_.size());
+  size_t connected = 0;
+  size_t metrics = 0;
+  size_t memory = 0;
+  double total_rate = 0.0;
+  for (auto &[name, host] : hosts_) {
+    rows.push_back(host.get());
+    connected += host->connection_fd != -1;
+    metrics += host->store->metric_count();
+    memory += host->store->memory_bytes();
+  }
+  std::sort(rows.begin(), rows.end(),
+            [](const Host *a, const Host *b) { return a->name < b->name; });
+
+  out << "汇聚端 :" << port_ << "  主机 " << connected << "/" << hosts_.size()
+      << " 在线, " << metrics << " 个指标, 已分配 " << memory / 1024 << " KB";
+  if (rejected_)
+    out << ", 拒绝 " << rejected_ << " 个连接";
+  if (dropped_metrics_)
+    out << ", 超出上限丢弃 " << dropped_metrics_ << " 个指标";
+  out << "\n";
+  // 每个汉字占 3 字节、2 列，setw 按字节计数，含汉字的列多留 1 字节/字
+  out << "  " << std::left << std::setw(HOST_WIDTH + 2) << "主机" << std::right
+      << std::setw(10) << "状态" << std::setw(10) << "指标" << std::setw(12) << "B/s"
+      << std::setw(11) << "帧" << std::setw(18) << "最后一帧(s)" << "\n";
+  size_t shown = 0;
+  for (Host *host : rows) {
+    double rate = elapsed > 0 ? (host->bytes - host->printed_bytes) / elapsed : 0.0;
+    host->printed_bytes = host->bytes;
+    total_rate += rate;
+    if (shown++ >= max_rows)
+      continue;
+    std::string name = host->name.size() > HOST_WIDTH - 1
+                           ? host->name.substr(0, HOST_WIDTH - 1)
+                           : host->name;
+    out << "  " << std::left << std::setw(HOST_WIDTH) << name << std::right
+        << std::setw(10) << (host->connection_fd != -1 ? "在线" : "离线") << std::setw(8)
+        << host->store->metric_count() << std::setw(12) << std::fixed
+        << std::setprecision(0) << rate << std::setw(10) << host->frames
+        << std::setw(14) << std::setprecision(1)
+        << (host->frames ? std::chrono::duration<double>(now - host->last_frame).count()
+                         : 0.0)
+        << "\n";
+  }
+  if (rows.size() > max_rows)
+    out << "  ... 另有 " << rows.size() - max_rows << " 台主机\n";
+  out << "  合计 " << std::fixed << std::setprecision(0) << total_rate << " B/s\n";
+}
@@ -0,0 +1,56 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> g_total{0};
+thread_local uint64_t t_count = 0;
+
+inline void *counted_alloc(std::size_t size) {
+  g_total.fetch_add(1, std::memory_order_relaxed);
+  ++t_count;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+// 对齐版本：std::pmr::new_delete_resource() 等走这条路径
+inline void *counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+  g_total.fetch_add(1, std::memory_order_relaxed);
+  ++t_count;
+  std::size_t alignment = static_cast<std::size_t>(align);
+  // aligned_alloc 要求大小是对齐值的整数倍
+  std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+  if (void *p = std::aligned_alloc(alignment, rounded ? rounded : alignment))
+    return p;
+  throw std::bad_alloc();
+}
+} // namespace
+
+uint64_t AllocCounter::total() {
+  return g_total.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocCounter::thread_count() { return t_count; }
+
+void *operator new(std::size_t size) { return counted_alloc(size); }
+void *operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void *operator new(std::size_t size, std::align_val_t align) {
+  return counted_aligned_alloc(size, align);
+}
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return counted_aligned_alloc(size, align);
+}
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
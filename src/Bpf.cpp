@@ -0,0 +1,285 @@
+#include "Bpf.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/btf.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+constexpr const char *VMLINUX_BTF = "/sys/kernel/btf/vmlinux";
+constexpr const char *POSSIBLE_CPUS = "/sys/devices/system/cpu/possible";
+constexpr size_t VERIFIER_LOG_BYTES = 64 * 1024;
+
+long sys_bpf(int cmd, bpf_attr &attr) {
+  return syscall(__NR_bpf, cmd, &attr, sizeof(attr));
+}
+
+uint64_t ptr_to_u64(const void *ptr) {
+  return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+}
+
+void copy_name(char (&dst)[BPF_OBJ_NAME_LEN], const char *name) {
+  if (name)
+    std::strncpy(dst, name, BPF_OBJ_NAME_LEN - 1);
+}
+
+bool read_file(const char *path, std::vector<char> &out) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return false;
+  out.clear();
+  char chunk[64 * 1024];
+  ssize_t n;
+  while ((n = read(fd, chunk, sizeof(chunk))) > 0)
+    out.insert(out.end(), chunk, chunk + n);
+  close(fd);
+  return n == 0;
+}
+
+// 类型记录（btf_type）之后附带的字节数，按种类区分
+size_t btf_extra_bytes(uint32_t info) {
+  uint32_t vlen = BTF_INFO_VLEN(info);
+  switch (BTF_INFO_KIND(info)) {
+  case BTF_KIND_INT:
+    return sizeof(uint32_t);
+  case BTF_KIND_ARRAY:
+    return sizeof(btf_array);
+  case BTF_KIND_STRUCT:
+  case BTF_KIND_UNION:
+    return vlen * sizeof(btf_member);
+  case BTF_KIND_ENUM:
+    return vlen * sizeof(btf_enum);
+  case BTF_KIND_FUNC_PROTO:
+    return vlen * sizeof(btf_param);
+  case BTF_KIND_VAR:
+    return sizeof(btf_var);
+  case BTF_KIND_DATASEC:
+    return vlen * sizeof(btf_var_secinfo);
+  case BTF_KIND_DECL_TAG:
+    return sizeof(btf_decl_tag);
+  case BTF_KIND_ENUM64:
+    return vlen * sizeof(btf_enum64);
+  default:
+    return 0;
+  }
+}
+} // namespace
+
+namespace bpf {
+
+Assembler::Label Assembler::new_label() {
+  labels_.push_back(-1);
+  return labels_.size() - 1;
+}
+
+void Assembler::bind(Label label) {
+  labels_[label] = static_cast<long>(insns_.size());
+}
+
+void Assembler::emit(uint8_t code, uint8_t dst, uint8_t src, int16_t off,
+                     int32_t imm) {
+  bpf_insn insn{};
+  insn.code = code;
+  insn.dst_reg = dst & 0x0f;
+  insn.src_reg = src & 0x0f;
+  insn.off = off;
+  insn.imm = imm;
+  insns_.push_back(insn);
+}
+
+void Assembler::jump_imm(uint8_t op, uint8_t dst, int32_t imm, Label target) {
+  fixups_.push_back({insns_.size(), target});
+  emit(BPF_JMP | op | BPF_K, dst, 0, 0, imm);
+}
+
+void Assembler::jump_reg(uint8_t op, uint8_t dst, uint8_t src, Label target) {
+  fixups_.push_back({insns_.size(), target});
+  emit(BPF_JMP | op | BPF_X, dst, src, 0, 0);
+}
+
+void Assembler::jump(Label target) {
+  fixups_.push_back({insns_.size(), target});
+  emit(BPF_JMP | BPF_JA, 0, 0, 0, 0);
+}
+
+void Assembler::load_map(uint8_t dst, int map_fd) {
+  // ld_imm64 占两条指令，第二条只携带高 32 位（这里为 0）
+  emit(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, map_fd);
+  emit(0, 0, 0, 0, 0);
+}
+
+bool Assembler::finish(std::vector<bpf_insn> &out) {
+  for (const Fixup &fixup : fixups_) {
+    long target = labels_[fixup.label];
+    if (target < 0)
+      return false;
+    // 跳转偏移相对下一条指令
+    insns_[fixup.insn].off =
+        static_cast<int16_t>(target - static_cast<long>(fixup.insn) - 1);
+  }
+  out = insns_;
+  return true;
+}
+
+int create_map(bpf_map_type type, uint32_t key_size, uint32_t value_size,
+               uint32_t max_entries, const char *name) {
+  bpf_attr attr{};
+  attr.map_type = type;
+  attr.key_size = key_size;
+  attr.value_size = value_size;
+  attr.max_entries = max_entries;
+  copy_name(attr.map_name, name);
+  return static_cast<int>(sys_bpf(BPF_MAP_CREATE, attr));
+}
+
+int load_raw_tracepoint(const std::vector<bpf_insn> &insns, const char *name,
+                        std::string &log) {
+  static const char license[] = "GPL";
+  bpf_attr attr{};
+  attr.prog_type = BPF_PROG_TYPE_RAW_TRACEPOINT;
+  attr.insns = ptr_to_u64(insns.data());
+  attr.insn_cnt = static_cast<uint32_t>(insns.size());
+  attr.license = ptr_to_u64(license);
+  copy_name(attr.prog_name, name);
+  int fd = static_cast<int>(sys_bpf(BPF_PROG_LOAD, attr));
+  if (fd >= 0 || errno == EPERM)
+    return fd;
+
+  // 失败时带上校验器日志重新加载一次，只为拿到错误原因
+  int saved = errno;
+  std::vector<char> buffer(VERIFIER_LOG_BYTES);
+  attr.log_buf = ptr_to_u64(buffer.data());
+  attr.log_size = static_cast<uint32_t>(buffer.size());
+  attr.log_level = 1;
+  fd = static_cast<int>(sys_bpf(BPF_PROG_LOAD, attr));
+  if (fd >= 0)
+    return fd;
+  log.assign(buffer.data(), strnlen(buffer.data(), buffer.size()));
+  errno = saved;
+  return -1;
+}
+
+int attach_raw_tracepoint(const char *tracepoint, int prog_fd) {
+  bpf_attr attr{};
+  attr.raw_tracepoint.name = ptr_to_u64(tracepoint);
+  attr.raw_tracepoint.prog_fd = static_cast<uint32_t>(prog_fd);
+  return static_cast<int>(sys_bpf(BPF_RAW_TRACEPOINT_OPEN, attr));
+}
+
+bool lookup(int map_fd, const void *key, void *value) {
+  bpf_attr attr{};
+  attr.map_fd = static_cast<uint32_t>(map_fd);
+  attr.key = ptr_to_u64(key);
+  attr.value = ptr_to_u64(value);
+  return sys_bpf(BPF_MAP_LOOKUP_ELEM, attr) == 0;
+}
+
+long read_all(int map_fd, bool remove, void *keys, uint32_t key_size,
+              void *values, uint32_t value_size, uint32_t capacity) {
+  // 批量游标对哈希表是桶下标（u32），对数组是键；8 字节足够本文件的 map
+  uint64_t in_batch = 0;
+  uint64_t out_batch = 0;
+  bool first = true;
+  uint32_t total = 0;
+  auto *key_out = static_cast<char *>(keys);
+  auto *value_out = static_cast<char *>(values);
+  int cmd = remove ? BPF_MAP_LOOKUP_AND_DELETE_BATCH : BPF_MAP_LOOKUP_BATCH;
+
+  while (total < capacity) {
+    bpf_attr attr{};
+    attr.batch.map_fd = static_cast<uint32_t>(map_fd);
+    attr.batch.in_batch = first ? 0 : ptr_to_u64(&in_batch);
+    attr.batch.out_batch = ptr_to_u64(&out_batch);
+    attr.batch.keys = ptr_to_u64(key_out + static_cast<size_t>(total) * key_size);
+    attr.batch.values =
+        ptr_to_u64(value_out + static_cast<size_t>(total) * value_size);
+    attr.batch.count = capacity - total;
+    long rc = sys_bpf(cmd, attr);
+    if (rc != 0 && errno != ENOENT)
+      return -1;
+    // ENOENT 表示已经到末尾，count 仍是这一批读到的个数
+    total += attr.batch.count;
+    if (rc != 0)
+      break;
+    in_batch = out_batch;
+    first = false;
+  }
+  return static_cast<long>(total);
+}
+
+int possible_cpus() {
+  // 形如 "0-3,8-11"：PERCPU map 按最大编号 + 1 个 CPU 排列
+  static const int count = [] {
+    std::vector<char> text;
+    if (!read_file(POSSIBLE_CPUS, text))
+      return 1;
+    text.push_back('\0');
+    int highest = 0;
+    for (const char *p = text.data(); *p;) {
+      if (*p < '0' || *p > '9') {
+        ++p; // '-' 和 ',' 只是分隔符，只需要最大的编号
+        continue;
+      }
+      char *end;
+      highest = std::max(highest, static_cast<int>(std::strtol(p, &end, 10)));
+      p = end;
+    }
+    return highest + 1;
+  }();
+  return count;
+}
+
+bool btf_member_offset(const char *struct_name, const char *member,
+                       uint32_t &offset) {
+  std::vector<char> data;
+  if (!read_file(VMLINUX_BTF, data) || data.size() < sizeof(btf_header))
+    return false;
+  btf_header header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != BTF_MAGIC ||
+      static_cast<size_t>(header.hdr_len) + header.type_off + header.type_len >
+          data.size() ||
+      static_cast<size_t>(header.hdr_len) + header.str_off + header.str_len >
+          data.size())
+    return false;
+
+  const char *types = data.data() + header.hdr_len + header.type_off;
+  const char *strings = data.data() + header.hdr_len + header.str_off;
+  auto name_is = [&](uint32_t name_off, const char *expected) {
+    return name_off < header.str_len &&
+           std::strncmp(strings + name_off, expected, header.str_len - name_off) ==
+               0;
+  };
+
+  size_t pos = 0;
+  while (pos + sizeof(btf_type) <= header.type_len) {
+    btf_type type;
+    std::memcpy(&type, types + pos, sizeof(type));
+    size_t extra = btf_extra_bytes(type.info);
+    if (pos + sizeof(btf_type) + extra > header.type_len)
+      return false;
+    if (BTF_INFO_KIND(type.info) == BTF_KIND_STRUCT &&
+        name_is(type.name_off, struct_name)) {
+      const char *members = types + pos + sizeof(btf_type);
+      for (uint32_t i = 0; i < BTF_INFO_VLEN(type.info); ++i) {
+        btf_member m;
+        std::memcpy(&m, members + i * sizeof(btf_member), sizeof(m));
+        if (!name_is(m.name_off, member))
+          continue;
+        uint32_t bits =
+            BTF_INFO_KFLAG(type.info) ? BTF_MEMBER_BIT_OFFSET(m.offset) : m.offset;
+        offset = bits / 8;
+        return true;
+      }
+      // 同名的结构体只有一个，成员不在最外层（匿名联合体里）时不支持
+      return false;
+    }
+    pos += sizeof(btf_type) + extra;
+  }
+  return false;
+}
+
+} // namespace bpf
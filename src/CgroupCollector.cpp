@@ -0,0 +1,486 @@
+#include "CgroupCollector.h"
+#include "Logger.h"
+#include "ParseCursor.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iomanip>
+#include <linux/magic.h>
+#include <numeric>
+#include <sys/inotify.h>
+#include <sys/resource.h>
+#include <sys/statfs.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+// getdents64 返回的目录项布局
+struct linux_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+constexpr const char *FILE_NAMES[] = {"cpu.stat", "memory.current",
+                                      "memory.stat", "io.stat"};
+constexpr size_t DENTS_BUF_SIZE = 32 * 1024;
+constexpr size_t EVENTS_BUF_SIZE = 64 * 1024;
+constexpr size_t READ_BUF_SIZE = 16 * 1024;
+constexpr uint32_t WATCH_MASK =
+    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+constexpr size_t PATH_WIDTH = 40;
+constexpr size_t FD_RESERVE = 256; // 留给进程其余部分（日志、socket、/proc）
+
+// 每个 cgroup 占 5 个 fd（目录和 4 个统计文件，inotify watch 不占 fd）。
+// 软限制由 main() 启动时提高（raise_fd_limit()），这里只读取，返回可以保持的 fd 数
+size_t fd_budget() {
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+    return 0;
+  return limit.rlim_cur > FD_RESERVE ? limit.rlim_cur - FD_RESERVE : 0;
+}
+
+std::string child_path(const std::string &parent, std::string_view name) {
+  std::string path = parent == "/" ? std::string() : parent;
+  path += '/';
+  path += name;
+  return path;
+}
+
+bool parse_value(std::string_view text, uint64_t &value) {
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return ec == std::errc();
+}
+
+// 过长的路径保留末尾（容器 ID 在最后）
+std::string display_path(std::string_view path) {
+  if (path.size() <= PATH_WIDTH)
+    return std::string(path);
+  return "..." + std::string(path.substr(path.size() - (PATH_WIDTH - 3)));
+}
+} // namespace
+
+std::string default_cgroup_root() {
+  for (const char *path : {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"}) {
+    struct statfs fs {};
+    if (statfs(path, &fs) == 0 && fs.f_type == CGROUP2_SUPER_MAGIC)
+      return path;
+  }
+  return {};
+}
+
+CgroupCollector::CgroupCollector(std::string cgroup_root)
+    : root_(std::move(cgroup_root)), events_(EVENTS_BUF_SIZE),
+      dents_(DENTS_BUF_SIZE), buffer_(READ_BUF_SIZE) {}
+
+CgroupCollector::~CgroupCollector() { close_hierarchy(); }
+
+void CgroupCollector::configure(const MonitorOptions &options) {
+  top_n_ = options.top_n;
+  if (!options.cgroup_root.empty() && options.cgroup_root != root_) {
+    close_hierarchy();
+    root_ = options.cgroup_root;
+  }
+}
+
+bool CgroupCollector::open_hierarchy() {
+  opened_ = true;
+  if (root_.empty())
+    return false;
+  int fd = open(root_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    LOG_ERROR("无法打开 cgroup 根目录 " + root_ + ": " + strerror(errno));
+    return false;
+  }
+  fd_budget_ = fd_budget();
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ < 0)
+    LOG_WARN(std::string("inotify 不可用，cgroup 层级变化需要重启才能发现: ") +
+             strerror(errno));
+
+  add_subtree("/", fd);
+  ++full_rescans_;
+  ++hierarchy_updates_;
+  LOG_INFO("cgroup v2: " + root_ + " 下共 " + std::to_string(groups_.size()) +
+           " 个 cgroup");
+  return true;
+}
+
+void CgroupCollector::close_group(Group &group) {
+  for (int fd : group.files) {
+    if (fd >= 0) {
+      close(fd);
+      --open_fds_;
+    }
+  }
+  if (group.dir_fd >= 0) {
+    close(group.dir_fd);
+    --open_fds_;
+  }
+}
+
+void CgroupCollector::close_hierarchy() {
+  for (Group &group : groups_)
+    close_group(group);
+  groups_.clear();
+  by_wd_.clear();
+  if (inotify_fd_ >= 0) {
+    close(inotify_fd_); // 同时移除所有 watch
+    inotify_fd_ = -1;
+  }
+  opened_ = false;
+  available_ = false;
+}
+
+void CgroupCollector::full_rescan() {
+  LOG_WARN("inotify 事件队列溢出，重新遍历 cgroup 层级");
+  close_hierarchy();
+  available_ = open_hierarchy();
+}
+
+bool CgroupCollector::reserve_fd() {
+  if (open_fds_ < fd_budget_) {
+    ++open_fds_;
+    return true;
+  }
+  if (!warned_fds_) {
+    warned_fds_ = true;
+    LOG_WARN("文件描述符不足 (可保持 " + std::to_string(fd_budget_) +
+             " 个)，其余 cgroup 的统计文件改为每次重新打开");
+  }
+  return false;
+}
+
+int CgroupCollector::open_in(const Group &group, const char *name, int flags) {
+  if (group.dir_fd >= 0)
+    return openat(group.dir_fd, name, flags | O_CLOEXEC);
+  // 目录 fd 不是持久的：按完整路径打开，path_ 的容量跨 tick 复用
+  path_.assign(root_);
+  if (group.path != "/")
+    path_ += group.path;
+  path_ += '/';
+  path_ += name;
+  return open(path_.c_str(), flags | O_CLOEXEC);
+}
+
+size_t CgroupCollector::add_group(std::string path, int dir_fd) {
+  Group group;
+  group.path = std::move(path);
+  if (inotify_fd_ >= 0) {
+    std::string full = group.path == "/" ? root_ : root_ + group.path;
+    group.wd = inotify_add_watch(inotify_fd_, full.c_str(), WATCH_MASK);
+    // 同一个目录的 watch 描述符相同：创建事件和遍历都发现了它
+    if (group.wd >= 0 && by_wd_.count(group.wd))
+      return SIZE_MAX;
+    if (group.wd < 0 && !warned_watches_) {
+      warned_watches_ = true;
+      LOG_WARN("inotify_add_watch " + full + " 失败 (" + strerror(errno) +
+               ")，该目录下新建的 cgroup 不会被发现，可调大 "
+               "fs.inotify.max_user_watches");
+    }
+  }
+  group.dir_fd = reserve_fd() ? dir_fd : FD_REOPEN;
+  for (int f = 0; f < FILE_COUNT; ++f) {
+    if (faccessat(dir_fd, FILE_NAMES[f], F_OK, 0) != 0) {
+      group.files[f] = FD_ABSENT; // 控制器没有启用
+    } else if (!reserve_fd()) {
+      group.files[f] = FD_REOPEN;
+    } else if ((group.files[f] = openat(dir_fd, FILE_NAMES[f],
+                                        O_RDONLY | O_CLOEXEC)) < 0) {
+      --open_fds_;
+      group.files[f] = errno == ENOENT ? FD_ABSENT : FD_REOPEN;
+    }
+  }
+  groups_.push_back(std::move(group));
+  size_t index = groups_.size() - 1;
+  if (groups_[index].wd >= 0)
+    by_wd_[groups_[index].wd] = index;
+  return index;
+}
+
+void CgroupCollector::add_subtree(std::string path, int dir_fd) {
+  size_t index = add_group(std::move(path), dir_fd);
+  if (index != SIZE_MAX)
+    walk(index, dir_fd);
+  // 重复的目录，或目录 fd 超出预算只在遍历期间使用
+  if (index == SIZE_MAX || groups_[index].dir_fd != dir_fd)
+    close(dir_fd);
+}
+
+void CgroupCollector::walk(size_t index, int dir_fd) {
+  // 递归会复用 dents_ 并扩大 groups_，先把子目录名取出来
+  std::string parent = groups_[index].path;
+  std::vector<std::string> children;
+  if (lseek(dir_fd, 0, SEEK_SET) < 0)
+    return;
+  while (true) {
+    long n = syscall(SYS_getdents64, dir_fd, dents_.data(), dents_.size());
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      LOG_ERROR("getdents64 " + root_ + parent + " 失败: " + strerror(errno));
+      break;
+    }
+    if (n == 0)
+      break;
+    for (long off = 0; off < n;) {
+      auto *d = reinterpret_cast<linux_dirent64 *>(dents_.data() + off);
+      off += d->d_reclen;
+      if (d->d_type != DT_DIR && d->d_type != DT_UNKNOWN)
+        continue;
+      if (std::strcmp(d->d_name, ".") == 0 || std::strcmp(d->d_name, "..") == 0)
+        continue;
+      children.emplace_back(d->d_name);
+    }
+  }
+
+  for (const std::string &name : children) {
+    int fd = openat(dir_fd, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+      continue; // 文件或已经删除的目录
+    add_subtree(child_path(parent, name), fd);
+  }
+}
+
+void CgroupCollector::remove_subtree(const std::string &path) {
+  auto inside = [&path](const Group &group) {
+    return group.path == path ||
+           (group.path.size() > path.size() &&
+            group.path.compare(0, path.size(), path) == 0 &&
+            group.path[path.size()] == '/');
+  };
+  size_t first = groups_.size();
+  for (size_t index = 0; index < groups_.size(); ++index) {
+    Group &group = groups_[index];
+    if (!inside(group))
+      continue;
+    first = std::min(first, index);
+    close_group(group);
+    if (group.wd >= 0) {
+      // 目录已删除时 watch 已经由内核移除，这里只对移走的目录有效
+      inotify_rm_watch(inotify_fd_, group.wd);
+      by_wd_.erase(group.wd);
+    }
+  }
+  groups_.erase(std::remove_if(groups_.begin() + static_cast<long>(first),
+                               groups_.end(), inside),
+                groups_.end());
+  // 只有被删除位置之后的下标移动了
+  for (size_t index = first; index < groups_.size(); ++index) {
+    if (groups_[index].wd >= 0)
+      by_wd_[groups_[index].wd] = index;
+  }
+}
+
+bool CgroupCollector::drain_events() {
+  if (inotify_fd_ < 0)
+    return true;
+  bool changed = false;
+  while (true) {
+    ssize_t n = read(inotify_fd_, events_.data(), events_.size());
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      break; // EAGAIN：没有更多事件
+    }
+    for (ssize_t off = 0; off < n;) {
+      auto *event = reinterpret_cast<inotify_event *>(events_.data() + off);
+      off += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      if (event->mask & IN_Q_OVERFLOW)
+        return false;
+      auto it = by_wd_.find(event->wd);
+      if (it == by_wd_.end())
+        continue;
+      size_t parent = it->second;
+
+      if (event->mask & IN_IGNORED) {
+        // 目录本身消失了（通常父目录的 IN_DELETE 已经处理过）
+        if (parent == 0)
+          return false;
+        remove_subtree(std::string(groups_[parent].path));
+        changed = true;
+        continue;
+      }
+      if (!(event->mask & IN_ISDIR) || event->len == 0)
+        continue;
+      std::string path = child_path(groups_[parent].path, event->name);
+      if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+        int fd = open_in(groups_[parent], event->name, O_RDONLY | O_DIRECTORY);
+        if (fd < 0)
+          continue; // 创建后立即删除
+        add_subtree(std::move(path), fd);
+        changed = true;
+      } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        remove_subtree(path);
+        changed = true;
+      }
+    }
+  }
+  if (changed)
+    ++hierarchy_updates_;
+  return true;
+}
+
+void CgroupCollector::do_collect() {
+  if (!opened_) {
+    available_ = open_hierarchy();
+  } else if (available_ && !drain_events()) {
+    full_rescan();
+  }
+}
+
+std::string_view CgroupCollector::read_file(Group &group, File file) {
+  int fd = group.files[file];
+  if (fd == FD_ABSENT)
+    return {};
+  bool reopen = fd == FD_REOPEN;
+  if (reopen) {
+    fd = open_in(group, FILE_NAMES[file], O_RDONLY);
+    if (fd < 0)
+      return {};
+  }
+  ssize_t n;
+  while ((n = pread(fd, buffer_.data(), buffer_.size(), 0)) ==
+         static_cast<ssize_t>(buffer_.size()))
+    buffer_.resize(buffer_.size() * 2); // 可能被截断，扩大后重读
+  if (reopen)
+    close(fd);
+  return n > 0 ? std::string_view(buffer_.data(), static_cast<size_t>(n))
+               : std::string_view();
+}
+
+void CgroupCollector::parse_group(Group &group, uint64_t *counters) {
+  std::string_view key;
+  uint64_t value = 0;
+
+  ParseCursor cpu(read_file(group, CPU_STAT));
+  while (cpu.next_token(key) && cpu.parse_u64(value)) {
+    if (key == "usage_usec")
+      counters[CPU_USAGE_USEC] = value;
+    else if (key == "user_usec")
+      counters[CPU_USER_USEC] = value;
+    else if (key == "system_usec")
+      counters[CPU_SYSTEM_USEC] = value;
+    else if (key == "throttled_usec")
+      counters[CPU_THROTTLED_USEC] = value;
+  }
+
+  ParseCursor current(read_file(group, MEMORY_CURRENT_FILE));
+  current.parse_u64(counters[MEMORY_CURRENT]);
+
+  ParseCursor memory(read_file(group, MEMORY_STAT));
+  while (memory.next_token(key) && memory.parse_u64(value)) {
+    if (key == "anon")
+      counters[MEMORY_ANON] = value;
+    else if (key == "file")
+      counters[MEMORY_FILE] = value;
+  }
+
+  // "8:0 rbytes=1 wbytes=2 rios=3 wios=4 dbytes=0 dios=0"，每个设备一行
+  ParseCursor io(read_file(group, IO_STAT));
+  std::string_view line;
+  while (io.next_line(line)) {
+    ParseCursor lc(line);
+    std::string_view token;
+    if (!lc.next_token(token))
+      continue;
+    while (lc.next_token(token)) {
+      size_t eq = token.find('=');
+      if (eq == std::string_view::npos || !parse_value(token.substr(eq + 1), value))
+        continue;
+      std::string_view name = token.substr(0, eq);
+      if (name == "rbytes")
+        counters[IO_READ_BYTES] += value;
+      else if (name == "wbytes")
+        counters[IO_WRITE_BYTES] += value;
+      else if (name == "rios")
+        counters[IO_READ_OPS] += value;
+      else if (name == "wios")
+        counters[IO_WRITE_OPS] += value;
+    }
+  }
+}
+
+void CgroupCollector::do_parse() {
+  table_.begin_rows();
+  for (Group &group : groups_)
+    parse_group(group, table_.row(group.path));
+  table_.end_rows();
+}
+
+void CgroupCollector::do_calculate() {
+  table_.compute_rates(sample_time());
+  top_.resize(table_.size());
+  std::iota(top_.begin(), top_.end(), size_t{0});
+  size_t n = std::min(top_n_, top_.size());
+  std::partial_sort(top_.begin(), top_.begin() + static_cast<long>(n), top_.end(),
+                    [this](size_t a, size_t b) {
+                      return table_.rates(a)[CPU_USAGE_USEC] >
+                             table_.rates(b)[CPU_USAGE_USEC];
+                    });
+  top_.resize(n);
+}
+
+void CgroupCollector::do_snapshot() {
+  snapshot_.publish([this](Snapshot &snap) {
+    snap.available = available_;
+    snap.cgroups.assign(table_);
+    snap.top = top_;
+    snap.hierarchy_updates = hierarchy_updates_;
+  });
+}
+
+void CgroupCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  const DeviceSnapshot &cgroups = snap->cgroups;
+  for (size_t slot = 0; slot < cgroups.size(); ++slot) {
+    MetricLabel cgroup{"cgroup", cgroups.names[slot]};
+    // usage_usec 每秒的增量 / 1e4 = 单核百分比
+    out.gauge("cgroup_cpu_percent", cgroup,
+              cgroups.rate(slot, CPU_USAGE_USEC) / 1e4);
+    out.gauge("cgroup_cpu_throttled_percent", cgroup,
+              cgroups.rate(slot, CPU_THROTTLED_USEC) / 1e4);
+    out.gauge("cgroup_memory_bytes", cgroup,
+              static_cast<double>(cgroups.counter(slot, MEMORY_CURRENT)));
+    out.gauge("cgroup_memory_anon_bytes", cgroup,
+              static_cast<double>(cgroups.counter(slot, MEMORY_ANON)));
+    out.gauge("cgroup_memory_file_bytes", cgroup,
+              static_cast<double>(cgroups.counter(slot, MEMORY_FILE)));
+    out.gauge("cgroup_io_read_bytes_per_second", cgroup,
+              cgroups.rate(slot, IO_READ_BYTES));
+    out.gauge("cgroup_io_write_bytes_per_second", cgroup,
+              cgroups.rate(slot, IO_WRITE_BYTES));
+  }
+}
+
+void CgroupCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  if (!snap->available) {
+    out << "cgroup: 未找到 cgroup v2 层级\n";
+    return;
+  }
+  const DeviceSnapshot &cgroups = snap->cgroups;
+  out << "cgroup v2 (" << cgroups.size() << " 个，按 CPU 排序):\n"
+      << std::fixed << std::setprecision(1);
+  for (size_t slot : snap->top) {
+    out << "  " << std::left << std::setw(static_cast<int>(PATH_WIDTH))
+        << display_path(cgroups.names[slot])
+        << std::right << " CPU " << std::setw(6)
+        << cgroups.rate(slot, CPU_USAGE_USEC) / 1e4 << "%  内存 "
+        << std::setw(8)
+        << static_cast<double>(cgroups.counter(slot, MEMORY_CURRENT)) /
+               (1024.0 * 1024.0)
+        << " MB  IO 读 " << cgroups.rate(slot, IO_READ_BYTES) / 1024.0
+        << " KB/s 写 " << cgroups.rate(slot, IO_WRITE_BYTES) / 1024.0
+        << " KB/s\n";
+  }
+}
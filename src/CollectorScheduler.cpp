@@ -0,0 +1,56 @@
+#include "CollectorScheduler.h"
+
+CollectorScheduler::CollectorScheduler(size_t jobs)
+    : pool_(jobs > 1 ? std::make_unique<ThreadPool>(jobs) : nullptr) {}
+
+bool CollectorScheduler::enable_io_uring() {
+  auto batch = std::make_unique<ProcFileBatch>();
+  if (!batch->init())
+    return false;
+  batch_ = std::move(batch);
+  return true;
+}
+
+void CollectorScheduler::run(const std::vector<Collector *> &collectors) {
+  using Clock = std::chrono::steady_clock;
+  durations_.assign(collectors.size(), Duration{});
+
+  auto run_one = [this, &collectors](size_t i) {
+    auto start = Clock::now();
+    collectors[i]->update(); // 模板方法
+    durations_[i] = Clock::now() - start;
+  };
+
+  std::pmr::memory_resource *memory =
+      arena_ ? static_cast<std::pmr::memory_resource *>(arena_)
+             : std::pmr::new_delete_resource();
+  for (Collector *collector : collectors)
+    collector->set_tick_memory(memory);
+
+  auto start = Clock::now();
+  if (batch_) {
+    for (Collector *collector : collectors)
+      collector->prefetch(*batch_);
+    batch_->submit();
+  }
+  if (pool_) {
+    for (size_t i = 0; i < collectors.size(); ++i) {
+      pool_->submit(pending_, memory, [&run_one, i] { run_one(i); });
+    }
+    pending_.wait();
+  } else {
+    for (size_t i = 0; i < collectors.size(); ++i) {
+      run_one(i);
+    }
+  }
+  wall_time_ = Clock::now() - start;
+
+  critical_path_ = Duration{};
+  critical_ = nullptr;
+  for (size_t i = 0; i < durations_.size(); ++i) {
+    if (!critical_ || durations_[i] > critical_path_) {
+      critical_path_ = durations_[i];
+      critical_ = collectors[i];
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#include "CollectorWarmup.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+CollectorWarmup::CollectorWarmup(EventLoop &loop) : loop_(loop) {}
+
+CollectorWarmup::~CollectorWarmup() {
+  if (thread_.joinable())
+    thread_.join();
+  if (efd_ != -1) {
+    loop_.remove(efd_);
+    close(efd_);
+  }
+}
+
+bool CollectorWarmup::start(std::vector<Collector *> collectors,
+                            DoneHandler done) {
+  efd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (efd_ == -1 || !loop_.add(efd_, EPOLLIN, [this](uint32_t) { on_done(); })) {
+    LOG_WARN(std::string("eventfd 失败: ") + strerror(errno) + "，首次采集改为同步");
+    if (efd_ != -1)
+      close(efd_);
+    efd_ = -1;
+    return false;
+  }
+
+  collectors_ = std::move(collectors);
+  done_ = std::move(done);
+  running_ = true;
+  thread_ = std::thread([this] {
+    for (Collector *collector : collectors_) {
+      // 调度器的 TickArena 每个 tick 在主线程上重置，后台采集不能用它
+      collector->set_tick_memory(std::pmr::new_delete_resource());
+      collector->update();
+    }
+    uint64_t one = 1;
+    while (write(efd_, &one, sizeof(one)) == -1 && errno == EINTR) {
+    }
+  });
+  return true;
+}
+
+void CollectorWarmup::on_done() {
+  uint64_t value;
+  while (read(efd_, &value, sizeof(value)) == -1 && errno == EINTR) {
+  }
+  thread_.join();
+  loop_.remove(efd_);
+  close(efd_);
+  efd_ = -1;
+  running_ = false;
+  if (done_)
+    done_(collectors_);
+}
+
+bool CollectorWarmup::pending(const Collector *collector) const {
+  return running_ &&
+         std::find(collectors_.begin(), collectors_.end(), collector) !=
+             collectors_.end();
+}
+
+void CollectorWarmup::filter(std::vector<Collector *> &due) const {
+  if (!running_)
+    return;
+  due.erase(std::remove_if(due.begin(), due.end(),
+                           [this](Collector *c) { return pending(c); }),
+            due.end());
+}
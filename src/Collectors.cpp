@@ -1,10 +1,17 @@
 #include "Collectors.h"
+#include "CgroupCollector.h"
+#include "NumaCollector.h"
+#include "PressureCollector.h"
 #include "CollectorFactory.h"
 #include "Logger.h"
+#include "ParseCursor.h"
 #include <algorithm>
+#include <charconv>
+#include <cstdio>
 #include <cstring>
 #include <iomanip>
-#include <iostream>
+#include <iterator>
+#include <unistd.h>
 
 // ========================================
 // 工厂模式：自动注册所有采集器
@@ -13,416 +20,947 @@
 REGISTER_COLLECTOR(SystemCollector);
 REGISTER_COLLECTOR(CPUCollector);
 REGISTER_COLLECTOR(MemoryCollector);
+REGISTER_COLLECTOR(NumaCollector);
 REGISTER_COLLECTOR(DiskCollector);
 REGISTER_COLLECTOR(NetworkCollector);
 REGISTER_COLLECTOR(ProcessCollector);
+REGISTER_COLLECTOR(CgroupCollector);
+REGISTER_COLLECTOR(PressureCollector);
+
+// ==================== 数据源路径 ====================
+namespace {
+std::string &default_proc_root_storage() {
+  static std::string root = DEFAULT_PROC_ROOT;
+  return root;
+}
+} // namespace
+
+const std::string &default_proc_root() { return default_proc_root_storage(); }
+
+void set_default_proc_root(std::string root) {
+  default_proc_root_storage() = std::move(root);
+}
+
+std::string proc_path(const std::string &root, const char *file) {
+  return root + "/" + file;
+}
 
 // ==================== 辅助函数 ====================
 namespace {
-std::string format_bytes(uint64_t bytes) {
-  std::ostringstream oss;
-  if (bytes >= 1024ULL * 1024 * 1024) {
-    oss << std::fixed << std::setprecision(2)
-        << (bytes / 1024.0 / 1024.0 / 1024.0) << " GB";
-  } else if (bytes >= 1024 * 1024) {
-    oss << std::fixed << std::setprecision(2) << (bytes / 1024.0 / 1024.0)
-        << " MB";
-  } else if (bytes >= 1024) {
-    oss << std::fixed << std::setprecision(2) << (bytes / 1024.0) << " KB";
-  } else {
-    oss << bytes << " B";
-  }
-  return oss.str();
+// 格式化后的大小，写在栈上的缓冲区里：print_result() 每帧每行都要格式化，
+// 不经过 ostringstream 和 std::string
+struct FormattedSize {
+  char text[32];
+  int len = 0;
+};
+
+std::ostream &operator<<(std::ostream &out, const FormattedSize &size) {
+  return out.write(size.text, size.len);
 }
 
-std::string format_kb(uint64_t kb) {
-  std::ostringstream oss;
-  if (kb >= 1024 * 1024) {
-    oss << std::fixed << std::setprecision(2) << (kb / 1024.0 / 1024.0)
-        << " GB";
-  } else if (kb >= 1024) {
-    oss << std::fixed << std::setprecision(2) << (kb / 1024.0) << " MB";
+FormattedSize format_scaled(uint64_t value, const char *const *units,
+                            size_t unit_count, const char *suffix) {
+  FormattedSize result;
+  size_t unit = 0;
+  double scaled = static_cast<double>(value);
+  while (unit + 1 < unit_count && scaled >= 1024.0) {
+    scaled /= 1024.0;
+    ++unit;
+  }
+  if (unit == 0) {
+    result.len = std::snprintf(result.text, sizeof(result.text), "%llu %s%s",
+                               static_cast<unsigned long long>(value),
+                               units[0], suffix);
   } else {
-    oss << kb << " KB";
+    result.len = std::snprintf(result.text, sizeof(result.text), "%.2f %s%s",
+                               scaled, units[unit], suffix);
   }
-  return oss.str();
+  return result;
+}
+
+constexpr const char *BYTE_UNITS[] = {"B", "KB", "MB", "GB"};
+constexpr const char *KB_UNITS[] = {"KB", "MB", "GB"};
+
+FormattedSize format_bytes(uint64_t bytes) {
+  return format_scaled(bytes, BYTE_UNITS, std::size(BYTE_UNITS), "");
+}
+
+FormattedSize format_rate(double bytes_per_second) {
+  return format_scaled(static_cast<uint64_t>(bytes_per_second), BYTE_UNITS,
+                       std::size(BYTE_UNITS), "/s");
+}
+
+FormattedSize format_kb(uint64_t kb) {
+  return format_scaled(kb, KB_UNITS, std::size(KB_UNITS), "");
 }
 } // namespace
 
 // ==================== CPUCollector ====================
+CPUCollector::CPUCollector(const std::string &proc_root)
+    : file_(proc_path(proc_root, CPU_FILE)) {}
+
+void CPUCollector::prefetch(ProcFileBatch &batch) { batch.add(file_); }
+
 void CPUCollector::do_collect() {
-  std::ifstream file(CPU_PATH);
-  if (!file.is_open()) {
-    LOG_ERROR("无法打开 " CPU_PATH);
-    return;
+  raw_data_ = file_.read();
+  if (raw_data_.empty()) {
+    LOG_ERROR("无法打开 " + file_.path());
   }
-  std::getline(file, raw_data_);
-  file.close();
 }
 
 void CPUCollector::do_parse() {
   if (raw_data_.empty())
     return;
 
-  // 保存之前的值
-  prev_idle_ = curr_idle_;
-  prev_total_ = curr_total_;
+  // 上一次的 curr_ 成为 prev_，交换不涉及分配
+  std::swap(prev_, curr_);
+
+  bool layout_changed = false;
+  size_t row = 0;
+  ParseCursor cur(raw_data_);
+  std::string_view line;
+
+  // cpu 汇总行和各核心行都在文件开头
+  while (cur.next_line(line) && line.substr(0, 3) == "cpu") {
+    ParseCursor lc(line);
+    std::string_view label;
+    lc.next_token(label);
+
+    int id = -1;
+    if (label.size() > 3)
+      std::from_chars(label.data() + 3, label.data() + label.size(), id);
+
+    if (row == curr_.size()) {
+      curr_.resize(row + 1);
+      core_ids_.resize(row + 1);
+      core_labels_.resize(row + 1);
+      layout_changed = true;
+    }
+    if (core_ids_[row] != id || core_labels_[row].empty()) {
+      core_ids_[row] = id;
+      core_labels_[row] = id < 0 ? "all" : std::to_string(id);
+      layout_changed = true;
+    }
 
-  std::stringstream ss(raw_data_);
-  std::string cpu_label;
-  unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
+    for (auto &field : curr_.fields) {
+      uint64_t value = 0;
+      lc.parse_u64(value);
+      field[row] = value;
+    }
+    ++row;
+  }
 
-  ss >> cpu_label >> user >> nice >> system >> idle >> iowait >> irq >>
-      softirq >> steal;
+  if (row != curr_.size()) {
+    curr_.resize(row);
+    core_ids_.resize(row);
+    core_labels_.resize(row);
+    layout_changed = true;
+  }
 
-  curr_idle_ = idle + iowait;
-  curr_total_ = user + nice + system + idle + iowait + irq + softirq + steal;
+  // 第一次采样或 CPU 热插拔：没有可比较的上一次数据，从 0 开始（开机以来的平均值）
+  if (layout_changed || prev_.size() != row) {
+    prev_.resize(row);
+    for (auto &field : prev_.fields) {
+      std::fill(field.begin(), field.end(), 0);
+    }
+  }
 }
 
 void CPUCollector::do_calculate() {
-  unsigned long long total_diff = curr_total_ - prev_total_;
-  unsigned long long idle_diff = curr_idle_ - prev_idle_;
-
-  if (total_diff > 0) {
-    usage_percent_ = 100.0 * (total_diff - idle_diff) / total_diff;
+  usage_.resize(curr_.size());
+  compute_cpu_usage(prev_, curr_, usage_);
+  if (usage_.size() > 0) {
+    usage_percent_ = usage_.total[0];
   }
 }
 
-void CPUCollector::print_result() const {
-  std::cout << "CPU 使用率: " << std::fixed << std::setprecision(1)
-            << usage_percent_ << "%" << std::endl;
+void CPUCollector::do_snapshot() {
+  // 向量赋值复用槽位里已有的容量，核心数不变时不分配
+  snapshot_.publish([this](Snapshot &snap) {
+    snap.core_ids = core_ids_;
+    snap.core_labels = core_labels_;
+    snap.usage = usage_;
+    snap.usage_percent = usage_percent_;
+  });
 }
 
-// ==================== MemoryCollector ====================
-void MemoryCollector::do_collect() {
-  std::ifstream file(MEMORY_PATH);
-  if (!file.is_open()) {
-    LOG_ERROR("无法打开 " MEMORY_PATH);
+double CPUCollector::get_usage() const {
+  auto snap = snapshot_.read();
+  return snap ? snap->usage_percent : 0.0;
+}
+
+void CPUCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
     return;
+  const CpuUsage &usage = snap->usage;
+  for (size_t row = 0; row < usage.size(); ++row) {
+    MetricLabel cpu{"cpu", snap->core_labels[row]};
+    out.gauge("cpu_usage_percent", cpu, usage.total[row]);
+    out.gauge("cpu_user_percent", cpu, usage.user[row]);
+    out.gauge("cpu_system_percent", cpu, usage.system[row]);
+    out.gauge("cpu_iowait_percent", cpu, usage.iowait[row]);
+    out.gauge("cpu_steal_percent", cpu, usage.steal[row]);
   }
-
-  std::ostringstream oss;
-  oss << file.rdbuf();
-  raw_data_ = oss.str();
-  file.close();
 }
 
-void MemoryCollector::do_parse() {
-  std::istringstream iss(raw_data_);
-  std::string line;
+void CPUCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  const CpuUsage &usage = snap->usage;
+  out << "CPU 使用率: " << std::fixed << std::setprecision(1)
+      << snap->usage_percent << "%";
+  if (usage.size() > 0) {
+    out << " (用户 " << usage.user[0] << "%, 系统 " << usage.system[0]
+        << "%, iowait " << usage.iowait[0] << "%, steal " << usage.steal[0]
+        << "%)";
+  }
+  out << '\n';
+
+  // 各核心，每行 4 个
+  constexpr size_t PER_LINE = 4;
+  for (size_t row = 1; row < usage.size(); ++row) {
+    out << "  cpu" << std::left << std::setw(4) << snap->core_ids[row]
+        << std::right << std::setw(6) << usage.total[row] << "%";
+    if (row % PER_LINE == 0 || row + 1 == usage.size())
+      out << '\n';
+  }
+}
 
-  while (std::getline(iss, line)) {
-    std::stringstream ss(line);
-    std::string key;
-    uint64_t value;
-    std::string unit;
+// ==================== MemoryCollector ====================
+MemoryCollector::MemoryCollector(const std::string &proc_root)
+    : file_(proc_path(proc_root, MEMORY_FILE)) {}
 
-    ss >> key >> value >> unit;
+void MemoryCollector::prefetch(ProcFileBatch &batch) { batch.add(file_); }
 
-    if (key == "MemTotal:")
-      total_kb_ = value;
-    else if (key == "MemFree:")
-      free_kb_ = value;
-    else if (key == "MemAvailable:")
-      available_kb_ = value;
-    else if (key == "Buffers:")
-      buffers_kb_ = value;
-    else if (key == "Cached:")
-      cached_kb_ = value;
+void MemoryCollector::do_collect() {
+  raw_data_ = file_.read();
+  if (raw_data_.empty()) {
+    LOG_ERROR("无法打开 " + file_.path());
   }
 }
 
+void MemoryCollector::do_parse() { meminfo::parse(raw_data_, fields_); }
+
 void MemoryCollector::do_calculate() {
-  used_kb_ = total_kb_ - available_kb_;
-  if (total_kb_ > 0) {
-    usage_percent_ = 100.0 * used_kb_ / total_kb_;
+  uint64_t total = fields_[meminfo::MEM_TOTAL];
+  used_kb_ = total - fields_[meminfo::MEM_AVAILABLE];
+  if (total > 0) {
+    usage_percent_ = 100.0 * used_kb_ / total;
   }
 }
 
-void MemoryCollector::print_result() const {
-  std::cout << "内存信息:" << std::endl;
-  std::cout << "  总内存:   " << format_kb(total_kb_) << std::endl;
-  std::cout << "  已使用:   " << format_kb(used_kb_) << std::endl;
-  std::cout << "  可用:     " << format_kb(available_kb_) << std::endl;
-  std::cout << "  使用率:   " << std::fixed << std::setprecision(1)
-            << usage_percent_ << "%" << std::endl;
+void MemoryCollector::do_snapshot() {
+  snapshot_.publish([this](Snapshot &snap) {
+    snap.total_kb = fields_[meminfo::MEM_TOTAL];
+    snap.free_kb = fields_[meminfo::MEM_FREE];
+    snap.available_kb = fields_[meminfo::MEM_AVAILABLE];
+    snap.buffers_kb = fields_[meminfo::BUFFERS];
+    snap.cached_kb = fields_[meminfo::CACHED];
+    snap.used_kb = used_kb_;
+    snap.usage_percent = usage_percent_;
+    std::copy(std::begin(fields_), std::end(fields_), snap.fields);
+  });
 }
 
-// ==================== DiskCollector ====================
-void DiskCollector::do_collect() {
-  std::ifstream file(DISK_PATH);
-  if (!file.is_open()) {
-    LOG_ERROR("无法打开 " DISK_PATH);
+double MemoryCollector::get_usage() const {
+  auto snap = snapshot_.read();
+  return snap ? snap->usage_percent : 0.0;
+}
+
+void MemoryCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
     return;
-  }
+  out.gauge("memory_total_kb", static_cast<double>(snap->total_kb));
+  out.gauge("memory_used_kb", static_cast<double>(snap->used_kb));
+  out.gauge("memory_available_kb", static_cast<double>(snap->available_kb));
+  out.gauge("memory_free_kb", static_cast<double>(snap->free_kb));
+  out.gauge("memory_buffers_kb", static_cast<double>(snap->buffers_kb));
+  out.gauge("memory_cached_kb", static_cast<double>(snap->cached_kb));
+  out.gauge("memory_usage_percent", snap->usage_percent);
+
+  const uint64_t *mem = snap->fields;
+  out.gauge("memory_hugepages_total", static_cast<double>(mem[meminfo::HUGEPAGES_TOTAL]));
+  out.gauge("memory_hugepages_free", static_cast<double>(mem[meminfo::HUGEPAGES_FREE]));
+  out.gauge("memory_hugepages_reserved", static_cast<double>(mem[meminfo::HUGEPAGES_RSVD]));
+  out.gauge("memory_hugepages_surplus", static_cast<double>(mem[meminfo::HUGEPAGES_SURP]));
+  out.gauge("memory_hugepage_size_kb", static_cast<double>(mem[meminfo::HUGEPAGE_SIZE]));
+  out.gauge("memory_anon_hugepages_kb", static_cast<double>(mem[meminfo::ANON_HUGE_PAGES]));
+  out.gauge("memory_slab_kb", static_cast<double>(mem[meminfo::SLAB]));
+  out.gauge("memory_page_tables_kb", static_cast<double>(mem[meminfo::PAGE_TABLES]));
+  out.gauge("memory_dirty_kb", static_cast<double>(mem[meminfo::DIRTY]));
+  out.gauge("memory_committed_as_kb", static_cast<double>(mem[meminfo::COMMITTED_AS]));
+}
 
-  std::ostringstream oss;
-  oss << file.rdbuf();
-  raw_data_ = oss.str();
-  file.close();
+void MemoryCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  out << "内存信息:\n";
+  out << "  总内存:   " << format_kb(snap->total_kb) << '\n';
+  out << "  已使用:   " << format_kb(snap->used_kb) << '\n';
+  out << "  可用:     " << format_kb(snap->available_kb) << '\n';
+  out << "  使用率:   " << std::fixed << std::setprecision(1)
+      << snap->usage_percent << "%\n";
+  const uint64_t *mem = snap->fields;
+  out << "  大页:     总 " << mem[meminfo::HUGEPAGES_TOTAL] << "  空闲 "
+      << mem[meminfo::HUGEPAGES_FREE] << "  预留 " << mem[meminfo::HUGEPAGES_RSVD]
+      << "  超额 " << mem[meminfo::HUGEPAGES_SURP] << "  (每页 "
+      << format_kb(mem[meminfo::HUGEPAGE_SIZE]) << ")  透明大页 "
+      << format_kb(mem[meminfo::ANON_HUGE_PAGES]) << '\n';
 }
 
-void DiskCollector::do_parse() {
-  disks_.clear();
-  std::istringstream iss(raw_data_);
-  std::string line;
+// ==================== DiskCollector ====================
+DiskCollector::DiskCollector(const std::string &proc_root)
+    : file_(proc_path(proc_root, DISK_FILE)) {}
 
-  while (std::getline(iss, line)) {
-    std::stringstream ss(line);
-    int major, minor;
-    std::string name;
-    uint64_t reads_completed, reads_merged, sectors_read, time_reading;
-    uint64_t writes_completed, writes_merged, sectors_written, time_writing;
+void DiskCollector::prefetch(ProcFileBatch &batch) { batch.add(file_); }
 
-    ss >> major >> minor >> name >> reads_completed >> reads_merged >>
-        sectors_read >> time_reading >> writes_completed >> writes_merged >>
-        sectors_written >> time_writing;
+void DiskCollector::do_collect() {
+  raw_data_ = file_.read();
+  if (raw_data_.empty()) {
+    LOG_ERROR("无法打开 " + file_.path());
+  }
+}
+
+void DiskCollector::do_parse() {
+  // 设备顺序不变时只与原槽位比较一次名字，不分配
+  disks_.begin_rows();
+  ParseCursor cur(raw_data_);
+  std::string_view line;
+
+  while (cur.next_line(line)) {
+    ParseCursor lc(line);
+    std::string_view name;
+    uint64_t reads_completed = 0, reads_merged = 0, sectors_read = 0;
+    uint64_t time_reading = 0, writes_completed = 0, writes_merged = 0;
+    uint64_t sectors_written = 0;
+
+    if (!lc.skip_tokens(2) || !lc.next_token(name))
+      continue;
+    lc.parse_u64(reads_completed) && lc.parse_u64(reads_merged) &&
+        lc.parse_u64(sectors_read) && lc.parse_u64(time_reading) &&
+        lc.parse_u64(writes_completed) && lc.parse_u64(writes_merged) &&
+        lc.parse_u64(sectors_written);
 
     // 只记录主要磁盘设备
-    if (name.find("loop") == std::string::npos &&
-        (name.find("sd") != std::string::npos ||
-         name.find("vd") != std::string::npos ||
-         name.find("nvme") != std::string::npos)) {
+    if (name.find("loop") == std::string_view::npos &&
+        (name.find("sd") != std::string_view::npos ||
+         name.find("vd") != std::string_view::npos ||
+         name.find("nvme") != std::string_view::npos)) {
 
       bool is_partition = false;
       if (name.size() > 2) {
         char last = name.back();
-        if (isdigit(last) && name.find("nvme") == std::string::npos) {
+        if (isdigit(last) && name.find("nvme") == std::string_view::npos) {
           is_partition = true;
         }
-        if (name.find("nvme") != std::string::npos &&
-            name.find("p") != std::string::npos) {
+        if (name.find("nvme") != std::string_view::npos &&
+            name.find("p") != std::string_view::npos) {
           is_partition = true;
         }
       }
 
-      if (!is_partition || (name.find("nvme") != std::string::npos &&
-                            name.find("p") == std::string::npos)) {
-        DiskStats stats;
-        stats.name = name;
-        stats.reads_completed = reads_completed;
-        stats.writes_completed = writes_completed;
-        stats.sectors_read = sectors_read;
-        stats.sectors_written = sectors_written;
-        disks_.push_back(stats);
+      if (!is_partition || (name.find("nvme") != std::string_view::npos &&
+                            name.find("p") == std::string_view::npos)) {
+        uint64_t *counters = disks_.row(name);
+        counters[READS_COMPLETED] = reads_completed;
+        counters[WRITES_COMPLETED] = writes_completed;
+        counters[SECTORS_READ] = sectors_read;
+        counters[SECTORS_WRITTEN] = sectors_written;
       }
     }
   }
+  disks_.end_rows();
+}
+
+void DiskCollector::do_calculate() {
+  disks_.compute_rates(sample_time());
+}
+
+void DiskCollector::do_snapshot() {
+  snapshot_.publish([this](Snapshot &snap) { snap.disks.assign(disks_); });
 }
 
-void DiskCollector::print_result() const {
-  std::cout << "磁盘 I/O 统计:" << std::endl;
-  for (const auto &disk : disks_) {
-    std::cout << "  " << disk.name << ":" << std::endl;
-    std::cout << "    读取次数: " << disk.reads_completed << std::endl;
-    std::cout << "    写入次数: " << disk.writes_completed << std::endl;
-    std::cout << "    读取扇区: " << disk.sectors_read << std::endl;
-    std::cout << "    写入扇区: " << disk.sectors_written << std::endl;
+void DiskCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  const DeviceSnapshot &disks = snap->disks;
+  for (size_t slot = 0; slot < disks.size(); ++slot) {
+    MetricLabel device{"device", disks.names[slot]};
+    out.counter("disk_reads_completed", device,
+                static_cast<double>(disks.counter(slot, READS_COMPLETED)));
+    out.counter("disk_writes_completed", device,
+                static_cast<double>(disks.counter(slot, WRITES_COMPLETED)));
+    out.counter("disk_sectors_read", device,
+                static_cast<double>(disks.counter(slot, SECTORS_READ)));
+    out.counter("disk_sectors_written", device,
+                static_cast<double>(disks.counter(slot, SECTORS_WRITTEN)));
+    out.gauge("disk_read_iops", device, disks.rate(slot, READS_COMPLETED));
+    out.gauge("disk_write_iops", device, disks.rate(slot, WRITES_COMPLETED));
+    out.gauge("disk_read_bytes_per_second", device,
+              disks.rate(slot, SECTORS_READ) * SECTOR_BYTES);
+    out.gauge("disk_write_bytes_per_second", device,
+              disks.rate(slot, SECTORS_WRITTEN) * SECTOR_BYTES);
   }
 }
 
-// ==================== NetworkCollector ====================
-void NetworkCollector::do_collect() {
-  std::ifstream file(NETWORK_PATH);
-  if (!file.is_open()) {
-    LOG_ERROR("无法打开 " NETWORK_PATH);
+void DiskCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
     return;
+  const DeviceSnapshot &disks = snap->disks;
+  out << "磁盘 I/O 统计:\n" << std::fixed << std::setprecision(1);
+  for (size_t slot = 0; slot < disks.size(); ++slot) {
+    out << "  " << disks.names[slot] << ":\n";
+    out << "    读取: " << disks.rate(slot, READS_COMPLETED) << " IOPS, "
+        << format_rate(disks.rate(slot, SECTORS_READ) * SECTOR_BYTES)
+        << " (累计 " << disks.counter(slot, READS_COMPLETED) << " 次)\n";
+    out << "    写入: " << disks.rate(slot, WRITES_COMPLETED) << " IOPS, "
+        << format_rate(disks.rate(slot, SECTORS_WRITTEN) * SECTOR_BYTES)
+        << " (累计 " << disks.counter(slot, WRITES_COMPLETED) << " 次)\n";
   }
+}
 
-  std::ostringstream oss;
-  oss << file.rdbuf();
-  raw_data_ = oss.str();
-  file.close();
+// ==================== NetworkCollector ====================
+NetworkCollector::NetworkCollector(const std::string &proc_root)
+    : file_(proc_path(proc_root, NETWORK_FILE)) {}
+
+void NetworkCollector::prefetch(ProcFileBatch &batch) { batch.add(file_); }
+
+void NetworkCollector::do_collect() {
+  raw_data_ = file_.read();
+  if (raw_data_.empty()) {
+    LOG_ERROR("无法打开 " + file_.path());
+  }
 }
 
 void NetworkCollector::do_parse() {
-  interfaces_.clear();
-  std::istringstream iss(raw_data_);
-  std::string line;
+  interfaces_.begin_rows();
+  ParseCursor cur(raw_data_);
+  std::string_view line;
   int line_num = 0;
 
-  while (std::getline(iss, line)) {
+  while (cur.next_line(line)) {
     line_num++;
     if (line_num <= 2)
       continue; // 跳过头部
 
     size_t colon_pos = line.find(':');
-    if (colon_pos == std::string::npos)
+    if (colon_pos == std::string_view::npos)
       continue;
 
-    std::string iface_name = line.substr(0, colon_pos);
-    iface_name.erase(0, iface_name.find_first_not_of(" \t"));
+    ParseCursor name_cur(line.substr(0, colon_pos));
+    std::string_view iface_name;
+    name_cur.next_token(iface_name);
 
-    std::string stats_str = line.substr(colon_pos + 1);
-    std::stringstream ss(stats_str);
+    uint64_t *counters = interfaces_.row(iface_name);
+    ParseCursor lc(line.substr(colon_pos + 1));
+    lc.parse_u64(counters[RX_BYTES]) && lc.parse_u64(counters[RX_PACKETS]) &&
+        lc.skip_tokens(6) && lc.parse_u64(counters[TX_BYTES]) &&
+        lc.parse_u64(counters[TX_PACKETS]);
+  }
+  interfaces_.end_rows();
+}
 
-    InterfaceStats stats;
-    stats.name = iface_name;
+void NetworkCollector::do_calculate() {
+  interfaces_.compute_rates(sample_time());
+}
 
-    uint64_t dummy;
-    ss >> stats.rx_bytes >> stats.rx_packets >> dummy >> dummy >> dummy >>
-        dummy >> dummy >> dummy;
-    ss >> stats.tx_bytes >> stats.tx_packets;
+void NetworkCollector::do_snapshot() {
+  snapshot_.publish(
+      [this](Snapshot &snap) { snap.interfaces.assign(interfaces_); });
+}
 
-    interfaces_.push_back(stats);
+void NetworkCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  const DeviceSnapshot &ifaces = snap->interfaces;
+  for (size_t slot = 0; slot < ifaces.size(); ++slot) {
+    MetricLabel name{"interface", ifaces.names[slot]};
+    out.counter("net_rx_bytes", name,
+                static_cast<double>(ifaces.counter(slot, RX_BYTES)));
+    out.counter("net_tx_bytes", name,
+                static_cast<double>(ifaces.counter(slot, TX_BYTES)));
+    out.counter("net_rx_packets", name,
+                static_cast<double>(ifaces.counter(slot, RX_PACKETS)));
+    out.counter("net_tx_packets", name,
+                static_cast<double>(ifaces.counter(slot, TX_PACKETS)));
+    out.gauge("net_rx_bytes_per_second", name, ifaces.rate(slot, RX_BYTES));
+    out.gauge("net_tx_bytes_per_second", name, ifaces.rate(slot, TX_BYTES));
+    out.gauge("net_rx_packets_per_second", name, ifaces.rate(slot, RX_PACKETS));
+    out.gauge("net_tx_packets_per_second", name, ifaces.rate(slot, TX_PACKETS));
   }
 }
 
-void NetworkCollector::print_result() const {
-  std::cout << "网络接口统计:" << std::endl;
-  for (const auto &iface : interfaces_) {
-    std::cout << "  " << iface.name << ":" << std::endl;
-    std::cout << "    接收: " << format_bytes(iface.rx_bytes) << " ("
-              << iface.rx_packets << " 包)" << std::endl;
-    std::cout << "    发送: " << format_bytes(iface.tx_bytes) << " ("
-              << iface.tx_packets << " 包)" << std::endl;
+void NetworkCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  const DeviceSnapshot &ifaces = snap->interfaces;
+  out << "网络接口统计:\n" << std::fixed << std::setprecision(1);
+  for (size_t slot = 0; slot < ifaces.size(); ++slot) {
+    out << "  " << ifaces.names[slot] << ":\n";
+    out << "    接收: " << format_rate(ifaces.rate(slot, RX_BYTES)) << ", "
+        << ifaces.rate(slot, RX_PACKETS) << " 包/s (累计 "
+        << format_bytes(ifaces.counter(slot, RX_BYTES)) << ")\n";
+    out << "    发送: " << format_rate(ifaces.rate(slot, TX_BYTES)) << ", "
+        << ifaces.rate(slot, TX_PACKETS) << " 包/s (累计 "
+        << format_bytes(ifaces.counter(slot, TX_BYTES)) << ")\n";
   }
 }
 
 // ==================== ProcessCollector ====================
+ProcessCollector::ProcessCollector(const std::string &proc_root)
+    : scanner_(proc_root), shards_(1) {}
+
+void ProcessCollector::configure(const MonitorOptions &options) {
+  top_n_ = options.top_n;
+  thread_top_ = options.thread_top;
+  set_scan_threads(options.scan_threads);
+  if (options.io_uring && !set_io_uring(true))
+    LOG_WARN("内核不支持 io_uring 直接描述符，进程扫描使用 openat/read");
+}
+
+void ProcessCollector::set_scan_threads(size_t threads) {
+  threads = std::max<size_t>(threads, 1);
+  if (threads == shards_.size())
+    return;
+  shards_.resize(threads);
+  // 调用线程负责第 0 个分片，其余分片交给线程池
+  pool_ = threads > 1 ? std::make_unique<ThreadPool>(threads - 1) : nullptr;
+  if (io_uring_)
+    set_io_uring(true); // 新分片也需要读取器
+}
+
+void ProcessCollector::set_sample_stride(size_t stride) {
+  stride_ = std::max<size_t>(stride, 1);
+  phase_ = 0;
+}
+
+bool ProcessCollector::set_io_uring(bool enable) {
+  io_uring_ = enable;
+  for (auto &shard : shards_) {
+    if (!enable) {
+      shard.batch.reset();
+    } else if (!shard.batch) {
+      // io_uring 环只能在一个线程上使用：每个分片一个
+      auto reader = std::make_unique<StatBatchReader>();
+      if (!reader->init()) {
+        set_io_uring(false);
+        return false;
+      }
+      shard.batch = std::move(reader);
+    }
+  }
+  return true;
+}
+
 void ProcessCollector::do_collect() {
-  // 进程采集直接在 parse 中完成，因为需要遍历目录
-  raw_data_.clear();
+  // 没有单一的原始文本：采集阶段只枚举 PID，stat 在 parse 阶段逐个读取
+  raw_data_ = {};
+  if (!list_pids(pids_)) {
+    LOG_ERROR("无法打开 " + scanner_.root());
+  }
 }
 
-void ProcessCollector::do_parse() {
-  DIR *dir = opendir(PROC_PATH);
-  if (!dir) {
-    LOG_ERROR("无法打开 " PROC_PATH);
+bool ProcessCollector::list_pids(std::vector<int> &pids) {
+  return scanner_.list_pids(pids);
+}
+
+void ProcessCollector::scan_shard(size_t begin, size_t end,
+                                  ScanShard &shard) const {
+  shard.stats.clear();
+  const std::vector<int> &pids = *targets_;
+  if (shard.batch) {
+    shard.batch->read(scanner_, pids.data() + begin, end - begin, shard.stats);
     return;
   }
+  ProcStat stat;
+  for (size_t i = begin; i < end; ++i) {
+    if (scanner_.read_stat(pids[i], stat)) // 失败说明进程已退出
+      shard.stats.push_back(stat);
+  }
+}
+
+void ProcessCollector::merge_sample(const ProcStat &stat) {
+  ProcessKey key{stat.pid, stat.starttime};
+  auto it = index_.find(key);
+  size_t slot;
+  if (it != index_.end()) {
+    slot = it->second;
+  } else {
+    // 新进程：优先复用已退出进程的槽位
+    if (!free_slots_.empty()) {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    } else {
+      slot = processes_.size();
+      processes_.emplace_back();
+    }
+    index_.emplace(key, slot);
+    ProcessInfo &info = processes_[slot];
+    info.pid = stat.pid;
+    info.starttime = stat.starttime;
+    info.has_prev = false;
+  }
+
+  ProcessInfo &info = processes_[slot];
+  info.name.assign(stat.comm, stat.comm_len);
+  info.state = stat.state;
+  info.vsize = stat.vsize;
+  info.rss = stat.rss;
+  info.utime = stat.utime;
+  info.stime = stat.stime;
+  info.generation = generation_;
+}
+
+void ProcessCollector::do_parse() {
+  scan_time_ = std::chrono::steady_clock::now();
+
+  // 抽样模式：本轮只读取 pid % stride_ == phase_ 的进程
+  targets_ = &pids_;
+  if (stride_ > 1) {
+    phase_ = (phase_ + 1) % stride_;
+    sampled_.clear();
+    for (int pid : pids_) {
+      if (static_cast<size_t>(pid) % stride_ == phase_)
+        sampled_.push_back(pid);
+    }
+    targets_ = &sampled_;
+  }
+
+  // 读取和解析 stat 可以并行：按 PID 列表连续切分，分片数等于线程数
+  size_t count = targets_->size();
+  size_t shard_count = shards_.size();
+  size_t per_shard = (count + shard_count - 1) / shard_count;
+  auto shard_begin = [&](size_t s) { return std::min(s * per_shard, count); };
+
+  // 分片任务从本 tick 的 arena 分配
+  for (size_t s = 1; s < shard_count; ++s) {
+    pool_->submit(shard_tasks_, tick_memory(), [this, s, &shard_begin] {
+      uint64_t allocs_before = AllocCounter::thread_count();
+      scan_shard(shard_begin(s), shard_begin(s + 1), shards_[s]);
+      add_worker_allocations(AllocCounter::thread_count() - allocs_before);
+    });
+  }
+  scan_shard(shard_begin(0), shard_begin(1), shards_[0]);
+  shard_tasks_.wait();
+
+  // 合并到进程表在调用线程上完成，进程表不需要加锁
+  ++generation_;
+  for (const auto &shard : shards_) {
+    for (const auto &stat : shard.stats) {
+      merge_sample(stat);
+    }
+  }
+  if (thread_top_ > 0)
+    scan_threads();
+}
+
+void ProcessCollector::scan_threads() {
+  // 只枚举上一轮 Top N 的进程，开销与主机上的线程总数无关
+  prev_threads_.swap(threads_);
+  threads_.clear();
+  prev_thread_scan_time_ = thread_scan_time_;
+  thread_scan_time_ = scan_time_;
+  ProcStat stat;
+  for (int pid : drill_pids_) {
+    if (!scanner_.list_tasks(pid, tids_))
+      continue; // 进程已退出
+    for (int tid : tids_) {
+      if (!scanner_.read_task_stat(pid, tid, stat))
+        continue;
+      ThreadSample &sample = threads_.emplace_back();
+      sample.pid = pid;
+      sample.tid = tid;
+      sample.starttime = stat.starttime;
+      sample.cpu_ticks = stat.utime + stat.stime;
+      sample.name_len = static_cast<uint8_t>(
+          std::min<size_t>(stat.comm_len, sizeof(sample.name)));
+      std::memcpy(sample.name, stat.comm, sample.name_len);
+    }
+  }
+  std::sort(threads_.begin(), threads_.end(),
+            [](const ThreadSample &a, const ThreadSample &b) {
+              return a.pid != b.pid ? a.pid < b.pid : a.tid < b.tid;
+            });
+}
+
+void ProcessCollector::calculate_threads() {
+  static const double clock_ticks = static_cast<double>(sysconf(_SC_CLK_TCK));
+  auto before = [](const ThreadSample &a, const ThreadSample &b) {
+    return a.pid != b.pid ? a.pid < b.pid : a.tid < b.tid;
+  };
+
+  // 两轮样本都按 (pid, tid) 排序：归并一遍即可找到上一轮的同一线程
+  double elapsed =
+      std::chrono::duration<double>(thread_scan_time_ - prev_thread_scan_time_)
+          .count();
+  size_t j = 0;
+  for (ThreadSample &sample : threads_) {
+    while (j < prev_threads_.size() && before(prev_threads_[j], sample))
+      ++j;
+    sample.cpu_percent = 0.0;
+    if (j < prev_threads_.size() && prev_threads_[j].pid == sample.pid &&
+        prev_threads_[j].tid == sample.tid &&
+        prev_threads_[j].starttime == sample.starttime && elapsed > 0 &&
+        sample.cpu_ticks >= prev_threads_[j].cpu_ticks) {
+      sample.cpu_percent = 100.0 *
+                           (sample.cpu_ticks - prev_threads_[j].cpu_ticks) /
+                           clock_ticks / elapsed;
+    }
+  }
+
+  // 每个 Top N 进程取 CPU 最高的 thread_top_ 个线程
+  hot_threads_.clear();
+  hot_begin_.clear();
+  for (size_t slot : top_) {
+    hot_begin_.push_back(hot_threads_.size());
+    int pid = processes_[slot].pid;
+    auto range = std::equal_range(
+        threads_.begin(), threads_.end(), ThreadSample{pid, 0},
+        [](const ThreadSample &a, const ThreadSample &b) { return a.pid < b.pid; });
+    size_t first = hot_threads_.size();
+    for (auto it = range.first; it != range.second; ++it)
+      hot_threads_.push_back(static_cast<size_t>(it - threads_.begin()));
+    size_t k = std::min(thread_top_, hot_threads_.size() - first);
+    std::partial_sort(hot_threads_.begin() + first,
+                      hot_threads_.begin() + first + k, hot_threads_.end(),
+                      [this](size_t a, size_t b) {
+                        return threads_[a].cpu_percent > threads_[b].cpu_percent;
+                      });
+    hot_threads_.resize(first + k);
+  }
+  hot_begin_.push_back(hot_threads_.size());
+
+  // 下一轮枚举这一轮的 Top N
+  drill_pids_.clear();
+  for (size_t slot : top_)
+    drill_pids_.push_back(processes_[slot].pid);
+}
+
+void ProcessCollector::do_calculate() {
+  static const double clock_ticks = static_cast<double>(sysconf(_SC_CLK_TCK));
 
-  processes_.clear();
+  top_.clear();
   total_processes_ = 0;
   running_processes_ = 0;
+  for (size_t slot = 0; slot < processes_.size(); ++slot) {
+    ProcessInfo &info = processes_[slot];
+    if (info.pid == 0)
+      continue;
 
-  struct dirent *entry;
-  while ((entry = readdir(dir)) != nullptr) {
-    if (entry->d_type == DT_DIR) {
-      std::string name = entry->d_name;
-      bool is_pid =
-          !name.empty() && std::all_of(name.begin(), name.end(), ::isdigit);
-
-      if (is_pid) {
-        int pid = std::stoi(name);
-        std::string stat_path = std::string(PROC_PATH) + "/" + name + "/stat";
-        std::ifstream stat_file(stat_path);
-
-        if (stat_file.is_open()) {
-          std::string line;
-          if (std::getline(stat_file, line)) {
-            ProcessInfo info;
-            info.pid = pid;
-
-            size_t start = line.find('(');
-            size_t end = line.rfind(')');
-
-            if (start != std::string::npos && end != std::string::npos) {
-              info.name = line.substr(start + 1, end - start - 1);
-
-              std::stringstream ss(line.substr(end + 2));
-              char state;
-              int ppid, pgrp, session, tty_nr, tpgid;
-              unsigned flags;
-              uint64_t minflt, cminflt, majflt, cmajflt, utime, stime;
-              int64_t cutime, cstime, priority, nice, num_threads, itrealvalue;
-              uint64_t starttime;
-
-              ss >> state >> ppid >> pgrp >> session >> tty_nr >> tpgid >>
-                  flags >> minflt >> cminflt >> majflt >> cmajflt >> utime >>
-                  stime >> cutime >> cstime >> priority >> nice >>
-                  num_threads >> itrealvalue >> starttime >> info.vsize >>
-                  info.rss;
-
-              info.state = state;
-
-              if (state == 'R')
-                running_processes_++;
-
-              processes_.push_back(info);
-              total_processes_++;
-            }
-          }
-          stat_file.close();
-        }
+    if (info.generation != generation_) {
+      // 抽样模式下不属于本轮的进程：保留上一次的数值，轮到它时再确认是否退出
+      if (stride_ > 1 && static_cast<size_t>(info.pid) % stride_ != phase_) {
+        ++total_processes_;
+        running_processes_ += info.state == 'R';
+        top_.push_back(slot);
+        continue;
+      }
+      // 后端只列出了本轮运行过的进程：没运行的进程 CPU 为 0，其余数值不变
+      if (keep_unlisted(info.pid)) {
+        ++total_processes_;
+        running_processes_ += info.state == 'R';
+        info.cpu_percent = 0.0;
+        info.rss_delta = 0;
+        info.sampled_at = scan_time_;
+        top_.push_back(slot);
+        continue;
       }
+      // 本轮应当扫描到却没有：进程已退出，释放槽位
+      index_.erase(ProcessKey{info.pid, info.starttime});
+      info.pid = 0;
+      free_slots_.push_back(slot);
+      continue;
+    }
+    ++total_processes_;
+    running_processes_ += info.state == 'R';
+
+    // 按该进程自己上一次被读取的时间计算（抽样模式下间隔 stride_ 个 tick）
+    double elapsed =
+        std::chrono::duration<double>(scan_time_ - info.sampled_at).count();
+    info.sampled_at = scan_time_;
+    uint64_t cpu_ticks = info.utime + info.stime;
+    if (info.has_prev && elapsed > 0) {
+      info.cpu_percent =
+          100.0 * (cpu_ticks - info.prev_cpu_ticks) / clock_ticks / elapsed;
+      info.rss_delta = info.rss - info.prev_rss;
+    } else {
+      info.cpu_percent = 0.0;
+      info.rss_delta = 0;
     }
+    info.prev_cpu_ticks = cpu_ticks;
+    info.prev_rss = info.rss;
+    info.has_prev = true;
+
+    top_.push_back(slot);
   }
-  closedir(dir);
 
-  // 按内存使用排序
-  std::sort(
-      processes_.begin(), processes_.end(),
-      [](const ProcessInfo &a, const ProcessInfo &b) { return a.rss > b.rss; });
+  // 只需要前 top_n_ 个：partial_sort 是 O(n log k)，无需对全部进程排序
+  size_t k = std::min(top_n_, top_.size());
+  std::partial_sort(top_.begin(), top_.begin() + k, top_.end(),
+                    [this](size_t a, size_t b) {
+                      return processes_[a].rss > processes_[b].rss;
+                    });
+  top_.resize(k);
+  if (thread_top_ > 0)
+    calculate_threads();
 }
 
-void ProcessCollector::print_result() const {
-  std::cout << "进程统计:" << std::endl;
-  std::cout << "  总进程数: " << total_processes_ << std::endl;
-  std::cout << "  运行中:   " << running_processes_ << std::endl;
+void ProcessCollector::do_snapshot() {
+  // 进程表留在 tick 线程：快照只带走 Top N 条目的副本
+  snapshot_.publish([this](Snapshot &snap) {
+    snap.top.resize(top_.size());
+    for (size_t i = 0; i < top_.size(); ++i) {
+      const ProcessInfo &info = processes_[top_[i]];
+      TopEntry &entry = snap.top[i];
+      entry.pid = info.pid;
+      entry.name = info.name;
+      entry.rss = info.rss;
+      entry.rss_delta = info.rss_delta;
+      entry.cpu_percent = info.cpu_percent;
+      // 下钻的线程：关闭或本轮还没有枚举到时为空
+      size_t hot = thread_top_ > 0 ? hot_begin_[i + 1] - hot_begin_[i] : 0;
+      entry.threads.resize(hot);
+      for (size_t t = 0; t < hot; ++t) {
+        const ThreadSample &sample = threads_[hot_threads_[hot_begin_[i] + t]];
+        entry.threads[t].tid = sample.tid;
+        entry.threads[t].name.assign(sample.name, sample.name_len);
+        entry.threads[t].cpu_percent = sample.cpu_percent;
+      }
+    }
+    snap.top_n = top_n_;
+    snap.thread_top = thread_top_;
+    snap.threads_scanned = thread_top_ > 0 ? threads_.size() : 0;
+    snap.sample_stride = stride_;
+    snap.total_processes = total_processes_;
+    snap.running_processes = running_processes_;
+  });
+}
 
-  std::cout << "  Top 5 内存占用进程:" << std::endl;
-  int count = 0;
-  for (const auto &proc : processes_) {
-    if (count >= 5)
-      break;
+void ProcessCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  out.gauge("processes_total", static_cast<double>(snap->total_processes));
+  out.gauge("processes_running", static_cast<double>(snap->running_processes));
+}
+
+void ProcessCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  out << "进程统计:\n";
+  out << "  总进程数: " << snap->total_processes << '\n';
+  out << "  运行中:   " << snap->running_processes << '\n';
+
+  out << "  Top " << snap->top_n << " 内存占用进程";
+  if (snap->sample_stride > 1)
+    out << " (抽样 1/" << snap->sample_stride << ")";
+  out << ":\n";
+  for (const auto &proc : snap->top) {
     double rss_mb = proc.rss * 4.0 / 1024.0;
-    std::cout << "    [" << proc.pid << "] " << proc.name << " - " << std::fixed
-              << std::setprecision(1) << rss_mb << " MB" << std::endl;
-    count++;
+    double delta_mb = proc.rss_delta * 4.0 / 1024.0;
+    out << "    [" << proc.pid << "] " << proc.name << " - " << std::fixed
+        << std::setprecision(1) << rss_mb << " MB";
+    if (proc.rss_delta != 0)
+      out << " (" << std::showpos << delta_mb << std::noshowpos
+          << " MB)";
+    out << "  CPU " << proc.cpu_percent << "%\n";
+    for (const auto &thread : proc.threads) {
+      out << "        线程 [" << thread.tid << "] " << thread.name << "  CPU "
+          << thread.cpu_percent << "%\n";
+    }
+  }
+  if (snap->thread_top > 0) {
+    out << "  线程下钻: 每个进程 CPU 最高的 " << snap->thread_top << " 个线程 (本轮读取 "
+        << snap->threads_scanned << " 个线程)\n";
   }
 }
 
 // ==================== SystemCollector ====================
+SystemCollector::SystemCollector(const std::string &proc_root)
+    : uptime_file_(proc_path(proc_root, UPTIME_FILE)),
+      loadavg_file_(proc_path(proc_root, LOADAVG_FILE)) {}
+
+void SystemCollector::prefetch(ProcFileBatch &batch) {
+  batch.add(uptime_file_);
+  batch.add(loadavg_file_);
+}
+
 void SystemCollector::do_collect() {
   // 读取 uptime
-  std::ifstream uptime_file(UPTIME_PATH);
-  if (uptime_file.is_open()) {
-    uptime_file >> uptime_seconds_;
-    uptime_file.close();
-  }
+  ParseCursor uptime(uptime_file_.read());
+  uptime.parse_double(uptime_seconds_);
 
   // 读取 loadavg
-  std::ifstream loadavg_file(LOADAVG_PATH);
-  if (loadavg_file.is_open()) {
-    std::ostringstream oss;
-    oss << loadavg_file.rdbuf();
-    raw_data_ = oss.str();
-    loadavg_file.close();
-  }
+  raw_data_ = loadavg_file_.read();
 }
 
 void SystemCollector::do_parse() {
-  std::istringstream iss(raw_data_);
-  std::string running_str;
-  iss >> load_1min_ >> load_5min_ >> load_15min_ >> running_str;
+  // 格式: "0.52 0.58 0.59 2/1234 5678"
+  ParseCursor cur(raw_data_);
+  if (!cur.parse_double(load_1min_) || !cur.parse_double(load_5min_) ||
+      !cur.parse_double(load_15min_))
+    return;
 
-  size_t slash_pos = running_str.find('/');
-  if (slash_pos != std::string::npos) {
-    running_tasks_ = std::stoi(running_str.substr(0, slash_pos));
-    total_tasks_ = std::stoi(running_str.substr(slash_pos + 1));
+  int running = 0, total = 0;
+  if (cur.parse_int(running) && cur.consume('/') && cur.parse_int(total)) {
+    running_tasks_ = running;
+    total_tasks_ = total;
   }
 }
 
-void SystemCollector::print_result() const {
-  int days = static_cast<int>(uptime_seconds_ / 86400);
+void SystemCollector::do_snapshot() {
+  snapshot_.publish([this](Snapshot &snap) {
+    snap.uptime_seconds = uptime_seconds_;
+    snap.load_1min = load_1min_;
+    snap.load_5min = load_5min_;
+    snap.load_15min = load_15min_;
+    snap.running_tasks = running_tasks_;
+    snap.total_tasks = total_tasks_;
+  });
+}
+
+void SystemCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  out.gauge("uptime_seconds", snap->uptime_seconds);
+  out.gauge("load_1min", snap->load_1min);
+  out.gauge("load_5min", snap->load_5min);
+  out.gauge("load_15min", snap->load_15min);
+  out.gauge("tasks_running", snap->running_tasks);
+  out.gauge("tasks_total", snap->total_tasks);
+}
+
+void SystemCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  double uptime_seconds = snap->uptime_seconds;
+  int days = static_cast<int>(uptime_seconds / 86400);
   int hours =
-      static_cast<int>((static_cast<int>(uptime_seconds_) % 86400) / 3600);
-  int minutes =
-      static_cast<int>((static_cast<int>(uptime_seconds_) % 3600) / 60);
-  int seconds = static_cast<int>(uptime_seconds_) % 60;
+      static_cast<int>((static_cast<int>(uptime_seconds) % 86400) / 3600);
+  int minutes = static_cast<int>((static_cast<int>(uptime_seconds) % 3600) / 60);
+  int seconds = static_cast<int>(uptime_seconds) % 60;
 
-  std::cout << "系统信息:" << std::endl;
-  std::cout << "  运行时间: ";
+  out << "系统信息:\n";
+  out << "  运行时间: ";
   if (days > 0)
-    std::cout << days << " 天 ";
-  std::cout << hours << " 小时 " << minutes << " 分钟 " << seconds << " 秒"
-            << std::endl;
+    out << days << " 天 ";
+  out << hours << " 小时 " << minutes << " 分钟 " << seconds << " 秒\n";
 
-  std::cout << "  系统负载: " << std::fixed << std::setprecision(2)
-            << load_1min_ << " (1分钟), " << load_5min_ << " (5分钟), "
-            << load_15min_ << " (15分钟)" << std::endl;
+  out << "  系统负载: " << std::fixed << std::setprecision(2)
+      << snap->load_1min << " (1分钟), " << snap->load_5min << " (5分钟), "
+      << snap->load_15min << " (15分钟)\n";
 
-  std::cout << "  任务状态: " << running_tasks_ << " 运行 / " << total_tasks_
-            << " 总计" << std::endl;
+  out << "  任务状态: " << snap->running_tasks << " 运行 / "
+      << snap->total_tasks << " 总计\n";
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "CpuStats.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+inline uint64_t saturating_delta(uint64_t prev, uint64_t curr) {
+  return curr > prev ? curr - prev : 0;
+}
+
+// 处理 [begin, end) 区间，标量实现和 AVX2 的尾部共用
+void usage_range_scalar(const CpuTimes &prev, const CpuTimes &curr,
+                        CpuUsage &out, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    uint64_t d[CPU_FIELD_COUNT];
+    uint64_t total = 0;
+    for (int f = 0; f < CPU_FIELD_COUNT; ++f) {
+      d[f] = saturating_delta(prev.fields[f][i], curr.fields[f][i]);
+      total += d[f];
+    }
+
+    double scale = total > 0 ? 100.0 / static_cast<double>(total) : 0.0;
+    uint64_t busy = total - d[CPU_IDLE] - d[CPU_IOWAIT];
+    out.total[i] = scale * static_cast<double>(busy);
+    out.user[i] = scale * static_cast<double>(d[CPU_USER] + d[CPU_NICE]);
+    out.system[i] = scale * static_cast<double>(d[CPU_SYSTEM] + d[CPU_IRQ] +
+                                                d[CPU_SOFTIRQ]);
+    out.iowait[i] = scale * static_cast<double>(d[CPU_IOWAIT]);
+    out.steal[i] = scale * static_cast<double>(d[CPU_STEAL]);
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+bool cpu_has_avx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+#endif
+} // namespace
+
+void compute_cpu_usage_scalar(const CpuTimes &prev, const CpuTimes &curr,
+                              CpuUsage &out) {
+  usage_range_scalar(prev, curr, out, 0, curr.size());
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+namespace {
+// 饱和减法：curr - prev，结果为负（计数器回退）时取 0
+__attribute__((target("avx2"))) inline __m256i
+delta_epi64(const uint64_t *prev, const uint64_t *curr, size_t i) {
+  __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev + i));
+  __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(curr + i));
+  __m256i d = _mm256_sub_epi64(c, p);
+  __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), d);
+  return _mm256_andnot_si256(negative, d);
+}
+
+// uint64 -> double，要求 v < 2^52（单个 tick 的 jiffies 差值远小于此）
+__attribute__((target("avx2"))) inline __m256d u64_to_pd(__m256i v) {
+  const __m256i magic_i = _mm256_set1_epi64x(0x4330000000000000LL); // 2^52
+  const __m256d magic_d = _mm256_castsi256_pd(magic_i);
+  return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(v, magic_i)),
+                       magic_d);
+}
+} // namespace
+
+__attribute__((target("avx2"))) void
+compute_cpu_usage_avx2(const CpuTimes &prev, const CpuTimes &curr,
+                       CpuUsage &out) {
+  const size_t n = curr.size();
+  const __m256d hundred = _mm256_set1_pd(100.0);
+  const __m256d zero = _mm256_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i d[CPU_FIELD_COUNT];
+    __m256i total = _mm256_setzero_si256();
+    for (int f = 0; f < CPU_FIELD_COUNT; ++f) {
+      d[f] = delta_epi64(prev.fields[f].data(), curr.fields[f].data(), i);
+      total = _mm256_add_epi64(total, d[f]);
+    }
+
+    __m256i busy = _mm256_sub_epi64(
+        total, _mm256_add_epi64(d[CPU_IDLE], d[CPU_IOWAIT]));
+    __m256i user = _mm256_add_epi64(d[CPU_USER], d[CPU_NICE]);
+    __m256i system = _mm256_add_epi64(
+        d[CPU_SYSTEM], _mm256_add_epi64(d[CPU_IRQ], d[CPU_SOFTIRQ]));
+
+    // total 为 0 的核心（两次采样之间没有任何计数）结果为 0
+    __m256d total_d = u64_to_pd(total);
+    __m256d has_time = _mm256_cmp_pd(total_d, zero, _CMP_GT_OQ);
+    __m256d scale =
+        _mm256_and_pd(has_time, _mm256_div_pd(hundred, total_d));
+
+    _mm256_storeu_pd(out.total.data() + i,
+                     _mm256_mul_pd(scale, u64_to_pd(busy)));
+    _mm256_storeu_pd(out.user.data() + i,
+                     _mm256_mul_pd(scale, u64_to_pd(user)));
+    _mm256_storeu_pd(out.system.data() + i,
+                     _mm256_mul_pd(scale, u64_to_pd(system)));
+    _mm256_storeu_pd(out.iowait.data() + i,
+                     _mm256_mul_pd(scale, u64_to_pd(d[CPU_IOWAIT])));
+    _mm256_storeu_pd(out.steal.data() + i,
+                     _mm256_mul_pd(scale, u64_to_pd(d[CPU_STEAL])));
+  }
+  // 尾部交给非 VEX 编码的标量代码，先清掉 ymm 高半部分避免状态切换惩罚
+  _mm256_zeroupper();
+  usage_range_scalar(prev, curr, out, i, n);
+}
+#endif
+
+void compute_cpu_usage(const CpuTimes &prev, const CpuTimes &curr,
+                       CpuUsage &out) {
+#if defined(__x86_64__) || defined(__i386__)
+  if (cpu_has_avx2()) {
+    compute_cpu_usage_avx2(prev, curr, out);
+    return;
+  }
+#endif
+  compute_cpu_usage_scalar(prev, curr, out);
+}
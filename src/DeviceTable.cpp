@@ -0,0 +1,100 @@
+#include "DeviceTable.h"
+#include <algorithm>
+#include <unordered_map>
+
+void DeviceTable::begin_rows() {
+  rows_ = 0;
+  changed_ = false;
+}
+
+uint64_t *DeviceTable::row(std::string_view name) {
+  size_t slot = rows_++;
+  if (!changed_ && (slot >= names_.size() || names_[slot] != name)) {
+    // 第一个不一致的位置：之前的设备都沿用原有名字
+    changed_ = true;
+    pending_names_.assign(names_.begin(), names_.begin() + slot);
+  }
+  if (changed_)
+    pending_names_.emplace_back(name);
+
+  if (curr_.size() < rows_ * fields_)
+    curr_.resize(rows_ * fields_);
+  uint64_t *out = &curr_[slot * fields_];
+  std::fill(out, out + fields_, 0);
+  return out;
+}
+
+void DeviceTable::end_rows() {
+  if (!changed_ && rows_ == names_.size())
+    return;
+  if (!changed_) // 只是末尾的设备消失了
+    pending_names_.assign(names_.begin(), names_.begin() + rows_);
+
+  // 只在设备集合变化时执行：按名字把上一次的计数器搬到新槽位
+  std::unordered_map<std::string_view, size_t> old_slots;
+  old_slots.reserve(names_.size());
+  for (size_t slot = 0; slot < names_.size(); ++slot)
+    old_slots.emplace(names_[slot], slot);
+
+  remap_.assign(rows_ * fields_, 0);
+  fresh_.assign(rows_, 1);
+  for (size_t slot = 0; slot < rows_; ++slot) {
+    auto it = old_slots.find(pending_names_[slot]);
+    if (it == old_slots.end() || (it->second + 1) * fields_ > prev_.size())
+      continue;
+    std::copy_n(&prev_[it->second * fields_], fields_, &remap_[slot * fields_]);
+    fresh_[slot] = 0;
+  }
+
+  prev_.swap(remap_);
+  names_.swap(pending_names_);
+  curr_.resize(rows_ * fields_);
+  rates_.assign(rows_ * fields_, 0.0);
+  ++generation_;
+}
+
+uint64_t DeviceTable::counter_delta(uint64_t prev, uint64_t curr) {
+  if (curr >= prev)
+    return curr - prev;
+  constexpr uint64_t WRAP_32 = 1ULL << 32;
+  if (prev >= WRAP_32 / 2 && prev < WRAP_32 && curr < WRAP_32)
+    return curr + WRAP_32 - prev; // 32 位计数器回绕
+  return curr;                    // 计数器被重置，从 0 重新计数
+}
+
+void DeviceTable::compute_rates(Clock::time_point now) {
+  // 第一次采样没有时间间隔，速率全部为 0
+  double seconds = prev_time_ == Clock::time_point{}
+                       ? 0.0
+                       : std::chrono::duration<double>(now - prev_time_).count();
+  double scale = seconds > 0 ? 1.0 / seconds : 0.0;
+  prev_time_ = now;
+
+  rates_.resize(curr_.size());
+  for (size_t slot = 0; slot < size(); ++slot) {
+    double slot_scale = fresh_[slot] ? 0.0 : scale;
+    size_t base = slot * fields_;
+    for (size_t i = base; i < base + fields_; ++i)
+      rates_[i] = slot_scale * static_cast<double>(counter_delta(prev_[i], curr_[i]));
+  }
+  std::fill(fresh_.begin(), fresh_.end(), 0);
+  prev_ = curr_; // 大小相同，不分配
+}
+
+void DeviceSnapshot::assign(const DeviceTable &table) {
+  if (generation != table.generation() || names.size() != table.size()) {
+    names.resize(table.size());
+    for (size_t slot = 0; slot < table.size(); ++slot)
+      names[slot] = table.name(slot);
+    generation = table.generation();
+  }
+  fields = table.fields();
+  size_t values = table.size() * fields;
+  if (values == 0) {
+    counters.clear();
+    rates.clear();
+    return;
+  }
+  counters.assign(table.counters(0), table.counters(0) + values);
+  rates.assign(table.rates(0), table.rates(0) + values);
+}
@@ -0,0 +1,397 @@
+#include "EbpfCollectors.h"
+#include "Bpf.h"
+#include "CollectorFactory.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <unistd.h>
+
+REGISTER_COLLECTOR_BACKEND(EbpfProcessCollector, "process", "ebpf");
+
+namespace {
+constexpr uint32_t WAKEUP_ENTRIES = 16384;
+constexpr uint32_t CPU_ENTRIES = 32768;
+constexpr uint32_t EXIT_ENTRIES = 4096;
+
+// BPF 寄存器：r0 返回值，r1~r5 参数（调用后失效），r6~r9 调用间保留，r10 栈帧
+enum : uint8_t { R0, R1, R2, R3, R4, R5, R6, R7, R8, R9, R10 };
+
+// raw tracepoint 的上下文是 u64 参数数组
+constexpr int16_t arg(int i) { return static_cast<int16_t>(i * 8); }
+
+// r1 = map，r2 = r10 + key_off，调用 map_lookup_elem
+void emit_lookup(bpf::Assembler &as, int map_fd, int16_t key_off) {
+  as.load_map(R1, map_fd);
+  as.mov_reg(R2, R10);
+  as.add_imm(R2, key_off);
+  as.call(BPF_FUNC_map_lookup_elem);
+}
+
+void emit_update(bpf::Assembler &as, int map_fd, int16_t key_off,
+                 int16_t value_off, int32_t flags) {
+  as.load_map(R1, map_fd);
+  as.mov_reg(R2, R10);
+  as.add_imm(R2, key_off);
+  as.mov_reg(R3, R10);
+  as.add_imm(R3, value_off);
+  as.mov_imm(R4, flags);
+  as.call(BPF_FUNC_map_update_elem);
+}
+
+// *(u32 *)(r10 + dst_off) = *(u32 *)(src_reg + field_off)，src_reg 是内核指针
+void emit_read_u32(bpf::Assembler &as, int16_t dst_off, uint8_t src_reg,
+                   uint32_t field_off) {
+  as.mov_reg(R3, src_reg);
+  as.add_imm(R3, static_cast<int32_t>(field_off));
+  as.mov_reg(R1, R10);
+  as.add_imm(R1, dst_off);
+  as.mov_imm(R2, 4);
+  as.call(BPF_FUNC_probe_read_kernel);
+}
+
+bool load_and_attach(bpf::Assembler &as, const char *name,
+                     const char *tracepoint, std::vector<int> &fds) {
+  std::vector<bpf_insn> insns;
+  if (!as.finish(insns))
+    return false;
+  std::string log;
+  int prog = bpf::load_raw_tracepoint(insns, name, log);
+  if (prog < 0) {
+    LOG_WARN(std::string("加载 BPF 程序 ") + name + " 失败: " + strerror(errno) +
+             (log.empty() ? std::string() : "\n" + log));
+    return false;
+  }
+  fds.push_back(prog);
+  int link = bpf::attach_raw_tracepoint(tracepoint, prog);
+  if (link < 0) {
+    LOG_WARN(std::string("挂载 raw tracepoint ") + tracepoint +
+             " 失败: " + strerror(errno));
+    return false;
+  }
+  fds.push_back(link);
+  return true;
+}
+
+// 第 p 百分位所在桶的上界（微秒）
+uint64_t slot_percentile(const std::array<uint64_t, EbpfProcessCollector::HIST_SLOTS> &hist,
+                         uint64_t total, double p) {
+  if (total == 0)
+    return 0;
+  uint64_t target = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total));
+  if (target >= total)
+    target = total - 1;
+  uint64_t seen = 0;
+  for (int slot = 0; slot < EbpfProcessCollector::HIST_SLOTS; ++slot) {
+    seen += hist[slot];
+    if (seen > target)
+      return (uint64_t{2} << slot) - 1;
+  }
+  return 0;
+}
+} // namespace
+
+// ==================== EbpfProcessCollector ====================
+EbpfProcessCollector::EbpfProcessCollector(const std::string &proc_root)
+    : ProcessCollector(proc_root),
+      // 调度事件描述的是本机的进程，注入的 fixture 目录树只能完整扫描
+      use_bpf_(proc_root == DEFAULT_PROC_ROOT) {}
+
+EbpfProcessCollector::~EbpfProcessCollector() { detach(); }
+
+void EbpfProcessCollector::detach() {
+  for (int fd : fds_)
+    close(fd);
+  fds_.clear();
+  for (int *fd : {&wakeup_map_, &oncpu_map_, &cpu_map_, &hist_map_, &exit_map_}) {
+    if (*fd != -1)
+      close(*fd);
+    *fd = -1;
+  }
+  attached_ = false;
+}
+
+bool EbpfProcessCollector::attach() {
+  uint32_t pid_off = 0;
+  uint32_t tgid_off = 0;
+  if (!bpf::btf_member_offset("task_struct", "pid", pid_off) ||
+      !bpf::btf_member_offset("task_struct", "tgid", tgid_off)) {
+    LOG_WARN("无法从 /sys/kernel/btf/vmlinux 读取 task_struct 的字段偏移");
+    return false;
+  }
+
+  wakeup_map_ = bpf::create_map(BPF_MAP_TYPE_LRU_HASH, sizeof(uint32_t),
+                                sizeof(uint64_t), WAKEUP_ENTRIES, "wakeup_ts");
+  oncpu_map_ = bpf::create_map(BPF_MAP_TYPE_PERCPU_ARRAY, sizeof(uint32_t),
+                               sizeof(OnCpu), 1, "oncpu");
+  cpu_map_ = bpf::create_map(BPF_MAP_TYPE_HASH, sizeof(uint32_t),
+                             sizeof(uint64_t), CPU_ENTRIES, "cpu_ns");
+  hist_map_ = bpf::create_map(BPF_MAP_TYPE_ARRAY, sizeof(uint32_t),
+                              sizeof(uint64_t), HIST_SLOTS, "runq_hist");
+  exit_map_ = bpf::create_map(BPF_MAP_TYPE_HASH, sizeof(uint32_t),
+                              sizeof(uint32_t), EXIT_ENTRIES, "exited");
+  if (wakeup_map_ < 0 || oncpu_map_ < 0 || cpu_map_ < 0 || hist_map_ < 0 ||
+      exit_map_ < 0) {
+    LOG_WARN(std::string("创建 BPF map 失败（需要 CAP_BPF）: ") + strerror(errno));
+    return false;
+  }
+  if (!load_programs(pid_off, tgid_off))
+    return false;
+
+  keys_.resize(CPU_ENTRIES);
+  cpu_ns_.resize(CPU_ENTRIES);
+  exit_keys_.resize(EXIT_ENTRIES);
+  exit_values_.resize(EXIT_ENTRIES);
+  oncpu_.resize(static_cast<size_t>(bpf::possible_cpus()));
+  attached_ = true;
+  return true;
+}
+
+bool EbpfProcessCollector::load_programs(uint32_t pid_off, uint32_t tgid_off) {
+  // 栈上的临时变量（相对 r10）
+  constexpr int16_t KEY = -8;
+  constexpr int16_t VALUE = -16;
+  constexpr int16_t ZERO = -20;
+
+  // sched_wakeup / sched_wakeup_new(p)：wakeup_ts[p->pid] = now
+  for (const char *tracepoint : {"sched_wakeup", "sched_wakeup_new"}) {
+    bpf::Assembler as;
+    auto out = as.new_label();
+    as.mov_reg(R6, R1);
+    as.load(BPF_DW, R6, R6, arg(0));
+    emit_read_u32(as, KEY, R6, pid_off);
+    as.jump_imm(BPF_JNE, R0, 0, out);
+    as.call(BPF_FUNC_ktime_get_ns);
+    as.store(BPF_DW, R10, VALUE, R0);
+    emit_update(as, wakeup_map_, KEY, VALUE, BPF_ANY);
+    as.bind(out);
+    as.mov_imm(R0, 0);
+    as.exit();
+    if (!load_and_attach(as, "monitor_wakeup", tracepoint, fds_))
+      return false;
+  }
+
+  // sched_switch(preempt, prev, next, prev_state)
+  {
+    bpf::Assembler as;
+    auto after_cpu = as.new_label();
+    auto insert = as.new_label();
+    auto after_enqueue = as.new_label();
+    auto out = as.new_label();
+
+    as.mov_reg(R6, R1);
+    as.call(BPF_FUNC_ktime_get_ns);
+    as.mov_reg(R7, R0); // r7 = now
+    as.call(BPF_FUNC_get_current_pid_tgid);
+    as.mov_reg(R8, R0); // r8 = prev 的 tgid << 32 | pid（切换时 current 还是 prev）
+
+    // 1. 这个 CPU 上一段运行时间记到 prev 的线程组，再记下 next 的开始时间和 tgid
+    as.store_imm(BPF_W, R10, ZERO, 0);
+    emit_lookup(as, oncpu_map_, ZERO);
+    as.jump_imm(BPF_JEQ, R0, 0, after_cpu);
+    as.mov_reg(R9, R0);
+    as.load(BPF_DW, R3, R6, arg(2));
+    as.add_imm(R3, static_cast<int32_t>(tgid_off));
+    as.mov_reg(R1, R9);
+    as.add_imm(R1, offsetof(OnCpu, tgid));
+    as.mov_imm(R2, 4);
+    as.call(BPF_FUNC_probe_read_kernel);
+    as.load(BPF_DW, R1, R9, offsetof(OnCpu, start_ns));
+    as.store(BPF_DW, R9, offsetof(OnCpu, start_ns), R7);
+    as.jump_imm(BPF_JEQ, R1, 0, after_cpu); // 这个 CPU 上的第一次切换
+    as.mov_reg(R2, R7);
+    as.sub_reg(R2, R1);
+    as.store(BPF_DW, R10, VALUE, R2);
+    as.mov_reg(R1, R8);
+    as.rsh_imm(R1, 32);
+    as.jump_imm(BPF_JEQ, R1, 0, after_cpu); // idle
+    as.store(BPF_W, R10, KEY, R1);
+    emit_lookup(as, cpu_map_, KEY);
+    as.jump_imm(BPF_JEQ, R0, 0, insert);
+    as.load(BPF_DW, R1, R10, VALUE);
+    as.atomic_add(BPF_DW, R0, 0, R1);
+    as.jump(after_cpu);
+    as.bind(insert);
+    // 与其他 CPU 同时插入时丢掉这一段，影响的只是一次切换的时间
+    emit_update(as, cpu_map_, KEY, VALUE, BPF_NOEXIST);
+    as.bind(after_cpu);
+
+    // 2. prev 被抢占（仍是 TASK_RUNNING）：重新入队，从现在开始计算等待
+    as.load(BPF_DW, R1, R6, arg(3));
+    as.jump_imm(BPF_JNE, R1, 0, after_enqueue);
+    as.mov32_reg(R1, R8);
+    as.jump_imm(BPF_JEQ, R1, 0, after_enqueue);
+    as.store(BPF_W, R10, KEY, R1);
+    as.store(BPF_DW, R10, VALUE, R7);
+    emit_update(as, wakeup_map_, KEY, VALUE, BPF_ANY);
+    as.bind(after_enqueue);
+
+    // 3. next 从入队到开始运行的时间，按 log2 微秒分桶
+    as.load(BPF_DW, R6, R6, arg(2));
+    emit_read_u32(as, KEY, R6, pid_off);
+    as.jump_imm(BPF_JNE, R0, 0, out);
+    emit_lookup(as, wakeup_map_, KEY);
+    as.jump_imm(BPF_JEQ, R0, 0, out);
+    as.load(BPF_DW, R1, R0, 0);
+    as.mov_reg(R9, R7);
+    as.sub_reg(R9, R1);
+    as.load_map(R1, wakeup_map_);
+    as.mov_reg(R2, R10);
+    as.add_imm(R2, KEY);
+    as.call(BPF_FUNC_map_delete_elem);
+    as.jump_imm(BPF_JSLT, R9, 0, out);
+    as.div_imm(R9, 1000);
+    // 二分求最高位：16/8/4/2/1 位，结果最大 31
+    as.mov_imm(R2, 0);
+    for (int bits : {16, 8, 4, 2, 1}) {
+      auto next = as.new_label();
+      as.jump_imm(BPF_JLT, R9, 1 << bits, next);
+      as.rsh_imm(R9, bits);
+      as.add_imm(R2, bits);
+      as.bind(next);
+    }
+    as.store(BPF_W, R10, KEY, R2);
+    emit_lookup(as, hist_map_, KEY);
+    as.jump_imm(BPF_JEQ, R0, 0, out);
+    as.mov_imm(R1, 1);
+    as.atomic_add(BPF_DW, R0, 0, R1);
+    as.bind(out);
+    as.mov_imm(R0, 0);
+    as.exit();
+    if (!load_and_attach(as, "monitor_switch", "sched_switch", fds_))
+      return false;
+  }
+
+  // sched_process_exit：线程组首线程退出时记下 tgid
+  {
+    bpf::Assembler as;
+    auto out = as.new_label();
+    as.call(BPF_FUNC_get_current_pid_tgid);
+    as.mov_reg(R1, R0);
+    as.rsh_imm(R1, 32);
+    as.mov32_reg(R2, R0);
+    as.jump_reg(BPF_JNE, R1, R2, out);
+    as.store(BPF_W, R10, KEY, R1);
+    as.store_imm(BPF_W, R10, VALUE, 0);
+    emit_update(as, exit_map_, KEY, VALUE, BPF_ANY);
+    as.bind(out);
+    as.mov_imm(R0, 0);
+    as.exit();
+    if (!load_and_attach(as, "monitor_exit", "sched_process_exit", fds_))
+      return false;
+  }
+  return true;
+}
+
+void EbpfProcessCollector::read_histogram() {
+  std::array<uint64_t, HIST_SLOTS> current{};
+  long n = bpf::read_all(hist_map_, false, keys_.data(), sizeof(uint32_t),
+                         current.data(), sizeof(uint64_t), HIST_SLOTS);
+  if (n < 0)
+    return;
+  wakeups_ = 0;
+  max_us_ = 0;
+  for (int slot = 0; slot < HIST_SLOTS; ++slot) {
+    // 数组 map 的批量读取按键排列：第 i 个结果就是第 i 个桶
+    hist_delta_[slot] = current[slot] - hist_[slot];
+    wakeups_ += hist_delta_[slot];
+    if (hist_delta_[slot])
+      max_us_ = (uint64_t{2} << slot) - 1;
+  }
+  hist_ = current;
+  p50_us_ = slot_percentile(hist_delta_, wakeups_, 50.0);
+  p99_us_ = slot_percentile(hist_delta_, wakeups_, 99.0);
+}
+
+bool EbpfProcessCollector::list_pids(std::vector<int> &pids) {
+  if (use_bpf_ && !attached_ && !attach()) {
+    LOG_WARN("eBPF 后端不可用（需要 CAP_BPF + CAP_PERFMON），改为每次完整扫描 /proc");
+    detach();
+    use_bpf_ = false;
+  }
+  if (!use_bpf_) {
+    full_scan_ = true;
+    return ProcessCollector::list_pids(pids);
+  }
+
+  // 先取空 map 再列出：之后发生的调度和退出留在 map 里，下一个 tick 再处理
+  read_histogram();
+  long active = bpf::read_all(cpu_map_, true, keys_.data(), sizeof(uint32_t),
+                              cpu_ns_.data(), sizeof(uint64_t), CPU_ENTRIES);
+  long exits = bpf::read_all(exit_map_, true, exit_keys_.data(),
+                             sizeof(uint32_t), exit_values_.data(),
+                             sizeof(uint32_t), EXIT_ENTRIES);
+  exited_.assign(exit_keys_.begin(), exit_keys_.begin() + std::max(exits, 0L));
+  std::sort(exited_.begin(), exited_.end());
+  active_ = static_cast<size_t>(std::max(active, 0L));
+
+  // 第一次采集建立进程表；之后定期完整扫描，补上 map 写满时丢掉的事件
+  full_scan_ = ticks_++ % RESYNC_TICKS == 0 || active < 0 || exits < 0;
+  if (full_scan_)
+    return ProcessCollector::list_pids(pids);
+
+  auto exited = [this](int pid) {
+    return std::binary_search(exited_.begin(), exited_.end(), pid);
+  };
+  pids.clear();
+  for (size_t i = 0; i < active_; ++i) {
+    int pid = static_cast<int>(keys_[i]);
+    if (!exited(pid)) // 退出的进程就算还是僵尸也不再读取
+      pids.push_back(pid);
+  }
+  // 整个 tick 都没有被切换出去的进程不在 cpu_ns 里：补上每个 CPU 上正在运行的
+  uint32_t zero = 0;
+  if (bpf::lookup(oncpu_map_, &zero, oncpu_.data())) {
+    for (const OnCpu &cpu : oncpu_) {
+      int pid = static_cast<int>(cpu.tgid);
+      if (pid != 0 && !exited(pid))
+        pids.push_back(pid);
+    }
+  }
+  std::sort(pids.begin(), pids.end());
+  pids.erase(std::unique(pids.begin(), pids.end()), pids.end());
+  return true;
+}
+
+bool EbpfProcessCollector::keep_unlisted(int pid) const {
+  return !full_scan_ && !std::binary_search(exited_.begin(), exited_.end(), pid);
+}
+
+void EbpfProcessCollector::do_snapshot() {
+  ProcessCollector::do_snapshot();
+  sched_.publish([this](SchedSnapshot &snap) {
+    snap.enabled = attached_;
+    snap.hist = hist_delta_;
+    snap.wakeups = wakeups_;
+    snap.p50_us = p50_us_;
+    snap.p99_us = p99_us_;
+    snap.max_us = max_us_;
+    snap.active_processes = active_;
+    snap.full_scan = full_scan_;
+  });
+}
+
+void EbpfProcessCollector::do_publish(MetricWriter &out) const {
+  ProcessCollector::do_publish(out);
+  auto snap = sched_.read();
+  if (!snap || !snap->enabled)
+    return;
+  out.gauge("processes_active", static_cast<double>(snap->active_processes));
+  out.gauge("runqueue_wakeups", static_cast<double>(snap->wakeups));
+  out.gauge("runqueue_latency_p50_us", static_cast<double>(snap->p50_us));
+  out.gauge("runqueue_latency_p99_us", static_cast<double>(snap->p99_us));
+  out.gauge("runqueue_latency_max_us", static_cast<double>(snap->max_us));
+}
+
+void EbpfProcessCollector::print_result(std::ostream &out) const {
+  ProcessCollector::print_result(out);
+  auto snap = sched_.read();
+  if (!snap || !snap->enabled)
+    return;
+  out << "  eBPF: 本轮运行过 " << snap->active_processes << " 个进程"
+      << (snap->full_scan ? " (完整扫描)" : "") << '\n';
+  out << "  运行队列延迟: " << snap->wakeups << " 次调度, p50 < " << snap->p50_us
+      << " us, p99 < " << snap->p99_us << " us, 最大 < " << snap->max_us
+      << " us\n";
+}
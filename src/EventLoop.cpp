@@ -0,0 +1,125 @@
+#include "EventLoop.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+constexpr int MAX_EVENTS = 64;
+
+itimerspec make_timerspec(std::chrono::nanoseconds interval, bool immediate) {
+  using namespace std::chrono;
+  itimerspec ts{};
+  auto sec = duration_cast<seconds>(interval);
+  ts.it_interval.tv_sec = sec.count();
+  ts.it_interval.tv_nsec = (interval - sec).count();
+  if (immediate) {
+    ts.it_value.tv_nsec = 1; // 非零值才会启动定时器
+  } else {
+    ts.it_value = ts.it_interval;
+  }
+  return ts;
+}
+} // namespace
+
+EventLoop::EventLoop() {
+  epfd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epfd_ == -1) {
+    LOG_ERROR(std::string("创建 epoll 失败: ") + strerror(errno));
+  }
+}
+
+EventLoop::~EventLoop() {
+  for (int tfd : timers_) {
+    close(tfd);
+  }
+  if (epfd_ != -1)
+    close(epfd_);
+}
+
+bool EventLoop::add(int fd, uint32_t events, Handler handler) {
+  epoll_event ev{};
+  ev.events = events;
+  ev.data.fd = fd;
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+    LOG_ERROR(std::string("epoll_ctl 失败: ") + strerror(errno));
+    return false;
+  }
+  handlers_[fd] = std::make_shared<Handler>(std::move(handler));
+  return true;
+}
+
+bool EventLoop::modify(int fd, uint32_t events) {
+  epoll_event ev{};
+  ev.events = events;
+  ev.data.fd = fd;
+  return epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::remove(int fd) {
+  epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+  handlers_.erase(fd);
+}
+
+int EventLoop::add_timer(std::chrono::nanoseconds interval,
+                         TimerHandler handler, bool armed) {
+  int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (tfd == -1) {
+    LOG_ERROR(std::string("创建 timerfd 失败: ") + strerror(errno));
+    return -1;
+  }
+
+  itimerspec ts = make_timerspec(interval, true);
+  if (armed && timerfd_settime(tfd, 0, &ts, nullptr) == -1) {
+    LOG_ERROR(std::string("设置 timerfd 失败: ") + strerror(errno));
+    close(tfd);
+    return -1;
+  }
+
+  bool ok = add(tfd, EPOLLIN, [tfd, handler = std::move(handler)](uint32_t) {
+    uint64_t expirations;
+    ssize_t s = read(tfd, &expirations, sizeof(expirations));
+    if (s != sizeof(expirations)) {
+      if (s == -1 && errno == EAGAIN)
+        return; // 周期刚被修改，没有到期
+      LOG_ERROR("读取 timerfd 失败");
+      return;
+    }
+    handler(expirations);
+  });
+  if (!ok) {
+    close(tfd);
+    return -1;
+  }
+  timers_.push_back(tfd);
+  return tfd;
+}
+
+bool EventLoop::set_timer(int tfd, std::chrono::nanoseconds interval) {
+  itimerspec ts = make_timerspec(interval, false);
+  return timerfd_settime(tfd, 0, &ts, nullptr) == 0;
+}
+
+bool EventLoop::run_once(int timeout_ms) {
+  epoll_event events[MAX_EVENTS];
+  int nfds = epoll_wait(epfd_, events, MAX_EVENTS, timeout_ms);
+  if (nfds == -1) {
+    if (errno == EINTR)
+      return true;
+    LOG_ERROR(std::string("epoll_wait 失败: ") + strerror(errno));
+    return false;
+  }
+
+  for (int n = 0; n < nfds; ++n) {
+    auto it = handlers_.find(events[n].data.fd);
+    if (it != handlers_.end()) {
+      // 持有一份引用：回调里可能 remove() 自己
+      std::shared_ptr<Handler> handler = it->second;
+      (*handler)(events[n].events);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,139 @@
+#include "FrameRenderer.h"
+#include <cerrno>
+#include <charconv>
+#include <unistd.h>
+
+// ==================== FrameBuffer ====================
+FrameBuffer::FrameBuffer(size_t capacity) : buf_(capacity < 64 ? 64 : capacity) {
+  reset();
+}
+
+void FrameBuffer::reset() { setp(buf_.data(), buf_.data() + buf_.size()); }
+
+FrameBuffer::int_type FrameBuffer::overflow(int_type ch) {
+  size_t used = static_cast<size_t>(pptr() - pbase());
+  buf_.resize(buf_.size() * 2);
+  setp(buf_.data(), buf_.data() + buf_.size());
+  pbump(static_cast<int>(used));
+
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+// ==================== FrameRenderer ====================
+namespace {
+constexpr std::string_view CLEAR_SCREEN = "\033[2J\033[H";
+constexpr std::string_view CLEAR_TO_EOL = "\033[K";
+constexpr std::string_view CLEAR_TO_EOS = "\033[J";
+} // namespace
+
+FrameRenderer::FrameRenderer(int fd, size_t capacity)
+    : fd_(fd), buffers_{FrameBuffer(capacity), FrameBuffer(capacity)},
+      stream_(&buffers_[0]) {
+  out_.reserve(capacity);
+}
+
+std::ostream &FrameRenderer::begin_frame() {
+  buffers_[current_].reset();
+  stream_.rdbuf(&buffers_[current_]);
+  stream_.clear();
+  return stream_;
+}
+
+void FrameRenderer::split_lines(std::string_view frame,
+                                std::vector<LineSpan> &lines) {
+  lines.clear();
+  size_t start = 0;
+  while (start < frame.size()) {
+    size_t end = frame.find('\n', start);
+    if (end == std::string_view::npos)
+      end = frame.size();
+    lines.push_back(LineSpan{start, end - start});
+    start = end + 1;
+  }
+}
+
+void FrameRenderer::append_cursor_move(size_t line) {
+  // "\033[<row>;1H"，行号从 1 开始
+  char buf[24];
+  buf[0] = '\033';
+  buf[1] = '[';
+  auto [ptr, ec] = std::to_chars(buf + 2, buf + sizeof(buf) - 3, line + 1);
+  (void)ec;
+  *ptr++ = ';';
+  *ptr++ = '1';
+  *ptr++ = 'H';
+  out_.append(buf, static_cast<size_t>(ptr - buf));
+}
+
+bool FrameRenderer::end_frame() {
+  int prev = 1 - current_;
+  std::string_view frame = buffers_[current_].view();
+  std::string_view old_frame = buffers_[prev].view();
+  std::vector<LineSpan> &lines = lines_[current_];
+  const std::vector<LineSpan> &old_lines = lines_[prev];
+  split_lines(frame, lines);
+
+  out_.clear();
+  size_t changed = 0;
+  if (full_redraw_) {
+    out_ += CLEAR_SCREEN;
+    out_.append(frame.data(), frame.size());
+    changed = lines.size();
+  } else {
+    // cursor：上一次输出之后光标所在的行，SIZE_MAX 表示未知
+    size_t cursor = SIZE_MAX;
+    for (size_t i = 0; i < lines.size(); ++i) {
+      std::string_view line = frame.substr(lines[i].offset, lines[i].length);
+      if (i < old_lines.size() &&
+          line == old_frame.substr(old_lines[i].offset, old_lines[i].length))
+        continue;
+
+      if (cursor != i)
+        append_cursor_move(i);
+      out_.append(line.data(), line.size());
+      out_ += CLEAR_TO_EOL;
+      out_ += '\n';
+      cursor = i + 1;
+      ++changed;
+    }
+
+    // 帧变短：清除多出的行；否则把光标留在最后一行之后
+    if (lines.size() < old_lines.size()) {
+      if (cursor != lines.size())
+        append_cursor_move(lines.size());
+      out_ += CLEAR_TO_EOS;
+    } else if (changed > 0 && cursor != lines.size()) {
+      append_cursor_move(lines.size());
+    }
+  }
+
+  last_bytes_ = out_.size();
+  last_changed_lines_ = changed;
+  current_ = prev;
+
+  if (out_.empty())
+    return true;
+  if (!write_all(out_)) {
+    full_redraw_ = true; // 终端状态未知，下一帧全量重绘
+    return false;
+  }
+  full_redraw_ = false;
+  return true;
+}
+
+bool FrameRenderer::write_all(std::string_view data) {
+  while (!data.empty()) {
+    ssize_t n = write(fd_, data.data(), data.size());
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data.remove_prefix(static_cast<size_t>(n));
+  }
+  return true;
+}
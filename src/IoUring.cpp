@@ -0,0 +1,165 @@
+#include "IoUring.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+int sys_io_uring_setup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                       unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int sys_io_uring_register(int fd, unsigned opcode, const void *arg,
+                          unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T> T *ring_field(void *base, uint32_t offset) {
+  return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+} // namespace
+
+IoUring::~IoUring() { release(); }
+
+bool IoUring::supported() {
+  static const bool result = [] {
+    IoUring probe;
+    return probe.init(1);
+  }();
+  return result;
+}
+
+bool IoUring::init(unsigned entries) {
+  release();
+
+  // COOP_TASKRUN：完成事件在下一次 io_uring_enter 时处理，不打断线程（5.19+）；
+  // 旧内核不认识这些标志时不带标志重试
+  io_uring_params params{};
+  params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+  int fd = sys_io_uring_setup(entries, &params);
+  if (fd < 0 && errno == EINVAL) {
+    params = io_uring_params{};
+    fd = sys_io_uring_setup(entries, &params);
+  }
+  if (fd < 0)
+    return false; // ENOSYS（内核不支持）或 EPERM（被禁用）
+  ring_fd_ = fd;
+  sq_entries_ = params.sq_entries;
+
+  sq_ring_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_bytes_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap && cq_ring_bytes_ > sq_ring_bytes_)
+    sq_ring_bytes_ = cq_ring_bytes_;
+
+  sq_ring_ = mmap(nullptr, sq_ring_bytes_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    release();
+    return false;
+  }
+  void *cq_base = sq_ring_;
+  if (!single_mmap) {
+    cq_ring_ = mmap(nullptr, cq_ring_bytes_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      release();
+      return false;
+    }
+    cq_base = cq_ring_;
+  }
+
+  sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_bytes_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    release();
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  sq_head_ = ring_field<unsigned>(sq_ring_, params.sq_off.head);
+  sq_tail_ = ring_field<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = *ring_field<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_array_ = ring_field<unsigned>(sq_ring_, params.sq_off.array);
+  cq_head_ = ring_field<unsigned>(cq_base, params.cq_off.head);
+  cq_tail_ = ring_field<unsigned>(cq_base, params.cq_off.tail);
+  cq_mask_ = *ring_field<unsigned>(cq_base, params.cq_off.ring_mask);
+  cqes_ = ring_field<io_uring_cqe>(cq_base, params.cq_off.cqes);
+
+  // SQ 数组与 SQE 一一对应，之后不再修改
+  for (unsigned i = 0; i < sq_entries_; ++i)
+    sq_array_[i] = i;
+  return true;
+}
+
+void IoUring::release() {
+  if (sqes_)
+    munmap(sqes_, sqes_bytes_);
+  if (cq_ring_)
+    munmap(cq_ring_, cq_ring_bytes_);
+  if (sq_ring_)
+    munmap(sq_ring_, sq_ring_bytes_);
+  if (ring_fd_ != -1)
+    close(ring_fd_);
+  sqes_ = nullptr;
+  cq_ring_ = nullptr;
+  sq_ring_ = nullptr;
+  ring_fd_ = -1;
+  sq_entries_ = 0;
+  pending_ = 0;
+}
+
+bool IoUring::register_buffers(const iovec *iovs, unsigned count) {
+  // 没有注册过时返回 ENXIO，忽略
+  sys_io_uring_register(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+  return sys_io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, iovs,
+                               count) == 0;
+}
+
+bool IoUring::register_sparse_files(unsigned count) {
+  io_uring_rsrc_register reg{};
+  reg.nr = count;
+  reg.flags = IORING_RSRC_REGISTER_SPARSE;
+  return sys_io_uring_register(ring_fd_, IORING_REGISTER_FILES2, &reg,
+                               sizeof(reg)) == 0;
+}
+
+io_uring_sqe *IoUring::get_sqe() {
+  unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  unsigned tail = *sq_tail_ + pending_;
+  if (tail - head >= sq_entries_)
+    return nullptr;
+  io_uring_sqe *sqe = &sqes_[tail & sq_mask_];
+  std::memset(sqe, 0, sizeof(*sqe));
+  ++pending_;
+  return sqe;
+}
+
+int IoUring::submit_and_wait(unsigned wait_nr) {
+  // 发布填充好的 SQE：内核看到新的 tail 之前，SQE 的内容必须已经写完
+  unsigned to_submit = pending_;
+  __atomic_store_n(sq_tail_, *sq_tail_ + pending_, __ATOMIC_RELEASE);
+  pending_ = 0;
+
+  while (true) {
+    int ret = sys_io_uring_enter(ring_fd_, to_submit, wait_nr,
+                                 wait_nr ? IORING_ENTER_GETEVENTS : 0);
+    if (ret >= 0)
+      return ret;
+    // 返回 -EINTR 时本次没有提交任何 SQE（提交成功会返回提交数），原样重试
+    if (errno != EINTR)
+      return -errno;
+  }
+}
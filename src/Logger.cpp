@@ -0,0 +1,199 @@
+#include "Logger.h"
+#include "MpscQueue.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+// 后台线程在队列为空时的休眠间隔，也是异步日志的最大延迟
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(20);
+// 后台线程每次 write() 的批量大小
+constexpr size_t BATCH_BYTES = 64 * 1024;
+
+struct Record {
+  uint16_t len = 0;
+  char text[Logger::RECORD_BYTES];
+};
+
+const char *level_tag(Logger::Level level) {
+  switch (level) {
+  case Logger::Level::DEBUG:
+    return "[DEBUG] ";
+  case Logger::Level::INFO:
+    return "[INFO] ";
+  case Logger::Level::WARNING:
+    return "[WARN] ";
+  case Logger::Level::ERROR:
+    return "[ERROR] ";
+  }
+  return "";
+}
+
+// 把 "[HH:MM:SS] [LEVEL] msg\n" 写入 out，超长时截断，返回字节数
+size_t format_record(Logger::Level level, const std::string &msg, char *out,
+                     size_t cap) {
+  // 每个线程缓存当前秒的 "[HH:MM:SS] "，一秒内只格式化一次
+  thread_local time_t cached_second = -1;
+  thread_local char cached_stamp[16];
+  thread_local size_t cached_len = 0;
+
+  time_t now = std::time(nullptr);
+  if (now != cached_second) {
+    std::tm tm{};
+    localtime_r(&now, &tm);
+    cached_len = std::strftime(cached_stamp, sizeof(cached_stamp),
+                               "[%H:%M:%S] ", &tm);
+    cached_second = now;
+  }
+
+  size_t len = 0;
+  auto append = [&](const char *data, size_t n) {
+    n = std::min(n, cap - 1 - len); // 留一个字节给换行
+    std::memcpy(out + len, data, n);
+    len += n;
+  };
+  append(cached_stamp, cached_len);
+  const char *tag = level_tag(level);
+  append(tag, std::strlen(tag));
+  append(msg.data(), msg.size());
+  out[len++] = '\n';
+  return len;
+}
+
+bool write_all(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+  }
+  return true;
+}
+} // namespace
+
+struct Logger::AsyncSink {
+  explicit AsyncSink(int fd) : fd(fd), queue(QUEUE_RECORDS) {}
+
+  // 后台线程：取出所有记录拼成批量写出，队列空时休眠
+  void run() {
+    std::unique_ptr<char[]> batch(new char[BATCH_BYTES]);
+    uint64_t reported = 0;
+    while (true) {
+      bool stop = stopping.load(std::memory_order_acquire);
+      size_t used = 0;
+      bool any = false;
+      while (queue.pop([&](const Record &rec) {
+        std::memcpy(batch.get() + used, rec.text, rec.len);
+        used += rec.len;
+      })) {
+        any = true;
+        if (used + RECORD_BYTES > BATCH_BYTES) {
+          write_all(fd, batch.get(), used);
+          used = 0;
+        }
+      }
+
+      uint64_t lost = dropped.load(std::memory_order_relaxed);
+      if (lost != reported) {
+        std::string note =
+            "日志队列已满，丢弃 " + std::to_string(lost - reported) + " 条";
+        used += format_record(Level::WARNING, note, batch.get() + used,
+                              BATCH_BYTES - used);
+        reported = lost;
+      }
+      if (used > 0)
+        write_all(fd, batch.get(), used);
+
+      if (stop)
+        break; // stopping 之前入队的记录已经全部写出
+      if (!any)
+        std::this_thread::sleep_for(FLUSH_INTERVAL);
+    }
+  }
+
+  int fd;
+  bool owns_fd = false;
+  MpscQueue<Record> queue;
+  std::atomic<bool> stopping{false};
+  std::atomic<uint64_t> dropped{0};
+  std::thread thread;
+};
+
+Logger::Logger() : current_level_(Level::INFO) {}
+
+Logger::~Logger() { stop_async(); }
+
+bool Logger::start_async(const std::string &path) {
+  if (async_)
+    return true;
+
+  int fd = STDERR_FILENO;
+  if (!path.empty()) {
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd == -1) {
+      LOG_ERROR("无法打开日志文件 " + path + ": " + strerror(errno));
+      return false;
+    }
+  }
+
+  async_ = std::make_unique<AsyncSink>(fd);
+  async_->owns_fd = !path.empty();
+  AsyncSink *sink = async_.get();
+  sink->thread = std::thread([sink] { sink->run(); });
+  active_.store(sink, std::memory_order_release);
+  return true;
+}
+
+void Logger::stop_async() {
+  if (!async_)
+    return;
+  // 先摘下 active_，再等已经拿到队列指针的调用写完：
+  // 两边都是 seq_cst，log() 要么看到 nullptr，要么它的计数在这里可见
+  active_.store(nullptr, std::memory_order_seq_cst);
+  while (writers_.load(std::memory_order_seq_cst) != 0)
+    std::this_thread::yield();
+  async_->stopping.store(true, std::memory_order_release);
+  async_->thread.join();
+  if (async_->owns_fd)
+    close(async_->fd);
+  async_.reset();
+}
+
+uint64_t Logger::dropped() const {
+  return async_ ? async_->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+void Logger::log(Level level, const std::string &msg) {
+  if (!enabled(level))
+    return;
+
+  // 取队列指针之前先登记，stop_async() 等登记清零后才释放队列
+  writers_.fetch_add(1, std::memory_order_seq_cst);
+  if (AsyncSink *sink = active_.load(std::memory_order_seq_cst)) {
+    // 直接格式化到队列的单元格里，不经过临时缓冲区
+    if (!sink->queue.push([&](Record &rec) {
+          rec.len = static_cast<uint16_t>(
+              format_record(level, msg, rec.text, sizeof(rec.text)));
+        }))
+      sink->dropped.fetch_add(1, std::memory_order_relaxed);
+    writers_.fetch_sub(1, std::memory_order_release);
+    return;
+  }
+  writers_.fetch_sub(1, std::memory_order_release);
+
+  char text[RECORD_BYTES];
+  size_t len = format_record(level, msg, text, sizeof(text));
+  std::ostream &out = level >= Level::WARNING ? std::cerr : std::cout;
+  out.write(text, static_cast<std::streamsize>(len));
+  out.flush();
+}
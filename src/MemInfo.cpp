@@ -0,0 +1,54 @@
+#include "MemInfo.h"
+#include "ParseCursor.h"
+#include "PerfectHash.h"
+#include <iterator>
+
+namespace meminfo {
+namespace {
+// 下标与 Field 一致
+constexpr std::string_view KEYS[] = {
+    "MemTotal",       "MemFree",         "MemAvailable",    "MemUsed",
+    "Buffers",        "Cached",          "SwapCached",      "Active",
+    "Inactive",       "Active(anon)",    "Inactive(anon)",  "Active(file)",
+    "Inactive(file)", "Unevictable",     "Mlocked",         "SwapTotal",
+    "SwapFree",       "Zswap",           "Zswapped",        "Dirty",
+    "Writeback",      "FilePages",       "AnonPages",       "Mapped",
+    "Shmem",          "KReclaimable",    "Slab",            "SReclaimable",
+    "SUnreclaim",     "KernelStack",     "ShadowCallStack", "PageTables",
+    "SecPageTables",  "NFS_Unstable",    "Bounce",          "WritebackTmp",
+    "CommitLimit",    "Committed_AS",    "VmallocTotal",    "VmallocUsed",
+    "VmallocChunk",   "Percpu",          "HardwareCorrupted", "AnonHugePages",
+    "ShmemHugePages", "ShmemPmdMapped",  "FileHugePages",   "FilePmdMapped",
+    "CmaTotal",       "CmaFree",         "Unaccepted",      "Balloon",
+    "HugePages_Total", "HugePages_Free", "HugePages_Rsvd",  "HugePages_Surp",
+    "Hugepagesize",   "Hugetlb",         "DirectMap4k",     "DirectMap2M",
+    "DirectMap1G"};
+static_assert(std::size(KEYS) == FIELD_COUNT);
+
+constexpr PerfectHash<std::size(KEYS)> INDEX(KEYS);
+} // namespace
+
+std::string_view key(Field field) { return KEYS[field]; }
+
+void parse(std::string_view raw, uint64_t *values) {
+  ParseCursor cur(raw);
+  std::string_view line;
+  while (cur.next_line(line)) {
+    ParseCursor lc(line);
+    std::string_view name;
+    if (!lc.next_token(name))
+      continue;
+    // 节点文件："Node 0 MemTotal:   6158152 kB"
+    if (name == "Node" && !(lc.skip_tokens(1) && lc.next_token(name)))
+      continue;
+    if (name.empty() || name.back() != ':')
+      continue;
+    name.remove_suffix(1);
+    int field = INDEX.find(name);
+    uint64_t value = 0;
+    if (field >= 0 && lc.parse_u64(value))
+      values[field] = value;
+  }
+}
+
+} // namespace meminfo
@@ -0,0 +1,280 @@
+#include "MetricArchive.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+archive::SegmentHeader *header_of(uint8_t *base) {
+  return reinterpret_cast<archive::SegmentHeader *>(base);
+}
+
+const archive::SegmentHeader *header_of(const uint8_t *base) {
+  return reinterpret_cast<const archive::SegmentHeader *>(base);
+}
+} // namespace
+
+// ==================== SegmentWriter ====================
+bool SegmentWriter::open(const std::string &path, size_t capacity,
+                         int64_t created_ms) {
+  close();
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd_ == -1) {
+    LOG_ERROR("无法创建归档段 " + path + ": " + strerror(errno));
+    return false;
+  }
+  // 预先分配所有块：稀疏文件在磁盘满或超出配额时，第一次写到没有后备块的页
+  // 会触发 SIGBUS 杀死整个进程；在这里失败只是停止归档
+  int err = posix_fallocate(fd_, 0, static_cast<off_t>(capacity));
+  if (err != 0) {
+    LOG_ERROR("为归档段 " + path + " 预留空间失败: " + strerror(err));
+    ::close(fd_);
+    unlink(path.c_str());
+    fd_ = -1;
+    return false;
+  }
+  void *p = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (p == MAP_FAILED) {
+    LOG_ERROR("mmap " + path + " 失败: " + strerror(errno));
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  base_ = static_cast<uint8_t *>(p);
+  capacity_ = capacity;
+  path_ = path;
+
+  archive::SegmentHeader *h = header_of(base_);
+  std::memcpy(h->magic, archive::MAGIC, sizeof(h->magic));
+  h->version = archive::VERSION;
+  h->header_size = sizeof(archive::SegmentHeader);
+  h->capacity = capacity;
+  h->created_ms = created_ms;
+  __atomic_store_n(&h->used, sizeof(archive::SegmentHeader), __ATOMIC_RELEASE);
+  return true;
+}
+
+size_t SegmentWriter::used() const {
+  return base_ ? __atomic_load_n(&header_of(base_)->used, __ATOMIC_ACQUIRE) : 0;
+}
+
+bool SegmentWriter::append(uint32_t type, const void *head, size_t head_len,
+                           const void *body, size_t body_len) {
+  size_t off = used();
+  size_t size = head_len + body_len;
+  size_t end = archive::align8(off + sizeof(archive::RecordHeader) + size);
+  if (!base_ || end > capacity_)
+    return false;
+
+  archive::RecordHeader rh{type, static_cast<uint32_t>(size)};
+  uint8_t *p = base_ + off;
+  std::memcpy(p, &rh, sizeof(rh));
+  std::memcpy(p + sizeof(rh), head, head_len);
+  if (body_len)
+    std::memcpy(p + sizeof(rh) + head_len, body, body_len);
+
+  // 记录内容全部写完后再发布新的长度
+  __atomic_store_n(&header_of(base_)->used, static_cast<uint64_t>(end),
+                   __ATOMIC_RELEASE);
+  return true;
+}
+
+void SegmentWriter::close() {
+  if (!base_)
+    return;
+  size_t end = used();
+  // 封存：先把映射中的脏页写回，再截断并落盘，段文件关闭后即是持久的
+  if (msync(base_, end, MS_SYNC) == -1)
+    LOG_WARN("msync 归档段 " + path_ + " 失败: " + strerror(errno));
+  munmap(base_, capacity_);
+  base_ = nullptr;
+  // 截掉未使用的尾部，读取方看到的文件大小就是有效长度
+  if (ftruncate(fd_, static_cast<off_t>(end)) == -1)
+    LOG_WARN("截断归档段 " + path_ + " 失败: " + strerror(errno));
+  if (fdatasync(fd_) == -1)
+    LOG_WARN("fdatasync 归档段 " + path_ + " 失败: " + strerror(errno));
+  ::close(fd_);
+  fd_ = -1;
+}
+
+// ==================== MetricArchive ====================
+MetricArchive::MetricArchive(std::string dir, size_t segment_bytes)
+    : dir_(std::move(dir)), segment_bytes_(segment_bytes) {}
+
+MetricArchive::~MetricArchive() { flush(); }
+
+void MetricArchive::append(size_t id, const MetricInfo &info,
+                           int64_t timestamp_ms, double value) {
+  if (failed_)
+    return;
+
+  if (id >= streams_.size())
+    streams_.resize(id + 1);
+  Stream &s = streams_[id];
+  if (!s.encoder) {
+    s.buf = std::make_unique<uint8_t[]>(BLOCK_BYTES);
+    s.encoder = std::make_unique<GorillaEncoder>(s.buf.get(), BLOCK_BYTES);
+    s.info = info;
+  }
+
+  GorillaEncoder &enc = *s.encoder;
+  if (enc.count() > 0 &&
+      timestamp_ms - enc.first_timestamp() > MAX_BLOCK_SPAN_MS) {
+    if (!seal(id))
+      return;
+  }
+  if (!enc.append(timestamp_ms, value)) {
+    // 块已满：封存后在新块中重新写入
+    if (!seal(id) || !enc.append(timestamp_ms, value)) {
+      failed_ = true;
+      LOG_ERROR("归档写入失败，停止归档");
+    }
+  }
+}
+
+void MetricArchive::flush() {
+  for (size_t id = 0; id < streams_.size() && !failed_; ++id) {
+    if (streams_[id].encoder && streams_[id].encoder->count() > 0)
+      seal(id);
+  }
+  segment_.close();
+  for (auto &s : streams_)
+    s.defined = false;
+}
+
+bool MetricArchive::seal(size_t id) {
+  GorillaEncoder &enc = *streams_[id].encoder;
+  if (!segment_.is_open() && !roll(enc.first_timestamp()))
+    return false;
+  if (!write_block(id)) {
+    // 当前段已满：换一个新段重试
+    if (!roll(enc.first_timestamp()) || !write_block(id)) {
+      failed_ = true;
+      LOG_ERROR("归档段空间不足，停止归档");
+      return false;
+    }
+  }
+  enc.reset();
+  return true;
+}
+
+bool MetricArchive::write_block(size_t id) {
+  Stream &s = streams_[id];
+  if (!s.defined && !define(id))
+    return false;
+
+  const GorillaEncoder &enc = *s.encoder;
+  archive::BlockRecord b{};
+  b.metric_id = static_cast<uint32_t>(id);
+  b.count = enc.count();
+  b.first_ts = enc.first_timestamp();
+  b.last_ts = enc.last_timestamp();
+  b.bit_count = static_cast<uint32_t>(enc.bit_count());
+  return segment_.append(archive::RECORD_BLOCK, &b, sizeof(b), enc.data(),
+                         enc.byte_count());
+}
+
+bool MetricArchive::define(size_t id) {
+  // 名字和标签都很短，拼接到栈上的缓冲区
+  const MetricInfo &info = streams_[id].info;
+  char text[768];
+  size_t len = info.name.size() + info.label_key.size() + info.label_value.size();
+  if (len > sizeof(text) || info.name.size() > UINT16_MAX) {
+    LOG_WARN("指标名过长，跳过归档: " + info.name);
+    return false;
+  }
+  std::memcpy(text, info.name.data(), info.name.size());
+  std::memcpy(text + info.name.size(), info.label_key.data(),
+              info.label_key.size());
+  std::memcpy(text + info.name.size() + info.label_key.size(),
+              info.label_value.data(), info.label_value.size());
+
+  archive::MetricRecord m{};
+  m.id = static_cast<uint32_t>(id);
+  m.name_len = static_cast<uint16_t>(info.name.size());
+  m.key_len = static_cast<uint16_t>(info.label_key.size());
+  m.value_len = static_cast<uint16_t>(info.label_value.size());
+  if (!segment_.append(archive::RECORD_METRIC, &m, sizeof(m), text, len))
+    return false;
+  streams_[id].defined = true;
+  return true;
+}
+
+bool MetricArchive::roll(int64_t timestamp_ms) {
+  segment_.close();
+  for (auto &s : streams_)
+    s.defined = false;
+
+  // 同一毫秒内多次换段（段太小）时加序号避免重名
+  std::string path = dir_ + "/segment-" + std::to_string(timestamp_ms) + "-" +
+                     std::to_string(segments_created_) + ".smseg";
+  if (!segment_.open(path, segment_bytes_, timestamp_ms)) {
+    failed_ = true;
+    return false;
+  }
+  ++segments_created_;
+  return true;
+}
+
+// ==================== SegmentReader ====================
+SegmentReader::~SegmentReader() {
+  if (base_)
+    munmap(const_cast<uint8_t *>(base_), size_);
+}
+
+bool SegmentReader::open(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    LOG_ERROR("无法打开归档段 " + path + ": " + strerror(errno));
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1 ||
+      static_cast<size_t>(st.st_size) < sizeof(archive::SegmentHeader)) {
+    LOG_ERROR("归档段格式错误: " + path);
+    ::close(fd);
+    return false;
+  }
+  void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                 MAP_SHARED, fd, 0);
+  ::close(fd); // 映射会保持文件打开
+  if (p == MAP_FAILED) {
+    LOG_ERROR("mmap " + path + " 失败: " + strerror(errno));
+    return false;
+  }
+
+  base_ = static_cast<const uint8_t *>(p);
+  size_ = static_cast<size_t>(st.st_size);
+  const archive::SegmentHeader *h = header_of(base_);
+  if (std::memcmp(h->magic, archive::MAGIC, sizeof(h->magic)) != 0 ||
+      h->version != archive::VERSION) {
+    LOG_ERROR("归档段格式错误: " + path);
+    munmap(p, size_);
+    base_ = nullptr;
+    size_ = 0;
+    return false;
+  }
+  return true;
+}
+
+size_t SegmentReader::used() const {
+  if (!base_)
+    return 0;
+  size_t used = __atomic_load_n(&header_of(base_)->used, __ATOMIC_ACQUIRE);
+  return used < size_ ? used : size_;
+}
+
+size_t SegmentReader::find(std::string_view name,
+                           std::string_view label_value) const {
+  size_t found = NOT_FOUND;
+  for_each_metric([&](size_t id, std::string_view n, std::string_view,
+                      std::string_view v) {
+    if (found == NOT_FOUND && n == name && v == label_value)
+      found = id;
+  });
+  return found;
+}
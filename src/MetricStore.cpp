@@ -0,0 +1,140 @@
+#include "MetricStore.h"
+#include <algorithm>
+#include <new>
+
+namespace {
+// 不小于 n 的 2 的幂的指数
+size_t log2_ceil(size_t n) {
+  size_t shift = 0;
+  while ((size_t(1) << shift) < n)
+    ++shift;
+  return shift;
+}
+} // namespace
+
+// ==================== MetricRing ====================
+void MetricRing::AlignedDelete::operator()(void *p) const {
+  ::operator delete[](p, std::align_val_t(CACHE_LINE_SIZE));
+}
+
+MetricRing::MetricRing(size_t capacity, size_t *allocated_bytes)
+    : chunk_shift_(std::min(CHUNK_SHIFT, log2_ceil(std::max<size_t>(capacity, 2)))),
+      chunk_mask_((size_t(1) << chunk_shift_) - 1),
+      capacity_((std::max<size_t>(capacity, 2) + chunk_mask_) & ~chunk_mask_),
+      chunks_(capacity_ >> chunk_shift_), allocated_bytes_(allocated_bytes) {}
+
+size_t MetricRing::array_bytes() const {
+  size_t bytes = (chunk_mask_ + 1) * sizeof(int64_t);
+  return (bytes + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+}
+
+void MetricRing::allocate(Chunk &chunk) {
+  // 一次分配：时间戳数组在前，数值数组从下一个缓存行开始
+  size_t half = array_bytes();
+  void *memory = ::operator new[](half * 2, std::align_val_t(CACHE_LINE_SIZE));
+  chunk.memory.reset(memory);
+  chunk.timestamps = static_cast<int64_t *>(memory);
+  chunk.values = reinterpret_cast<double *>(static_cast<char *>(memory) + half);
+  if (allocated_bytes_)
+    *allocated_bytes_ += half * 2;
+}
+
+size_t MetricRing::memory_bytes() const {
+  size_t chunks = 0;
+  for (const Chunk &chunk : chunks_)
+    chunks += chunk.timestamps ? 1 : 0;
+  return chunks * array_bytes() * 2;
+}
+
+size_t MetricRing::lower_bound(int64_t timestamp_ms) const {
+  size_t lo = 0, hi = size();
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (timestamp_at(mid) < timestamp_ms)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+size_t MetricRing::read_range(int64_t from_ms, int64_t to_ms,
+                              int64_t *timestamps, double *values,
+                              size_t max) const {
+  size_t n = 0;
+  size_t i = lower_bound(from_ms);
+  size_t s = slot(i);
+  // 按块逐段复制：容量是块大小的整数倍，回绕点总在块边界上
+  while (i < size() && n < max) {
+    const Chunk &chunk = chunks_[s >> chunk_shift_];
+    size_t offset = s & chunk_mask_;
+    size_t run = std::min({chunk_mask_ + 1 - offset, size() - i, max - n});
+    for (size_t k = 0; k < run; ++k, ++n) {
+      int64_t ts = chunk.timestamps[offset + k];
+      if (ts > to_ms)
+        return n;
+      timestamps[n] = ts;
+      values[n] = chunk.values[offset + k];
+    }
+    i += run;
+    s += run;
+    if (s == capacity_)
+      s = 0;
+  }
+  return n;
+}
+
+// ==================== MetricStore ====================
+MetricStore::MetricStore(std::chrono::milliseconds retention)
+    : retention_(retention) {}
+
+size_t MetricStore::capacity_for(std::chrono::milliseconds interval) const {
+  auto step = std::max<int64_t>(interval.count(), 1);
+  auto samples = (retention_.count() + step - 1) / step;
+  return static_cast<size_t>(std::max<int64_t>(samples, 2));
+}
+
+std::string MetricStore::make_key(std::string_view name,
+                                  std::string_view label_value) {
+  std::string key(name);
+  key += '\0';
+  key += label_value;
+  return key;
+}
+
+MetricStore::MetricId MetricStore::intern(std::string_view name,
+                                          MetricLabel label, size_t capacity,
+                                          MetricType type) {
+  auto [it, inserted] =
+      index_.try_emplace(make_key(name, label.value), infos_.size());
+  if (!inserted)
+    return it->second;
+
+  infos_.push_back(MetricInfo{std::string(name),
+                              label.key ? std::string(label.key) : std::string(),
+                              std::string(label.value), type});
+  rings_.push_back(std::make_unique<MetricRing>(capacity, &memory_bytes_));
+  return it->second;
+}
+
+MetricStore::MetricId MetricStore::find(std::string_view name,
+                                        std::string_view label_value) const {
+  auto it = index_.find(make_key(name, label_value));
+  return it == index_.end() ? NOT_FOUND : it->second;
+}
+
+// ==================== MetricWriter ====================
+void MetricWriter::write(const char *name, MetricLabel label, double value,
+                         MetricType type) {
+  if (next_ == bindings_.size())
+    bindings_.emplace_back();
+  Binding &b = bindings_[next_++];
+
+  if (b.name != name || b.label_key != label.key || b.label_value != label.value) {
+    b.name = name;
+    b.label_key = label.key;
+    b.label_value.assign(label.value.data(), label.value.size());
+    b.id = store_.intern(name, label, capacity_, type);
+  }
+  store_.push(b.id, timestamp_ms_, value);
+}
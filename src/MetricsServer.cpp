@@ -0,0 +1,336 @@
+#include "MetricsServer.h"
+#include "EventLoop.h"
+#include "Logger.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::string_view NOT_FOUND_RESPONSE =
+    "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n"
+    "Content-Length: 10\r\nConnection: close\r\n\r\nnot found\n";
+
+void append_label_value(std::string &out, std::string_view value) {
+  // 文本格式要求转义反斜杠、双引号和换行；绝大多数标签值不需要转义
+  if (value.find_first_of("\\\"\n") == std::string_view::npos) {
+    out.append(value.data(), value.size());
+    return;
+  }
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      out += '\\';
+      out += c;
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out += c;
+    }
+  }
+}
+
+void append_double(std::string &out, double value) {
+  char buf[32];
+  auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+  if (ec == std::errc())
+    out.append(buf, static_cast<size_t>(ptr - buf));
+  else
+    out += "NaN";
+}
+} // namespace
+
+MetricsServer::MetricsServer(EventLoop &loop) : loop_(loop) {}
+
+MetricsServer::~MetricsServer() {
+  if (sweep_fd_ != -1) {
+    loop_.set_timer(sweep_fd_, std::chrono::nanoseconds(0));
+    loop_.remove(sweep_fd_);
+  }
+  while (!connections_.empty())
+    close_connection(connections_.begin()->first);
+  if (listen_fd_ != -1) {
+    loop_.remove(listen_fd_);
+    close(listen_fd_);
+  }
+}
+
+bool MetricsServer::listen(const std::string &address) {
+  std::string host = "0.0.0.0";
+  std::string_view port_text = address;
+  size_t colon = address.rfind(':');
+  if (colon != std::string::npos) {
+    host = address.substr(0, colon);
+    port_text = std::string_view(address).substr(colon + 1);
+  }
+
+  unsigned port = 0;
+  auto [ptr, ec] = std::from_chars(
+      port_text.data(), port_text.data() + port_text.size(), port);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  if (ec != std::errc() || ptr != port_text.data() + port_text.size() ||
+      port > 65535 || inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    LOG_ERROR("无效的监听地址: " + address);
+    return false;
+  }
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+
+  listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ == -1) {
+    LOG_ERROR(std::string("socket 失败: ") + strerror(errno));
+    return false;
+  }
+  int one = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+          -1 ||
+      ::listen(listen_fd_, 128) == -1) {
+    LOG_ERROR("监听 " + address + " 失败: " + strerror(errno));
+    close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  socklen_t len = sizeof(addr);
+  getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+  port_ = ntohs(addr.sin_port);
+
+  if (!loop_.add(listen_fd_, EPOLLIN, [this](uint32_t) { on_accept(); }))
+    return false;
+  sweep_fd_ = loop_.add_timer(std::chrono::seconds(1),
+                              [this](uint64_t) { close_expired(); });
+  return sweep_fd_ != -1;
+}
+
+void MetricsServer::on_accept() {
+  while (true) {
+    int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        LOG_WARN(std::string("accept 失败: ") + strerror(errno));
+      return;
+    }
+    if (connections_.size() >= MAX_CONNECTIONS && !evict_oldest_reader()) {
+      close(fd);
+      continue;
+    }
+
+    auto conn = std::make_unique<Connection>();
+    conn->fd = fd;
+    conn->deadline = std::chrono::steady_clock::now() + REQUEST_TIMEOUT;
+    if (!loop_.add(fd, EPOLLIN | EPOLLRDHUP,
+                   [this, fd](uint32_t events) { on_event(fd, events); })) {
+      close(fd);
+      continue;
+    }
+    connections_.emplace(fd, std::move(conn));
+  }
+}
+
+void MetricsServer::on_event(int fd, uint32_t events) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end())
+    return;
+  Connection &conn = *it->second;
+
+  if (events & (EPOLLERR | EPOLLHUP)) {
+    close_connection(fd);
+    return;
+  }
+
+  if (!conn.responding) {
+    if (!read_request(conn)) {
+      close_connection(fd);
+      return;
+    }
+    if (!conn.responding)
+      return; // 请求头还没收完
+  }
+
+  if (write_response(conn)) {
+    ++requests_served_;
+    close_connection(fd);
+  }
+}
+
+bool MetricsServer::read_request(Connection &conn) {
+  bool eof = false;
+  while (conn.request_len < sizeof(conn.request)) {
+    ssize_t n = read(conn.fd, conn.request + conn.request_len,
+                     sizeof(conn.request) - conn.request_len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      return false;
+    }
+    if (n == 0) {
+      eof = true; // 半关闭：已经收到的完整请求仍然要响应
+      break;
+    }
+    conn.request_len += static_cast<size_t>(n);
+  }
+
+  std::string_view request(conn.request, conn.request_len);
+  if (request.find("\r\n\r\n") == std::string_view::npos) {
+    // 对方在发完请求前关闭，或请求头超过缓冲区大小：不处理
+    return !eof && conn.request_len < sizeof(conn.request);
+  }
+  start_response(conn);
+  return true;
+}
+
+void MetricsServer::start_response(Connection &conn) {
+  std::string_view request(conn.request, conn.request_len);
+  std::string_view line = request.substr(0, request.find("\r\n"));
+  bool metrics = line.substr(0, 13) == "GET /metrics " ||
+                 line.substr(0, 13) == "GET /metrics?";
+
+  conn.responding = true;
+  conn.sent = 0;
+  if (!metrics || !body_) {
+    std::memcpy(conn.header, NOT_FOUND_RESPONSE.data(), NOT_FOUND_RESPONSE.size());
+    conn.header_len = NOT_FOUND_RESPONSE.size();
+    conn.body.reset();
+  } else {
+    int len = std::snprintf(conn.header, sizeof(conn.header),
+                            "HTTP/1.1 200 OK\r\n"
+                            "Content-Type: text/plain; version=0.0.4\r\n"
+                            "Content-Length: %zu\r\n"
+                            "Connection: close\r\n\r\n",
+                            body_->size());
+    conn.header_len = static_cast<size_t>(len);
+    conn.body = body_; // 引用缓存的响应体，不复制
+  }
+
+  // 不再读取请求体，响应结束前只关心可写事件
+  loop_.modify(conn.fd, EPOLLOUT | EPOLLRDHUP);
+}
+
+bool MetricsServer::write_response(Connection &conn) {
+  size_t body_len = conn.body ? conn.body->size() : 0;
+  size_t total = conn.header_len + body_len;
+
+  while (conn.sent < total) {
+    iovec iov[2];
+    int iovcnt = 0;
+    if (conn.sent < conn.header_len) {
+      iov[iovcnt++] = {conn.header + conn.sent, conn.header_len - conn.sent};
+      if (body_len)
+        iov[iovcnt++] = {const_cast<char *>(conn.body->data()), body_len};
+    } else {
+      size_t off = conn.sent - conn.header_len;
+      iov[iovcnt++] = {const_cast<char *>(conn.body->data()) + off,
+                       body_len - off};
+    }
+
+    ssize_t n = writev(conn.fd, iov, iovcnt);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return false; // 等待下一次 EPOLLOUT
+      conn.sent = total; // 对方已断开：直接结束
+      break;
+    }
+    conn.sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+void MetricsServer::close_connection(int fd) {
+  loop_.remove(fd);
+  close(fd);
+  connections_.erase(fd);
+}
+
+void MetricsServer::close_expired() {
+  auto now = std::chrono::steady_clock::now();
+  std::vector<int> expired;
+  for (auto &[fd, conn] : connections_) {
+    if (now >= conn->deadline)
+      expired.push_back(fd);
+  }
+  for (int fd : expired)
+    close_connection(fd);
+}
+
+bool MetricsServer::evict_oldest_reader() {
+  auto oldest = connections_.end();
+  for (auto it = connections_.begin(); it != connections_.end(); ++it) {
+    if (!it->second->responding &&
+        (oldest == connections_.end() ||
+         it->second->deadline < oldest->second->deadline))
+      oldest = it;
+  }
+  if (oldest == connections_.end())
+    return false;
+  close_connection(oldest->first);
+  return true;
+}
+
+void MetricsServer::rebuild_order(const MetricStore &store) {
+  // 文本格式要求同名指标连续出现：按名字稳定排序，同名的保持创建顺序
+  order_.resize(store.metric_count());
+  for (size_t id = 0; id < order_.size(); ++id)
+    order_[id] = id;
+  std::stable_sort(order_.begin(), order_.end(),
+                   [&store](MetricStore::MetricId a, MetricStore::MetricId b) {
+                     return store.info(a).name < store.info(b).name;
+                   });
+}
+
+void MetricsServer::update(const MetricStore &store) {
+  if (order_.size() != store.metric_count())
+    rebuild_order(store);
+
+  // 复用没有连接引用的旧缓冲区，否则新建一个（慢速连接持有旧的）
+  std::shared_ptr<std::string> target;
+  if (spare_ && spare_.use_count() == 1) {
+    target = std::move(spare_);
+  } else {
+    target = std::make_shared<std::string>();
+    if (body_)
+      target->reserve(body_->capacity());
+  }
+  std::string &out = *target;
+  out.clear();
+
+  const std::string *family = nullptr;
+  for (MetricStore::MetricId id : order_) {
+    const MetricRing &ring = store.ring(id);
+    if (ring.empty())
+      continue;
+    const MetricInfo &info = store.info(id);
+    if (!family || *family != info.name) {
+      family = &info.name;
+      out += "# TYPE ";
+      out += info.name;
+      out += info.type == MetricType::COUNTER ? " counter\n" : " gauge\n";
+    }
+    out += info.name;
+    if (!info.label_key.empty()) {
+      out += '{';
+      out += info.label_key;
+      out += "=\"";
+      append_label_value(out, info.label_value);
+      out += "\"}";
+    }
+    out += ' ';
+    append_double(out, ring.latest_value());
+    out += '\n';
+  }
+
+  spare_ = std::move(body_);
+  body_ = std::move(target);
+}
@@ -0,0 +1,321 @@
+#include "NetlinkCollectors.h"
+#include "CollectorFactory.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <cstring>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// 替代后端：默认实现在 Collectors.cpp 中注册，这里只注册替换项
+REGISTER_COLLECTOR_BACKEND(NetlinkNetworkCollector, "network", "netlink");
+REGISTER_COLLECTOR_BACKEND(ConnectorProcessCollector, "process", "connector");
+
+namespace {
+// 每次 recv 前至少保留的空间：内核一次转储的 skb 不超过 32KB
+constexpr size_t NETLINK_RECV_SPACE = 64 * 1024;
+// proc connector 的接收缓冲区，fork 风暴时能多积压一些事件
+constexpr int CONNECTOR_RCVBUF = 4 * 1024 * 1024;
+} // namespace
+
+// ==================== NetlinkNetworkCollector ====================
+NetlinkNetworkCollector::NetlinkNetworkCollector(const std::string &proc_root)
+    : NetworkCollector(proc_root), buffer_(NETLINK_RECV_SPACE),
+      link_buffer_(NETLINK_RECV_SPACE) {}
+
+NetlinkNetworkCollector::~NetlinkNetworkCollector() {
+  if (fd_ != -1)
+    close(fd_);
+}
+
+bool NetlinkNetworkCollector::open_socket() {
+  fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd_ == -1) {
+    LOG_ERROR(std::string("无法创建 rtnetlink socket: ") + strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool NetlinkNetworkCollector::dump(uint16_t type, const void *body,
+                                   size_t body_len, std::vector<char> &buf,
+                                   size_t &used) {
+  used = 0;
+  if (fd_ == -1 && !open_socket())
+    return false;
+
+  struct {
+    nlmsghdr header;
+    char body[32];
+  } request{};
+  request.header.nlmsg_len = static_cast<uint32_t>(NLMSG_LENGTH(body_len));
+  request.header.nlmsg_type = type;
+  request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  request.header.nlmsg_seq = ++seq_;
+  std::memcpy(request.body, body, body_len);
+
+  if (send(fd_, &request, request.header.nlmsg_len, 0) == -1) {
+    LOG_ERROR(std::string("rtnetlink 请求失败: ") + strerror(errno));
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  // 转储分多个数据报返回，全部收进 buf，直到 NLMSG_DONE
+  bool done = false;
+  while (!done) {
+    if (buf.size() - used < NETLINK_RECV_SPACE)
+      buf.resize(buf.size() * 2); // 接口数量增长后稳定，不再分配
+    ssize_t n = recv(fd_, buf.data() + used, buf.size() - used, 0);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      LOG_ERROR(std::string("接收 rtnetlink 回复失败: ") + strerror(errno));
+      close(fd_); // 转储中断，重新打开以丢弃剩余回复
+      fd_ = -1;
+      used = 0;
+      return false;
+    }
+    int len = static_cast<int>(n);
+    for (auto *nh = reinterpret_cast<nlmsghdr *>(buf.data() + used);
+         NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+      if (nh->nlmsg_seq != seq_)
+        continue;
+      if (nh->nlmsg_type == NLMSG_DONE || nh->nlmsg_type == NLMSG_ERROR)
+        done = true;
+    }
+    used += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+void NetlinkNetworkCollector::refresh_names() {
+  ifinfomsg body{};
+  body.ifi_family = AF_UNSPEC;
+  size_t used = 0;
+  if (!dump(RTM_GETLINK, &body, sizeof(body), link_buffer_, used))
+    return;
+
+  names_.clear();
+  int len = static_cast<int>(used);
+  for (auto *nh = reinterpret_cast<const nlmsghdr *>(link_buffer_.data());
+       NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+    if (nh->nlmsg_type != RTM_NEWLINK || nh->nlmsg_seq != seq_)
+      continue;
+    auto *ifi = static_cast<const ifinfomsg *>(NLMSG_DATA(nh));
+    int attr_len = static_cast<int>(IFLA_PAYLOAD(nh));
+    for (auto *rta = IFLA_RTA(ifi); RTA_OK(rta, attr_len);
+         rta = RTA_NEXT(rta, attr_len)) {
+      if (rta->rta_type == IFLA_IFNAME) {
+        names_[ifi->ifi_index] = static_cast<const char *>(RTA_DATA(rta));
+        break;
+      }
+    }
+  }
+}
+
+void NetlinkNetworkCollector::do_collect() {
+  raw_data_ = {};
+  if_stats_msg body{};
+  body.family = AF_UNSPEC;
+  body.filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64);
+  size_t used = 0;
+  if (!dump(RTM_GETSTATS, &body, sizeof(body), buffer_, used))
+    return;
+  stats_seq_ = seq_;
+  raw_data_ = std::string_view(buffer_.data(), used);
+
+  // 出现未知的 ifindex 或接口数量变化（有接口被删除）时刷新名字表
+  size_t count = 0;
+  bool unknown = false;
+  int len = static_cast<int>(used);
+  for (auto *nh = reinterpret_cast<const nlmsghdr *>(buffer_.data());
+       NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+    if (nh->nlmsg_type != RTM_NEWSTATS)
+      continue;
+    auto *ifsm = static_cast<const if_stats_msg *>(NLMSG_DATA(nh));
+    unknown = unknown || names_.find(static_cast<int>(ifsm->ifindex)) == names_.end();
+    ++count;
+  }
+  if (unknown || count != names_.size())
+    refresh_names();
+}
+
+void NetlinkNetworkCollector::do_parse() {
+  interfaces_.begin_rows();
+  int len = static_cast<int>(raw_data_.size());
+  for (auto *nh = reinterpret_cast<const nlmsghdr *>(raw_data_.data());
+       NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+    if (nh->nlmsg_type != RTM_NEWSTATS || nh->nlmsg_seq != stats_seq_)
+      continue;
+
+    auto *ifsm = static_cast<const if_stats_msg *>(NLMSG_DATA(nh));
+    auto name = names_.find(static_cast<int>(ifsm->ifindex));
+    if (name == names_.end())
+      continue; // 转储之后才出现的接口，下一次采集再显示
+
+    int attr_len = static_cast<int>(nh->nlmsg_len - NLMSG_LENGTH(sizeof(*ifsm)));
+    auto *rta = reinterpret_cast<const rtattr *>(
+        reinterpret_cast<const char *>(ifsm) + NLMSG_ALIGN(sizeof(*ifsm)));
+    const rtattr *stats = nullptr;
+    for (; RTA_OK(rta, attr_len); rta = RTA_NEXT(rta, attr_len)) {
+      if (rta->rta_type == IFLA_STATS_LINK_64) {
+        stats = rta;
+        break;
+      }
+    }
+    if (!stats || RTA_PAYLOAD(stats) < sizeof(rtnl_link_stats64))
+      continue;
+
+    // 属性只保证 4 字节对齐，复制出来再读 64 位字段
+    rtnl_link_stats64 link;
+    std::memcpy(&link, RTA_DATA(stats), sizeof(link));
+
+    uint64_t *counters = interfaces_.row(name->second);
+    counters[RX_BYTES] = link.rx_bytes;
+    counters[TX_BYTES] = link.tx_bytes;
+    counters[RX_PACKETS] = link.rx_packets;
+    counters[TX_PACKETS] = link.tx_packets;
+  }
+  interfaces_.end_rows();
+}
+
+// ==================== ConnectorProcessCollector ====================
+ConnectorProcessCollector::ConnectorProcessCollector(
+    const std::string &proc_root)
+    : ProcessCollector(proc_root),
+      // 事件描述的是本机的进程，注入的 fixture 目录树只能完整扫描
+      use_events_(proc_root == DEFAULT_PROC_ROOT),
+      buffer_(NETLINK_RECV_SPACE) {}
+
+ConnectorProcessCollector::~ConnectorProcessCollector() {
+  if (fd_ != -1)
+    close(fd_);
+}
+
+bool ConnectorProcessCollector::subscribe() {
+  fd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+               NETLINK_CONNECTOR);
+  if (fd_ == -1)
+    return false;
+
+  // 绑定 CN_IDX_PROC 组需要 CAP_NET_ADMIN
+  sockaddr_nl addr{};
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = CN_IDX_PROC;
+  if (bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  // 先试 SO_RCVBUFFORCE（忽略 rmem_max 上限，需要特权），不行就用普通的
+  int rcvbuf = CONNECTOR_RCVBUF;
+  if (setsockopt(fd_, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)))
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+  // nlmsghdr + cn_msg + 操作码（cn_msg 以柔性数组结尾，只能按字节拼）
+  constexpr size_t payload = sizeof(cn_msg) + sizeof(uint32_t);
+  alignas(nlmsghdr) char request[NLMSG_SPACE(payload)] = {};
+  auto *header = reinterpret_cast<nlmsghdr *>(request);
+  header->nlmsg_len = NLMSG_LENGTH(payload);
+  header->nlmsg_type = NLMSG_DONE;
+  auto *message = static_cast<cn_msg *>(NLMSG_DATA(header));
+  message->id.idx = CN_IDX_PROC;
+  message->id.val = CN_VAL_PROC;
+  message->len = sizeof(uint32_t);
+  uint32_t op = PROC_CN_MCAST_LISTEN;
+  std::memcpy(message->data, &op, sizeof(op));
+  if (send(fd_, request, header->nlmsg_len, 0) == -1) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  return true;
+}
+
+bool ConnectorProcessCollector::rescan() {
+  ++rescans_;
+  std::vector<int> pids;
+  if (!scanner().list_pids(pids))
+    return false;
+  live_.clear();
+  live_.insert(pids.begin(), pids.end());
+  exited_.clear();
+  synced_ = true;
+  return true;
+}
+
+bool ConnectorProcessCollector::drain_events() {
+  while (true) {
+    ssize_t n = recv(fd_, buffer_.data(), buffer_.size(), 0);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return true; // 积压的事件处理完了
+      return false;  // ENOBUFS：接收缓冲区溢出，事件已丢失
+    }
+
+    int len = static_cast<int>(n);
+    for (auto *nh = reinterpret_cast<const nlmsghdr *>(buffer_.data());
+         NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+      auto *msg = static_cast<const cn_msg *>(NLMSG_DATA(nh));
+      if (msg->id.idx != CN_IDX_PROC)
+        continue;
+      // 内核和头文件的 proc_event 大小可能不同，按较小的复制
+      proc_event event{};
+      std::memcpy(&event, msg->data,
+                  std::min<size_t>(msg->len, sizeof(event)));
+      ++events_;
+
+      if (event.what == proc_event::PROC_EVENT_FORK) {
+        const auto &fork = event.event_data.fork;
+        if (fork.child_pid == fork.child_tgid)
+          live_.insert(fork.child_tgid);
+      } else if (event.what == proc_event::PROC_EVENT_EXIT) {
+        const auto &exit = event.event_data.exit;
+        if (exit.process_pid == exit.process_tgid)
+          exited_.insert(exit.process_tgid);
+      }
+    }
+  }
+}
+
+void ConnectorProcessCollector::reap_exited() {
+  char name[16];
+  for (auto it = exited_.begin(); it != exited_.end();) {
+    auto [end, ec] = std::to_chars(name, name + sizeof(name) - 1, *it);
+    *end = '\0';
+    if (faccessat(scanner().root_fd(), name, F_OK, 0) == 0) {
+      ++it; // 还没有被父进程回收
+      continue;
+    }
+    live_.erase(*it);
+    it = exited_.erase(it);
+  }
+}
+
+bool ConnectorProcessCollector::list_pids(std::vector<int> &pids) {
+  if (use_events_ && fd_ == -1 && !subscribe()) {
+    LOG_WARN(std::string("无法订阅 proc connector（需要 CAP_NET_ADMIN）: ") +
+             strerror(errno) + "，改为每次完整扫描 /proc");
+    use_events_ = false;
+  }
+  if (!use_events_)
+    return ProcessCollector::list_pids(pids);
+
+  // 先订阅再扫描：扫描期间发生的 fork/exit 留在 socket 里，之后重放是幂等的
+  if ((!synced_ || !drain_events()) && !rescan())
+    return false;
+  reap_exited();
+
+  pids.assign(live_.begin(), live_.end());
+  return true;
+}
@@ -0,0 +1,233 @@
+#include "NumaCollector.h"
+#include "Logger.h"
+#include "ParseCursor.h"
+#include "PerfectHash.h"
+#include <algorithm>
+#include <dirent.h>
+#include <iomanip>
+#include <iterator>
+
+namespace {
+// 下标与 VmstatField 一致
+constexpr std::string_view VMSTAT_KEYS[] = {
+    "pgpgin",         "pgpgout",          "pswpin",
+    "pswpout",        "pgfault",          "pgmajfault",
+    "pgfree",         "pgscan_kswapd",    "pgscan_direct",
+    "pgsteal_kswapd", "pgsteal_direct",   "oom_kill",
+    "numa_hit",       "numa_miss",        "numa_foreign",
+    "numa_interleave", "numa_local",      "numa_other",
+    "numa_pages_migrated", "pgmigrate_success", "thp_fault_alloc",
+    "thp_fault_fallback", "thp_collapse_alloc", "compact_stall",
+    "workingset_refault_anon", "workingset_refault_file"};
+static_assert(std::size(VMSTAT_KEYS) == NumaCollector::VMSTAT_FIELD_COUNT);
+
+// 下标与 NumaStatField 一致
+constexpr std::string_view NUMASTAT_KEYS[] = {
+    "numa_hit",       "numa_miss",  "numa_foreign",
+    "interleave_hit", "local_node", "other_node"};
+static_assert(std::size(NUMASTAT_KEYS) == NumaCollector::NUMASTAT_FIELD_COUNT);
+
+constexpr PerfectHash<std::size(VMSTAT_KEYS)> VMSTAT_INDEX(VMSTAT_KEYS);
+constexpr PerfectHash<std::size(NUMASTAT_KEYS)> NUMASTAT_INDEX(NUMASTAT_KEYS);
+
+// 每个节点发布的 numastat 速率
+constexpr const char *NUMASTAT_METRICS[] = {
+    "numa_node_hit_per_second",        "numa_node_miss_per_second",
+    "numa_node_foreign_per_second",    "numa_node_interleave_per_second",
+    "numa_node_local_per_second",      "numa_node_other_per_second"};
+static_assert(std::size(NUMASTAT_METRICS) == NumaCollector::NUMASTAT_FIELD_COUNT);
+
+// "key value" 逐行解析：认识的键写入 values[下标]
+template <size_t N>
+void parse_counters(std::string_view raw, const PerfectHash<N> &index,
+                    uint64_t *values) {
+  ParseCursor cur(raw);
+  std::string_view line;
+  while (cur.next_line(line)) {
+    ParseCursor lc(line);
+    std::string_view key;
+    uint64_t value = 0;
+    if (!lc.next_token(key))
+      continue;
+    int field = index.find(key);
+    if (field >= 0 && lc.parse_u64(value))
+      values[field] = value;
+  }
+}
+
+// 累计计数的每秒速率；计数回退时为 0
+double counter_rate(uint64_t now, uint64_t prev, double seconds) {
+  return now >= prev && seconds > 0 ? static_cast<double>(now - prev) / seconds
+                                    : 0.0;
+}
+
+void print_kb(std::ostream &out, uint64_t kb) {
+  if (kb >= 1024 * 1024)
+    out << std::setprecision(2) << kb / (1024.0 * 1024.0) << " GB";
+  else
+    out << std::setprecision(1) << kb / 1024.0 << " MB";
+}
+} // namespace
+
+std::string_view NumaCollector::vmstat_key(VmstatField field) {
+  return VMSTAT_KEYS[field];
+}
+
+std::string_view NumaCollector::numastat_key(NumaStatField field) {
+  return NUMASTAT_KEYS[field];
+}
+
+NumaCollector::NumaCollector(const std::string &proc_root,
+                             const std::string &node_root)
+    : vmstat_file_(proc_path(proc_root, VMSTAT_FILE), 8192) {
+  std::vector<int> ids;
+  if (DIR *dir = opendir(node_root.c_str())) {
+    while (dirent *entry = readdir(dir)) {
+      std::string_view name = entry->d_name;
+      int id = 0;
+      if (name.size() > 4 && name.substr(0, 4) == "node" &&
+          std::all_of(name.begin() + 4, name.end(),
+                      [](char c) { return c >= '0' && c <= '9'; }) &&
+          ParseCursor(name.substr(4)).parse_int(id))
+        ids.push_back(id);
+    }
+    closedir(dir);
+  }
+  std::sort(ids.begin(), ids.end());
+
+  node_files_.reserve(ids.size());
+  nodes_.resize(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    std::string id = std::to_string(ids[i]);
+    node_files_.emplace_back(node_root + "/node" + id);
+    nodes_[i].name = id;
+  }
+}
+
+void NumaCollector::prefetch(ProcFileBatch &batch) {
+  batch.add(vmstat_file_);
+  for (NodeFiles &files : node_files_) {
+    batch.add(files.meminfo);
+    batch.add(files.numastat);
+  }
+}
+
+void NumaCollector::do_collect() {
+  raw_data_ = vmstat_file_.read();
+  if (raw_data_.empty() && !warned_) {
+    LOG_ERROR("无法读取 " + vmstat_file_.path());
+    warned_ = true;
+  }
+  for (NodeFiles &files : node_files_) {
+    files.meminfo_raw = files.meminfo.read();
+    files.numastat_raw = files.numastat.read();
+  }
+}
+
+void NumaCollector::parse_vmstat(std::string_view raw, uint64_t *values) {
+  parse_counters(raw, VMSTAT_INDEX, values);
+}
+
+void NumaCollector::parse_numastat(std::string_view raw, uint64_t *values) {
+  parse_counters(raw, NUMASTAT_INDEX, values);
+}
+
+void NumaCollector::do_parse() {
+  parse_vmstat(raw_data_, vmstat_);
+  for (size_t i = 0; i < node_files_.size(); ++i) {
+    meminfo::parse(node_files_[i].meminfo_raw, nodes_[i].meminfo);
+    parse_numastat(node_files_[i].numastat_raw, nodes_[i].numastat);
+  }
+}
+
+void NumaCollector::do_calculate() {
+  auto now = sample_time();
+  double seconds = std::chrono::duration<double>(now - prev_time_).count();
+  has_rates_ = prev_time_ != std::chrono::steady_clock::time_point{};
+  prev_time_ = now;
+
+  for (size_t f = 0; f < VMSTAT_FIELD_COUNT; ++f) {
+    vmstat_rate_[f] =
+        has_rates_ ? counter_rate(vmstat_[f], prev_vmstat_[f], seconds) : 0.0;
+    prev_vmstat_[f] = vmstat_[f];
+  }
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    Node &node = nodes_[i];
+    uint64_t *prev = node_files_[i].prev_numastat;
+    for (size_t f = 0; f < NUMASTAT_FIELD_COUNT; ++f) {
+      node.numastat_rate[f] =
+          has_rates_ ? counter_rate(node.numastat[f], prev[f], seconds) : 0.0;
+      prev[f] = node.numastat[f];
+    }
+  }
+}
+
+void NumaCollector::do_snapshot() {
+  snapshot_.publish([this](Snapshot &snap) {
+    snap.has_rates = has_rates_;
+    std::copy(std::begin(vmstat_), std::end(vmstat_), snap.vmstat);
+    std::copy(std::begin(vmstat_rate_), std::end(vmstat_rate_),
+              snap.vmstat_rate);
+    snap.nodes = nodes_; // 节点数不变，稳定后复用已有的名字缓冲区
+  });
+}
+
+void NumaCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  for (size_t f = 0; f < VMSTAT_FIELD_COUNT; ++f) {
+    out.gauge("vmstat_events_per_second", MetricLabel{"event", VMSTAT_KEYS[f]},
+              snap->vmstat_rate[f]);
+  }
+
+  for (const Node &node : snap->nodes) {
+    MetricLabel label{"node", node.name};
+    out.gauge("numa_node_memory_total_kb", label,
+              static_cast<double>(node.meminfo[meminfo::MEM_TOTAL]));
+    out.gauge("numa_node_memory_used_kb", label,
+              static_cast<double>(node.meminfo[meminfo::MEM_USED]));
+    out.gauge("numa_node_memory_free_kb", label,
+              static_cast<double>(node.meminfo[meminfo::MEM_FREE]));
+    out.gauge("numa_node_file_pages_kb", label,
+              static_cast<double>(node.meminfo[meminfo::FILE_PAGES]));
+    out.gauge("numa_node_anon_pages_kb", label,
+              static_cast<double>(node.meminfo[meminfo::ANON_PAGES]));
+    out.gauge("numa_node_hugepages_total", label,
+              static_cast<double>(node.meminfo[meminfo::HUGEPAGES_TOTAL]));
+    out.gauge("numa_node_hugepages_free", label,
+              static_cast<double>(node.meminfo[meminfo::HUGEPAGES_FREE]));
+    for (size_t f = 0; f < NUMASTAT_FIELD_COUNT; ++f) {
+      out.gauge(NUMASTAT_METRICS[f], label, node.numastat_rate[f]);
+    }
+  }
+}
+
+void NumaCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  const double *rate = snap->vmstat_rate;
+  out << "内存详情:\n" << std::fixed << std::setprecision(1);
+  out << "  缺页:     " << rate[PGFAULT] << "/s  主缺页 " << rate[PGMAJFAULT]
+      << "/s  换入 " << rate[PSWPIN] << "/s  换出 " << rate[PSWPOUT] << "/s\n";
+  out << "  回收:     kswapd " << rate[PGSCAN_KSWAPD] << "/s  直接 "
+      << rate[PGSCAN_DIRECT] << "/s  压缩停顿 " << rate[COMPACT_STALL]
+      << "/s  OOM kill " << snap->vmstat[OOM_KILL] << '\n';
+
+  for (const Node &node : snap->nodes) {
+    const uint64_t *m = node.meminfo;
+    out << "  节点 " << std::left << std::setw(4) << node.name << std::right
+        << "总 ";
+    print_kb(out, m[meminfo::MEM_TOTAL]);
+    out << "  已用 ";
+    print_kb(out, m[meminfo::MEM_USED]);
+    out << "  空闲 ";
+    print_kb(out, m[meminfo::MEM_FREE]);
+    out << "  大页 " << m[meminfo::HUGEPAGES_FREE] << "/" << m[meminfo::HUGEPAGES_TOTAL]
+        << std::setprecision(1) << "  本地 "
+        << node.numastat_rate[NODE_LOCAL_NODE] << "/s  跨节点 "
+        << node.numastat_rate[NODE_OTHER_NODE] << "/s  未命中 "
+        << node.numastat_rate[NODE_NUMA_MISS] << "/s\n";
+  }
+}
@@ -0,0 +1,258 @@
+#include "Options.h"
+#include "PressureCollector.h"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+namespace {
+void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  --top N        进程列表显示前 N 个 (默认 5)\n"
+            << "  --threads N    线程下钻：Top N 进程各显示 CPU 最高的 N 个线程 (默认 0 关闭)\n"
+            << "  --scan-threads N  并行扫描 /proc 的线程数 (默认 1)\n"
+            << "  --jobs N       并发执行采集器的线程数 (默认自动, 1 为顺序执行)\n"
+            << "  --interval SPEC  采样周期(毫秒)，如 500 或 cpu=100,process=5000\n"
+            << "  --stats        显示各采集器阶段耗时 (p50/p99/max) 和每 tick 分配次数\n"
+            << "  --proc-root DIR  从 DIR 而不是 /proc 读取数据 (用于 fixture/调试)\n"
+            << "  --cgroup-root DIR  cgroup v2 挂载点 (默认自动查找 /sys/fs/cgroup)\n"
+            << "  --headless     不显示画面，样本写入内存中的环形缓冲区\n"
+            << "  --retention T  headless 模式保留的时长，如 3600、30m、6h (默认 1h)\n"
+            << "  --archive DIR  把样本压缩写入 DIR 下的 mmap 段文件 (用于事后分析)\n"
+            << "  --listen ADDR  在 [HOST:]PORT 上提供 Prometheus /metrics 端点\n"
+            << "  --push ADDR    把每个 tick 变化的指标推给 HOST:PORT 上的汇聚端\n"
+            << "  --host-name NAME  推送时使用的主机名 (默认 gethostname)\n"
+            << "  --aggregate ADDR  汇聚模式：在 [HOST:]PORT 上接收多台主机的推送\n"
+            << "  --record FILE  把采集器每个 tick 的原始输入记录到 FILE (用于 --replay)\n"
+            << "  --replay FILE  以最快速度回放 FILE 中记录的输入，报告 ticks/s 和各阶段耗时\n"
+            << "  --backend SPEC  采集器后端，如 network=netlink,process=connector\n"
+            << "  --collectors LIST  只启用列出的采集器，如 cpu,memory (默认全部)\n"
+            << "  --cpu-budget PCT  自适应采样：主机繁忙时把自身 CPU 控制在单核的 PCT% 以内\n"
+            << "  --hot-cpu PCT  主机 CPU 使用率达到 PCT% 视为繁忙 (默认 90)\n"
+            << "  --hot-load N   1 分钟负载 / CPU 数达到 N 视为繁忙 (默认 1.0)\n"
+            << "  --psi-trigger SPEC  PSI 触发器，如 \"some 150000 1000000\" (默认)，off 关闭\n"
+            << "  --burst-interval MS  PSI 触发后的采样周期 (默认 100)\n"
+            << "  --burst-duration MS  每次触发后高频采样的时长 (默认 2000)\n"
+            << "  --io-uring     用 io_uring 批量读取 /proc，内核不支持时退回 pread\n"
+            << "  --log-file PATH  日志由后台线程异步写入 PATH (默认 stderr)\n"
+            << "  -h, --help     显示帮助\n";
+}
+
+// 取出 "--name=value" 或 "--name value" 形式的参数值
+bool option_value(std::string_view name, int argc, char *argv[], int &i,
+                  std::string_view &value) {
+  std::string_view arg = argv[i];
+  if (arg.substr(0, name.size()) != name)
+    return false;
+  if (arg.size() == name.size()) {
+    if (i + 1 >= argc)
+      return false;
+    value = argv[++i];
+    return true;
+  }
+  if (arg[name.size()] != '=')
+    return false;
+  value = arg.substr(name.size() + 1);
+  return true;
+}
+
+bool parse_size(std::string_view text, size_t &out) {
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+  return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+// 非负小数，如 "0.5"
+bool parse_double(std::string_view text, double &out) {
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+  return ec == std::errc() && ptr == text.data() + text.size() && out >= 0;
+}
+
+// "3600"、"3600s"、"30m" 或 "6h"，结果为秒
+bool parse_duration(std::string_view text, size_t &seconds) {
+  size_t scale = 1;
+  if (!text.empty() && std::string_view("smh").find(text.back()) !=
+                           std::string_view::npos) {
+    scale = text.back() == 'h' ? 3600 : text.back() == 'm' ? 60 : 1;
+    text.remove_suffix(1);
+  }
+  if (!parse_size(text, seconds) || seconds == 0)
+    return false;
+  seconds *= scale;
+  return true;
+}
+
+// "500" 或 "cpu=100,process=5000"
+bool parse_intervals(std::string_view spec,
+                     std::vector<IntervalOverride> &out) {
+  while (!spec.empty()) {
+    size_t comma = spec.find(',');
+    std::string_view item = spec.substr(0, comma);
+    spec = comma == std::string_view::npos ? std::string_view()
+                                           : spec.substr(comma + 1);
+
+    IntervalOverride entry;
+    size_t eq = item.find('=');
+    if (eq != std::string_view::npos) {
+      entry.collector = std::string(item.substr(0, eq));
+      item = item.substr(eq + 1);
+    }
+    if (!parse_size(item, entry.interval_ms) || entry.interval_ms == 0)
+      return false;
+    out.push_back(std::move(entry));
+  }
+  return true;
+}
+
+// "network=netlink,process=connector"
+bool parse_backends(std::string_view spec, std::vector<BackendOverride> &out) {
+  while (!spec.empty()) {
+    size_t comma = spec.find(',');
+    std::string_view item = spec.substr(0, comma);
+    spec = comma == std::string_view::npos ? std::string_view()
+                                           : spec.substr(comma + 1);
+
+    size_t eq = item.find('=');
+    if (eq == std::string_view::npos || eq == 0 || eq + 1 == item.size())
+      return false;
+    out.push_back(BackendOverride{std::string(item.substr(0, eq)),
+                                  std::string(item.substr(eq + 1))});
+  }
+  return true;
+}
+// "cpu,memory"
+bool parse_names(std::string_view spec, std::vector<std::string> &out) {
+  while (!spec.empty()) {
+    size_t comma = spec.find(',');
+    std::string_view item = spec.substr(0, comma);
+    spec = comma == std::string_view::npos ? std::string_view()
+                                           : spec.substr(comma + 1);
+    if (item.empty())
+      return false;
+    out.emplace_back(item);
+  }
+  return !out.empty();
+}
+} // namespace
+
+ParseResult parse_options(int argc, char *argv[], MonitorOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    std::string_view value;
+
+    if (arg == "-h" || arg == "--help") {
+      print_usage(argv[0]);
+      return ParseResult::HELP;
+    } else if (arg == "--stats") {
+      options.stats = true;
+    } else if (arg == "--headless") {
+      options.headless = true;
+    } else if (arg == "--io-uring") {
+      options.io_uring = true;
+    } else if (option_value("--top", argc, argv, i, value)) {
+      if (!parse_size(value, options.top_n) || options.top_n == 0) {
+        std::cerr << "无效的 --top 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--threads", argc, argv, i, value)) {
+      if (!parse_size(value, options.thread_top)) {
+        std::cerr << "无效的 --threads 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--scan-threads", argc, argv, i, value)) {
+      if (!parse_size(value, options.scan_threads) ||
+          options.scan_threads == 0) {
+        std::cerr << "无效的 --scan-threads 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--jobs", argc, argv, i, value)) {
+      if (!parse_size(value, options.jobs)) {
+        std::cerr << "无效的 --jobs 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--interval", argc, argv, i, value)) {
+      if (!parse_intervals(value, options.intervals)) {
+        std::cerr << "无效的 --interval 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--retention", argc, argv, i, value)) {
+      if (!parse_duration(value, options.retention_s)) {
+        std::cerr << "无效的 --retention 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--backend", argc, argv, i, value)) {
+      if (!parse_backends(value, options.backends)) {
+        std::cerr << "无效的 --backend 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--collectors", argc, argv, i, value)) {
+      if (!parse_names(value, options.collectors)) {
+        std::cerr << "无效的 --collectors 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--cpu-budget", argc, argv, i, value)) {
+      if (!parse_double(value, options.cpu_budget) || options.cpu_budget == 0) {
+        std::cerr << "无效的 --cpu-budget 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--hot-cpu", argc, argv, i, value)) {
+      if (!parse_double(value, options.hot_cpu)) {
+        std::cerr << "无效的 --hot-cpu 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--hot-load", argc, argv, i, value)) {
+      if (!parse_double(value, options.hot_load)) {
+        std::cerr << "无效的 --hot-load 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--psi-trigger", argc, argv, i, value)) {
+      bool full = false;
+      uint64_t threshold_us = 0, window_us = 0;
+      if (value == "off") {
+        options.psi_trigger.clear();
+      } else if (PressureCollector::parse_trigger(value, full, threshold_us,
+                                                  window_us)) {
+        options.psi_trigger = std::string(value);
+      } else {
+        std::cerr << "无效的 --psi-trigger 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--burst-interval", argc, argv, i, value)) {
+      if (!parse_size(value, options.burst_interval_ms) ||
+          options.burst_interval_ms == 0) {
+        std::cerr << "无效的 --burst-interval 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--burst-duration", argc, argv, i, value)) {
+      if (!parse_size(value, options.burst_duration_ms) ||
+          options.burst_duration_ms == 0) {
+        std::cerr << "无效的 --burst-duration 参数: " << value << std::endl;
+        return ParseResult::INVALID;
+      }
+    } else if (option_value("--archive", argc, argv, i, value)) {
+      options.archive_dir = std::string(value);
+    } else if (option_value("--listen", argc, argv, i, value)) {
+      options.listen = std::string(value);
+    } else if (option_value("--push", argc, argv, i, value)) {
+      options.push = std::string(value);
+    } else if (option_value("--host-name", argc, argv, i, value)) {
+      options.host_name = std::string(value);
+    } else if (option_value("--aggregate", argc, argv, i, value)) {
+      options.aggregate = std::string(value);
+    } else if (option_value("--record", argc, argv, i, value)) {
+      options.record = std::string(value);
+    } else if (option_value("--replay", argc, argv, i, value)) {
+      options.replay = std::string(value);
+    } else if (option_value("--log-file", argc, argv, i, value)) {
+      options.log_file = std::string(value);
+    } else if (option_value("--proc-root", argc, argv, i, value)) {
+      options.proc_root = std::string(value);
+    } else if (option_value("--cgroup-root", argc, argv, i, value)) {
+      options.cgroup_root = std::string(value);
+    } else {
+      std::cerr << "未知参数: " << arg << std::endl;
+      print_usage(argv[0]);
+      return ParseResult::INVALID;
+    }
+  }
+  return ParseResult::RUN;
+}
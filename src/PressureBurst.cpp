@@ -0,0 +1,81 @@
+#include "PressureBurst.h"
+#include "Logger.h"
+#include <algorithm>
+#include <sys/epoll.h>
+
+PressureBurst::PressureBurst(EventLoop &loop, PressureCollector &pressure,
+                             std::vector<Collector *> targets,
+                             std::vector<Collector *> &due,
+                             const Config &config)
+    : loop_(loop), pressure_(pressure), targets_(std::move(targets)), due_(due),
+      config_(config) {}
+
+PressureBurst::~PressureBurst() {
+  // 触发器 fd 属于 PressureCollector，事件循环可能比它活得久
+  for (int fd : registered_)
+    loop_.remove(fd);
+}
+
+bool PressureBurst::start(std::string_view trigger_spec) {
+  if (pressure_.arm_triggers(trigger_spec) == 0)
+    return false;
+  tfd_ = loop_.add_timer(config_.interval, [this](uint64_t) { on_tick(); },
+                         false);
+  if (tfd_ == -1)
+    return false;
+  for (int r = 0; r < PressureCollector::RESOURCE_COUNT; ++r) {
+    auto resource = static_cast<PressureCollector::Resource>(r);
+    int fd = pressure_.trigger_fd(resource);
+    if (fd < 0)
+      continue;
+    if (loop_.add(fd, EPOLLPRI, [this, resource](uint32_t events) {
+          on_trigger(resource, events);
+        }))
+      registered_.push_back(fd);
+  }
+  return !registered_.empty();
+}
+
+void PressureBurst::on_trigger(PressureCollector::Resource resource,
+                               uint32_t events) {
+  if (events & EPOLLERR) {
+    // 监视的对象消失了（只会出现在 cgroup 的 pressure 文件上）
+    int fd = pressure_.trigger_fd(resource);
+    loop_.remove(fd);
+    registered_.erase(std::remove(registered_.begin(), registered_.end(), fd),
+                      registered_.end());
+    pressure_.disarm(resource);
+    return;
+  }
+  pressure_.record_trigger(resource);
+  until_ = std::chrono::steady_clock::now() + config_.duration;
+  if (!active_) {
+    active_ = true;
+    ++bursts_;
+    loop_.set_timer(tfd_, config_.interval);
+    LOG_INFO(std::string("PSI 触发 (") +
+             PressureCollector::resource_name(resource) + ")，开始突发采样");
+  }
+  // 不等第一个高频 tick，本轮就采样
+  schedule_targets();
+}
+
+void PressureBurst::on_tick() {
+  if (std::chrono::steady_clock::now() >= until_) {
+    active_ = false;
+    loop_.set_timer(tfd_, std::chrono::nanoseconds(0));
+    return;
+  }
+  schedule_targets();
+}
+
+void PressureBurst::schedule_targets() {
+  ++burst_ticks_;
+  due_.insert(due_.end(), targets_.begin(), targets_.end());
+}
+
+void PressureBurst::print(std::ostream &out) const {
+  out << "  PSI 突发采样: " << (active_ ? "进行中" : "空闲") << " (已触发 "
+      << bursts_ << " 次, 共 " << burst_ticks_ << " 个高频 tick, 间隔 "
+      << config_.interval.count() << " ms)\n";
+}
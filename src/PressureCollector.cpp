@@ -0,0 +1,255 @@
+#include "PressureCollector.h"
+#include "Logger.h"
+#include "ParseCursor.h"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <unistd.h>
+
+namespace {
+constexpr const char *PRESSURE_FILES[] = {"pressure/cpu", "pressure/memory",
+                                          "pressure/io"};
+// 没有 CAP_SYS_RESOURCE 时触发器窗口必须是它的整数倍
+constexpr uint64_t UNPRIVILEGED_WINDOW_US = 2000000;
+
+template <typename T> bool parse_field(std::string_view text, T &value) {
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return ec == std::errc();
+}
+
+// "some avg10=4.01 avg60=2.79 avg300=2.22 total=213094129"
+void parse_stall(ParseCursor &line, PressureCollector::Stall &stall) {
+  std::string_view token;
+  stall.present = true;
+  while (line.next_token(token)) {
+    size_t eq = token.find('=');
+    if (eq == std::string_view::npos)
+      continue;
+    std::string_view key = token.substr(0, eq);
+    std::string_view value = token.substr(eq + 1);
+    if (key == "avg10")
+      parse_field(value, stall.avg10);
+    else if (key == "avg60")
+      parse_field(value, stall.avg60);
+    else if (key == "avg300")
+      parse_field(value, stall.avg300);
+    else if (key == "total")
+      parse_field(value, stall.total_us);
+  }
+}
+
+void print_stall(std::ostream &out, const char *kind,
+                 const PressureCollector::Stall &stall) {
+  out << kind << std::setw(8) << stall.avg10 << "%" << std::setw(8)
+      << stall.avg60 << "%" << std::setw(8) << stall.avg300 << "%   当前"
+      << std::setw(8) << stall.percent << "%\n";
+}
+} // namespace
+
+const char *PressureCollector::resource_name(Resource resource) {
+  static const char *names[] = {"cpu", "memory", "io"};
+  return names[resource];
+}
+
+PressureCollector::PressureCollector(const std::string &proc_root)
+    : proc_root_(proc_root),
+      files_{ProcFile(proc_path(proc_root, PRESSURE_FILES[CPU]), 256),
+             ProcFile(proc_path(proc_root, PRESSURE_FILES[MEMORY]), 256),
+             ProcFile(proc_path(proc_root, PRESSURE_FILES[IO]), 256)} {}
+
+PressureCollector::~PressureCollector() {
+  for (int fd : trigger_fds_) {
+    if (fd >= 0)
+      close(fd);
+  }
+}
+
+void PressureCollector::prefetch(ProcFileBatch &batch) {
+  for (ProcFile &file : files_)
+    batch.add(file);
+}
+
+bool PressureCollector::parse_trigger(std::string_view spec, bool &full,
+                                      uint64_t &threshold_us,
+                                      uint64_t &window_us) {
+  ParseCursor cur(spec);
+  std::string_view state;
+  if (!cur.next_token(state) || (state != "some" && state != "full"))
+    return false;
+  full = state == "full";
+  if (!cur.parse_u64(threshold_us) || !cur.parse_u64(window_us))
+    return false;
+  cur.skip_ws();
+  return cur.eof() && threshold_us > 0 && threshold_us <= window_us;
+}
+
+bool PressureCollector::write_trigger(Resource resource,
+                                      const std::string &spec) {
+  int fd = open(proc_path(proc_root_, PRESSURE_FILES[resource]).c_str(),
+                O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  // 内核要求写入内容以 '\0' 结尾
+  if (write(fd, spec.c_str(), spec.size() + 1) < 0) {
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return false;
+  }
+  trigger_fds_[resource] = fd;
+  return true;
+}
+
+size_t PressureCollector::arm_triggers(std::string_view spec) {
+  bool full = false;
+  uint64_t threshold_us = 0, window_us = 0;
+  if (!parse_trigger(spec, full, threshold_us, window_us))
+    return 0;
+
+  std::string text(spec);
+  size_t armed = 0;
+  for (int r = 0; r < RESOURCE_COUNT; ++r) {
+    auto resource = static_cast<Resource>(r);
+    if (write_trigger(resource, text)) {
+      ++armed;
+      continue;
+    }
+    if (errno == EINVAL && window_us % UNPRIVILEGED_WINDOW_US != 0) {
+      // 非特权进程：窗口取整到 2 秒的倍数，阈值保持同样的比例
+      uint64_t window = (window_us / UNPRIVILEGED_WINDOW_US + 1) *
+                        UNPRIVILEGED_WINDOW_US;
+      std::string scaled = std::string(full ? "full " : "some ") +
+                           std::to_string(threshold_us * window / window_us) +
+                           " " + std::to_string(window);
+      if (write_trigger(resource, scaled)) {
+        LOG_INFO("PSI 触发器 \"" + text + "\" 需要 CAP_SYS_RESOURCE，改用 \"" +
+                 scaled + "\"");
+        text = scaled;
+        threshold_us = threshold_us * window / window_us;
+        window_us = window;
+        ++armed;
+        continue;
+      }
+    }
+    LOG_WARN(std::string("无法注册 PSI 触发器 ") + PRESSURE_FILES[resource] +
+             ": " + strerror(errno));
+  }
+  if (armed)
+    trigger_spec_ = text;
+  return armed;
+}
+
+void PressureCollector::disarm(Resource resource) {
+  if (trigger_fds_[resource] < 0)
+    return;
+  close(trigger_fds_[resource]);
+  trigger_fds_[resource] = -1;
+  LOG_WARN(std::string("PSI 触发器 ") + resource_name(resource) + " 失效");
+}
+
+void PressureCollector::do_collect() {
+  bool any = false;
+  for (int r = 0; r < RESOURCE_COUNT; ++r) {
+    raw_[r] = files_[r].read();
+    available_[r] = !raw_[r].empty();
+    any = any || available_[r];
+  }
+  if (!any && !warned_) {
+    warned_ = true;
+    LOG_WARN("无法读取 " + files_[CPU].path() + "，内核可能没有启用 PSI");
+  }
+}
+
+void PressureCollector::do_parse() {
+  for (int r = 0; r < RESOURCE_COUNT; ++r) {
+    some_[r] = Stall{};
+    full_[r] = Stall{};
+    ParseCursor cur(raw_[r]);
+    std::string_view text;
+    while (cur.next_line(text)) {
+      ParseCursor line(text);
+      std::string_view kind;
+      if (!line.next_token(kind))
+        continue;
+      if (kind == "some")
+        parse_stall(line, some_[r]);
+      else if (kind == "full")
+        parse_stall(line, full_[r]);
+    }
+  }
+}
+
+void PressureCollector::do_calculate() {
+  auto now = std::chrono::steady_clock::now();
+  double elapsed_us = 0.0;
+  if (prev_time_ != std::chrono::steady_clock::time_point{}) {
+    elapsed_us = std::chrono::duration<double, std::micro>(now - prev_time_).count();
+  }
+  auto rate = [elapsed_us](Stall &stall, uint64_t &prev) {
+    if (elapsed_us > 0 && stall.total_us >= prev)
+      stall.percent = 100.0 * static_cast<double>(stall.total_us - prev) / elapsed_us;
+    prev = stall.total_us;
+  };
+  for (int r = 0; r < RESOURCE_COUNT; ++r) {
+    rate(some_[r], prev_some_us_[r]);
+    rate(full_[r], prev_full_us_[r]);
+  }
+  prev_time_ = now;
+}
+
+void PressureCollector::do_snapshot() {
+  snapshot_.publish([this](Snapshot &snap) {
+    for (int r = 0; r < RESOURCE_COUNT; ++r) {
+      snap.available[r] = available_[r];
+      snap.some[r] = some_[r];
+      snap.full[r] = full_[r];
+      snap.triggers[r] = triggers_[r];
+    }
+    if (snap.trigger_spec != trigger_spec_)
+      snap.trigger_spec = trigger_spec_;
+  });
+}
+
+void PressureCollector::do_publish(MetricWriter &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  for (int r = 0; r < RESOURCE_COUNT; ++r) {
+    if (!snap->available[r])
+      continue;
+    MetricLabel resource{"resource", resource_name(static_cast<Resource>(r))};
+    out.gauge("psi_some_avg10_percent", resource, snap->some[r].avg10);
+    out.gauge("psi_some_percent", resource, snap->some[r].percent);
+    if (snap->full[r].present) {
+      out.gauge("psi_full_avg10_percent", resource, snap->full[r].avg10);
+      out.gauge("psi_full_percent", resource, snap->full[r].percent);
+    }
+    out.counter("psi_triggers", resource, static_cast<double>(snap->triggers[r]));
+  }
+}
+
+void PressureCollector::print_result(std::ostream &out) const {
+  auto snap = snapshot_.read();
+  if (!snap)
+    return;
+  out << "压力停顿 (PSI, avg10/avg60/avg300):\n" << std::fixed
+      << std::setprecision(2);
+  for (int r = 0; r < RESOURCE_COUNT; ++r) {
+    out << "  " << std::left << std::setw(8)
+        << resource_name(static_cast<Resource>(r)) << std::right;
+    if (!snap->available[r]) {
+      out << "不可用\n";
+      continue;
+    }
+    print_stall(out, "some", snap->some[r]);
+    if (snap->full[r].present)
+      print_stall(out << "          ", "full", snap->full[r]);
+  }
+  if (!snap->trigger_spec.empty()) {
+    out << "  触发器 \"" << snap->trigger_spec << "\": cpu " << snap->triggers[CPU]
+        << " 次, memory " << snap->triggers[MEMORY] << " 次, io "
+        << snap->triggers[IO] << " 次\n";
+  }
+}
@@ -0,0 +1,169 @@
+#include "ProcFile.h"
+#include "IoUring.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utility>
+
+ProcFile::ProcFile(std::string path, size_t initial_capacity)
+    : path_(std::move(path)),
+      buffer_(std::max<size_t>(initial_capacity, 64) + 1) {}
+
+ProcFile::~ProcFile() { close(); }
+
+ProcFile::ProcFile(ProcFile &&other) noexcept
+    : path_(std::move(other.path_)), fd_(other.fd_),
+      buffer_(std::move(other.buffer_)), prefetched_(other.prefetched_),
+      batch_index_(other.batch_index_) {
+  other.fd_ = -1;
+  other.prefetched_ = -1;
+  other.batch_index_ = -1;
+}
+
+ProcFile &ProcFile::operator=(ProcFile &&other) noexcept {
+  if (this != &other) {
+    close();
+    path_ = std::move(other.path_);
+    fd_ = other.fd_;
+    buffer_ = std::move(other.buffer_);
+    prefetched_ = other.prefetched_;
+    batch_index_ = other.batch_index_;
+    other.fd_ = -1;
+    other.prefetched_ = -1;
+    other.batch_index_ = -1;
+  }
+  return *this;
+}
+
+bool ProcFile::open() {
+  fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ == -1) {
+    LOG_DEBUG("打开 " + path_ + " 失败: " + strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void ProcFile::close() {
+  if (fd_ != -1) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+std::string_view ProcFile::read() {
+  // 已经由 ProcFileBatch 读好（ProcFileBatch 不会记录读满缓冲区的结果）
+  if (prefetched_ >= 0) {
+    size_t n = static_cast<size_t>(prefetched_);
+    prefetched_ = -1;
+    buffer_[n] = '\0';
+    return std::string_view(buffer_.data(), n);
+  }
+
+  if (fd_ == -1 && !open())
+    return {};
+
+  bool reopened = false;
+  while (true) {
+    // 预留一个字节放 '\0'
+    size_t capacity = buffer_.size() - 1;
+    ssize_t n = ::pread(fd_, buffer_.data(), capacity, 0);
+
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      // 文件被删除或 fd 失效：重新打开一次
+      if (reopened)
+        return {};
+      close();
+      if (!open())
+        return {};
+      reopened = true;
+      continue;
+    }
+
+    if (static_cast<size_t>(n) == capacity) {
+      // 缓冲区可能不够，翻倍后从头重读以保证内容一致
+      buffer_.resize(capacity * 2 + 1);
+      continue;
+    }
+
+    buffer_[n] = '\0';
+    return std::string_view(buffer_.data(), static_cast<size_t>(n));
+  }
+}
+
+// ==================== ProcFileBatch ====================
+ProcFileBatch::ProcFileBatch() : ring_(std::make_unique<IoUring>()) {}
+
+ProcFileBatch::~ProcFileBatch() = default;
+
+bool ProcFileBatch::init() { return ring_->init(64); }
+
+void ProcFileBatch::add(ProcFile &file) {
+  if (!ring_->ready() || (file.fd_ == -1 && !file.open()))
+    return; // read() 会照常重试打开并报告错误
+
+  if (file.batch_index_ < 0) {
+    file.batch_index_ = static_cast<int>(registered_.size());
+    registered_.push_back(&file);
+    iovs_.push_back(iovec{});
+  }
+  // 缓冲区扩容后地址和大小都会变化
+  iovec &iov = iovs_[file.batch_index_];
+  if (iov.iov_base != file.buffer_.data() ||
+      iov.iov_len != file.buffer_.size()) {
+    iov = iovec{file.buffer_.data(), file.buffer_.size()};
+    dirty_ = true;
+  }
+  pending_.push_back(&file);
+}
+
+void ProcFileBatch::submit() {
+  if (pending_.empty())
+    return;
+  if (dirty_) {
+    if (!ring_->register_buffers(iovs_.data(),
+                                 static_cast<unsigned>(iovs_.size()))) {
+      LOG_WARN(std::string("io_uring 注册缓冲区失败: ") + strerror(errno));
+      pending_.clear(); // 本次全部走 pread
+      return;
+    }
+    dirty_ = false;
+  }
+
+  size_t queued = 0;
+  for (ProcFile *file : pending_) {
+    io_uring_sqe *sqe = ring_->get_sqe();
+    if (!sqe)
+      break; // 超出的文件走 pread
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = file->fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(file->buffer_.data());
+    sqe->len = static_cast<uint32_t>(file->buffer_.size() - 1); // 留给 '\0'
+    sqe->off = 0;
+    sqe->buf_index = static_cast<uint16_t>(file->batch_index_);
+    sqe->user_data = reinterpret_cast<uint64_t>(file);
+    ++queued;
+  }
+
+  size_t done = 0;
+  int ret = ring_->submit_and_wait(static_cast<unsigned>(queued));
+  while (ret >= 0 && done < queued) {
+    done += ring_->drain([](uint64_t user_data, int32_t res) {
+      auto *file = reinterpret_cast<ProcFile *>(user_data);
+      // 读满说明缓冲区可能不够，交给 read() 扩容重读
+      if (res >= 0 && static_cast<size_t>(res) < file->buffer_.size() - 1)
+        file->prefetched_ = res;
+    });
+    if (done < queued)
+      ret = ring_->submit_and_wait(static_cast<unsigned>(queued - done));
+  }
+  if (ret < 0)
+    LOG_WARN(std::string("io_uring 提交失败: ") + strerror(-ret));
+  ++submissions_;
+  pending_.clear();
+}
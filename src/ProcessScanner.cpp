@@ -0,0 +1,300 @@
+#include "ProcessScanner.h"
+#include "IoUring.h"
+#include "Logger.h"
+#include "ParseCursor.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+// getdents64 返回的目录项布局
+struct linux_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+constexpr size_t DENTS_BUF_SIZE = 64 * 1024;
+constexpr size_t STAT_BUF_SIZE = 1024;
+constexpr size_t STAT_PATH_SIZE = 32;
+constexpr size_t TASK_STAT_PATH_SIZE = 48;
+
+// 把 "<pid>/stat" 写入 buf，返回是否成功
+bool format_stat_path(int pid, char *buf, size_t size) {
+  auto [ptr, ec] = std::to_chars(buf, buf + size, pid);
+  if (ec != std::errc() || static_cast<size_t>(ptr - buf) + 6 > size)
+    return false;
+  std::memcpy(ptr, "/stat", 6);
+  return true;
+}
+} // namespace
+
+ProcessScanner::ProcessScanner(std::string root)
+    : root_(std::move(root)), dents_buf_(DENTS_BUF_SIZE) {}
+
+ProcessScanner::~ProcessScanner() {
+  if (root_fd_ != -1)
+    close(root_fd_);
+}
+
+bool ProcessScanner::open_root() {
+  root_fd_ = open(root_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (root_fd_ == -1) {
+    LOG_ERROR("无法打开 " + root_ + ": " + strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool ProcessScanner::list_pids(std::vector<int> &pids) {
+  pids.clear();
+  if (root_fd_ == -1 && !open_root())
+    return false;
+
+  // 复用目录 fd：回到开头即可重新枚举
+  if (lseek(root_fd_, 0, SEEK_SET) == -1) {
+    close(root_fd_);
+    root_fd_ = -1;
+    if (!open_root())
+      return false;
+  }
+  return list_numeric(root_fd_, root_.c_str(), pids);
+}
+
+bool ProcessScanner::list_tasks(int pid, std::vector<int> &tids) {
+  tids.clear();
+  if (root_fd_ == -1 && !open_root())
+    return false;
+  char path[STAT_PATH_SIZE];
+  auto [ptr, ec] = std::to_chars(path, path + sizeof(path), pid);
+  if (ec != std::errc() || static_cast<size_t>(ptr - path) + 6 > sizeof(path))
+    return false;
+  std::memcpy(ptr, "/task", 6);
+
+  int fd = openat(root_fd_, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd == -1)
+    return false; // 进程已退出
+  bool ok = list_numeric(fd, path, tids);
+  close(fd);
+  return ok;
+}
+
+bool ProcessScanner::list_numeric(int dir_fd, const char *what,
+                                  std::vector<int> &ids) {
+  while (true) {
+    long n = syscall(SYS_getdents64, dir_fd, dents_buf_.data(),
+                     dents_buf_.size());
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      LOG_ERROR(std::string("getdents64 ") + what + " 失败: " + strerror(errno));
+      return false;
+    }
+    if (n == 0)
+      break;
+
+    for (long off = 0; off < n;) {
+      auto *d = reinterpret_cast<linux_dirent64 *>(dents_buf_.data() + off);
+      off += d->d_reclen;
+
+      // PID/TID 目录名全是数字且不以 0 开头
+      const char *name = d->d_name;
+      if (d->d_type != DT_DIR && d->d_type != DT_UNKNOWN)
+        continue;
+      if (name[0] < '1' || name[0] > '9')
+        continue;
+
+      int id = 0;
+      const char *end = name + std::strlen(name);
+      auto [ptr, ec] = std::from_chars(name, end, id);
+      if (ec == std::errc() && ptr == end)
+        ids.push_back(id);
+    }
+  }
+  return true;
+}
+
+bool ProcessScanner::read_stat(int pid, ProcStat &out) const {
+  char path[STAT_PATH_SIZE];
+  if (!format_stat_path(pid, path, sizeof(path)))
+    return false;
+  return read_stat_at(path, pid, out);
+}
+
+bool ProcessScanner::read_task_stat(int pid, int tid, ProcStat &out) const {
+  // "<pid>/task/<tid>/stat"
+  char path[TASK_STAT_PATH_SIZE];
+  auto [ptr, ec] = std::to_chars(path, path + sizeof(path), pid);
+  if (ec != std::errc() || path + sizeof(path) - ptr < 6)
+    return false;
+  std::memcpy(ptr, "/task/", 6);
+  if (!format_stat_path(tid, ptr + 6, static_cast<size_t>(path + sizeof(path) - ptr - 6)))
+    return false;
+  return read_stat_at(path, tid, out);
+}
+
+bool ProcessScanner::read_stat_at(const char *path, int id,
+                                  ProcStat &out) const {
+  if (root_fd_ == -1)
+    return false;
+
+  int fd = openat(root_fd_, path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return false; // 进程已退出
+
+  char buf[STAT_BUF_SIZE];
+  ssize_t n;
+  do {
+    n = read(fd, buf, sizeof(buf));
+  } while (n < 0 && errno == EINTR);
+  close(fd);
+
+  if (n <= 0)
+    return false;
+
+  out.pid = id;
+  return parse_stat(std::string_view(buf, static_cast<size_t>(n)), out);
+}
+
+bool ProcessScanner::parse_stat(std::string_view line, ProcStat &out) {
+  // 格式: pid (comm) state ppid ...，comm 可能包含空格和括号，取最后一个 ')'
+  size_t start = line.find('(');
+  size_t end = line.rfind(')');
+  if (start == std::string_view::npos || end == std::string_view::npos ||
+      end < start)
+    return false;
+
+  std::string_view comm = line.substr(start + 1, end - start - 1);
+  out.comm_len =
+      static_cast<uint8_t>(std::min(comm.size(), sizeof(out.comm)));
+  std::memcpy(out.comm, comm.data(), out.comm_len);
+
+  // 字段编号参见 proc(5)：3 state, 14 utime, 15 stime, 20 num_threads,
+  // 22 starttime, 23 vsize, 24 rss
+  ParseCursor cur(line.substr(end + 1));
+  std::string_view state;
+  if (!cur.next_token(state))
+    return false;
+  out.state = state[0];
+
+  return cur.skip_tokens(10) && cur.parse_u64(out.utime) &&
+         cur.parse_u64(out.stime) && cur.skip_tokens(4) &&
+         cur.parse_i64(out.num_threads) && cur.skip_tokens(1) &&
+         cur.parse_u64(out.starttime) && cur.parse_u64(out.vsize) &&
+         cur.parse_i64(out.rss);
+}
+
+// ==================== StatBatchReader ====================
+namespace {
+// user_data：低 2 位是链中的第几步，其余是槽位
+enum : uint64_t { STEP_OPEN = 0, STEP_READ = 1, STEP_CLOSE = 2 };
+} // namespace
+
+StatBatchReader::StatBatchReader()
+    : ring_(std::make_unique<IoUring>()), buffers_(BATCH * STAT_BUF_SIZE),
+      paths_(BATCH * STAT_PATH_SIZE), open_results_(BATCH),
+      read_results_(BATCH) {}
+
+StatBatchReader::~StatBatchReader() = default;
+
+bool StatBatchReader::init() {
+  if (!ring_->init(static_cast<unsigned>(BATCH * 3)))
+    return false;
+  iovec iov{buffers_.data(), buffers_.size()};
+  if (!ring_->register_buffers(&iov, 1) ||
+      !ring_->register_sparse_files(static_cast<unsigned>(BATCH))) {
+    ring_ = std::make_unique<IoUring>();
+    return false;
+  }
+  return true;
+}
+
+void StatBatchReader::read(const ProcessScanner &scanner, const int *pids,
+                           size_t count, std::vector<ProcStat> &out) {
+  ProcStat stat;
+  for (size_t begin = 0; begin < count; begin += BATCH) {
+    size_t n = std::min(BATCH, count - begin);
+    size_t queued = 0;
+    for (size_t slot = 0; slot < n; ++slot) {
+      char *path = &paths_[slot * STAT_PATH_SIZE];
+      open_results_[slot] = -ENOENT;
+      read_results_[slot] = -ECANCELED;
+      if (!format_stat_path(pids[begin + slot], path, STAT_PATH_SIZE))
+        continue;
+
+      io_uring_sqe *open = ring_->get_sqe();
+      io_uring_sqe *rd = ring_->get_sqe();
+      io_uring_sqe *cl = ring_->get_sqe();
+      // 环的容量是 BATCH * 3，不会取不到
+
+      open->opcode = IORING_OP_OPENAT;
+      open->fd = scanner.root_fd();
+      open->addr = reinterpret_cast<uint64_t>(path);
+      open->open_flags = O_RDONLY;
+      open->file_index = static_cast<uint32_t>(slot + 1); // 0 表示普通 fd
+      open->flags = IOSQE_IO_HARDLINK;
+      open->user_data = slot << 2 | STEP_OPEN;
+
+      rd->opcode = IORING_OP_READ_FIXED;
+      rd->fd = static_cast<int>(slot);
+      rd->addr = reinterpret_cast<uint64_t>(&buffers_[slot * STAT_BUF_SIZE]);
+      rd->len = STAT_BUF_SIZE;
+      rd->buf_index = 0;
+      rd->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+      rd->user_data = slot << 2 | STEP_READ;
+
+      cl->opcode = IORING_OP_CLOSE;
+      cl->file_index = static_cast<uint32_t>(slot + 1);
+      cl->user_data = slot << 2 | STEP_CLOSE;
+      queued += 3;
+    }
+
+    size_t done = 0;
+    int ret = ring_->submit_and_wait(static_cast<unsigned>(queued));
+    while (ret >= 0 && done < queued) {
+      done += ring_->drain([this](uint64_t user_data, int32_t res) {
+        size_t slot = user_data >> 2;
+        if ((user_data & 3) == STEP_OPEN)
+          open_results_[slot] = res;
+        else if ((user_data & 3) == STEP_READ)
+          read_results_[slot] = res;
+      });
+      if (done < queued)
+        ret = ring_->submit_and_wait(static_cast<unsigned>(queued - done));
+    }
+    if (ret < 0) {
+      LOG_WARN(std::string("io_uring 提交失败: ") + strerror(-ret));
+      return;
+    }
+
+    for (size_t slot = 0; slot < n; ++slot) {
+      int pid = pids[begin + slot];
+      int opened = open_results_[slot];
+      if (opened == -ENOENT || opened == -ESRCH)
+        continue; // 进程已退出
+      if (opened < 0) {
+        // 内核不支持直接描述符等：这个 PID 走同步路径
+        if (scanner.read_stat(pid, stat))
+          out.push_back(stat);
+        continue;
+      }
+      int n_read = read_results_[slot];
+      if (n_read <= 0)
+        continue;
+      stat.pid = pid;
+      if (ProcessScanner::parse_stat(
+              std::string_view(&buffers_[slot * STAT_BUF_SIZE],
+                               static_cast<size_t>(n_read)),
+              stat))
+        out.push_back(stat);
+    }
+  }
+}
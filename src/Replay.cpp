@@ -0,0 +1,167 @@
+#include "Replay.h"
+#include "Logger.h"
+#include "WireProtocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ==================== RawRecorder ====================
+RawRecorder::~RawRecorder() {
+  if (fd_ != -1) {
+    end_tick(Clock::now()); // 最后一个 tick 之后的输入（通常为空）
+    close(fd_);
+  }
+}
+
+bool RawRecorder::open(const std::string &path) {
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ == -1) {
+    LOG_ERROR("无法创建记录文件 " + path + ": " + strerror(errno));
+    return false;
+  }
+  start_ = Clock::now();
+  buffer_.assign(replay::MAGIC, replay::MAGIC + sizeof(replay::MAGIC));
+  return true;
+}
+
+uint64_t RawRecorder::since_start(Clock::time_point t) const {
+  return t > start_ ? static_cast<uint64_t>(
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              t - start_)
+                              .count())
+                    : 0;
+}
+
+void RawRecorder::append_record(uint8_t type, const std::vector<uint8_t> &head,
+                                std::string_view body) {
+  buffer_.push_back(type);
+  wire::put_varint(buffer_, head.size() + body.size());
+  buffer_.insert(buffer_.end(), head.begin(), head.end());
+  buffer_.insert(buffer_.end(), body.begin(), body.end());
+}
+
+void RawRecorder::record(const Collector &collector,
+                         Clock::time_point sampled_at, std::string_view raw) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ == -1 || failed_ || raw.empty())
+    return;
+
+  auto it = std::find(sources_.begin(), sources_.end(), &collector);
+  uint64_t id = static_cast<uint64_t>(it - sources_.begin());
+  if (it == sources_.end()) {
+    sources_.push_back(&collector);
+    head_.clear();
+    wire::put_varint(head_, id);
+    append_record(replay::RECORD_SOURCE, head_, collector.get_name());
+  }
+  head_.clear();
+  wire::put_varint(head_, id);
+  wire::put_varint(head_, since_start(sampled_at));
+  append_record(replay::RECORD_INPUT, head_, raw);
+}
+
+void RawRecorder::end_tick(Clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ == -1 || failed_)
+    return;
+  head_.clear();
+  wire::put_varint(head_, since_start(now));
+  append_record(replay::RECORD_TICK, head_, {});
+
+  size_t done = 0;
+  while (done < buffer_.size()) {
+    ssize_t n = write(fd_, buffer_.data() + done, buffer_.size() - done);
+    if (n == -1) {
+      if (errno == EINTR)
+        continue;
+      LOG_ERROR(std::string("写记录文件失败，停止记录: ") + strerror(errno));
+      failed_ = true;
+      break;
+    }
+    done += static_cast<size_t>(n);
+  }
+  written_ += done;
+  buffer_.clear();
+}
+
+// ==================== ReplayReader ====================
+ReplayReader::~ReplayReader() {
+  if (data_)
+    munmap(data_, size_);
+}
+
+bool ReplayReader::open(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    LOG_ERROR("无法打开记录文件 " + path + ": " + strerror(errno));
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size < static_cast<off_t>(sizeof(replay::MAGIC))) {
+    LOG_ERROR(path + " 不是记录文件");
+    ::close(fd);
+    return false;
+  }
+  void *base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    LOG_ERROR("mmap " + path + " 失败: " + strerror(errno));
+    return false;
+  }
+  // 回放从头到尾顺序读一遍
+  madvise(base, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+  data_ = static_cast<uint8_t *>(base);
+  size_ = static_cast<size_t>(st.st_size);
+  return true;
+}
+
+bool ReplayReader::decode(const uint8_t *data, size_t size, Handler &handler) {
+  if (size < sizeof(replay::MAGIC) ||
+      std::memcmp(data, replay::MAGIC, sizeof(replay::MAGIC)) != 0)
+    return false;
+  const uint8_t *p = data + sizeof(replay::MAGIC);
+  const uint8_t *end = data + size;
+  while (p < end) {
+    uint8_t type = *p++;
+    uint64_t length = 0;
+    if (!wire::get_varint(p, end, length) ||
+        length > static_cast<uint64_t>(end - p))
+      return true; // 末尾被截断
+    const uint8_t *body = p;
+    const uint8_t *body_end = p + length;
+    p = body_end;
+
+    uint64_t id = 0;
+    uint64_t timestamp = 0;
+    auto rest = [&body, body_end] {
+      return std::string_view(reinterpret_cast<const char *>(body),
+                              static_cast<size_t>(body_end - body));
+    };
+    switch (type) {
+    case replay::RECORD_SOURCE:
+      if (!wire::get_varint(body, body_end, id) || id >= replay::MAX_SOURCES)
+        return false;
+      handler.on_source(id, rest());
+      break;
+    case replay::RECORD_INPUT:
+      if (!wire::get_varint(body, body_end, id) || id >= replay::MAX_SOURCES ||
+          !wire::get_varint(body, body_end, timestamp))
+        return false;
+      handler.on_input(id, timestamp, rest());
+      break;
+    case replay::RECORD_TICK:
+      if (!wire::get_varint(body, body_end, timestamp))
+        return false;
+      handler.on_tick(timestamp);
+      break;
+    default:
+      break; // 以后的记录类型：跳过
+    }
+  }
+  return true;
+}
@@ -0,0 +1,32 @@
+#include "TickArena.h"
+
+TickArena::TickArena(size_t initial_bytes) : block_(initial_bytes) {
+  resource_.emplace(block_.data(), block_.size(),
+                    std::pmr::new_delete_resource());
+}
+
+void *TickArena::do_allocate(size_t bytes, size_t alignment) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // 按对齐补齐后计入用量，扩大后的块一定能放下同样的分配序列
+  used_ += bytes + alignment - 1;
+  return resource_->allocate(bytes, alignment);
+}
+
+void TickArena::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (used_ > block_.size()) {
+    // 本 tick 溢出到了上游：扩大复用块，重新建立 resource
+    ++overflows_;
+    size_t grown = block_.size() ? block_.size() : 1024;
+    while (grown < used_)
+      grown *= 2;
+    resource_.reset();
+    block_.assign(grown, std::byte{});
+    resource_.emplace(block_.data(), block_.size(),
+                      std::pmr::new_delete_resource());
+  } else {
+    // release() 归还上游内存，并回到复用块的起点
+    resource_->release();
+  }
+  used_ = 0;
+}
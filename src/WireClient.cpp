@@ -0,0 +1,183 @@
+#include "WireClient.h"
+#include "EventLoop.h"
+#include "Logger.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WireClient::WireClient(EventLoop &loop, std::string host_name,
+                       std::chrono::milliseconds interval)
+    : loop_(loop), host_name_(std::move(host_name)), interval_(interval) {}
+
+WireClient::~WireClient() {
+  if (fd_ != -1) {
+    loop_.remove(fd_);
+    close(fd_);
+  }
+}
+
+bool WireClient::set_target(const std::string &address) {
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos || colon == 0) {
+    LOG_ERROR("无效的汇聚端地址（需要 HOST:PORT）: " + address);
+    return false;
+  }
+  std::string host = address.substr(0, colon);
+  std::string_view port_text = std::string_view(address).substr(colon + 1);
+  unsigned port = 0;
+  auto [ptr, ec] = std::from_chars(
+      port_text.data(), port_text.data() + port_text.size(), port);
+  if (ec != std::errc() || ptr != port_text.data() + port_text.size() ||
+      port == 0 || port > 65535) {
+    LOG_ERROR("无效的汇聚端端口: " + address);
+    return false;
+  }
+
+  // 启动时解析一次主机名，之后重连不再阻塞在 DNS 上
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *result = nullptr;
+  int rc = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+  if (rc != 0 || !result) {
+    LOG_ERROR("无法解析汇聚端 " + host + ": " + gai_strerror(rc));
+    return false;
+  }
+  target_ = *reinterpret_cast<sockaddr_in *>(result->ai_addr);
+  target_.sin_port = htons(static_cast<uint16_t>(port));
+  freeaddrinfo(result);
+  address_ = address;
+  return true;
+}
+
+bool WireClient::connect_target() {
+  fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd_ == -1) {
+    LOG_WARN(std::string("socket 失败: ") + strerror(errno));
+    return false;
+  }
+  int rc = connect(fd_, reinterpret_cast<sockaddr *>(&target_), sizeof(target_));
+  if (rc == -1 && errno != EINPROGRESS) {
+    disconnect(std::string("连接失败: ") + strerror(errno));
+    return false;
+  }
+  // 连接建立前也可以编码，帧先留在缓冲区里
+  state_ = rc == 0 ? State::CONNECTED : State::CONNECTING;
+  want_write_ = true;
+  if (!loop_.add(fd_, EPOLLIN | EPOLLOUT | EPOLLRDHUP,
+                 [this](uint32_t events) { on_event(events); })) {
+    close(fd_);
+    fd_ = -1;
+    state_ = State::DISCONNECTED;
+    return false;
+  }
+  encoder_.reset();
+  pending_.clear();
+  pending_offset_ = 0;
+  encoder_.encode_hello(host_name_, static_cast<uint32_t>(interval_.count()),
+                        pending_);
+  return true;
+}
+
+void WireClient::disconnect(const std::string &reason) {
+  if (fd_ != -1) {
+    if (state_ != State::DISCONNECTED)
+      loop_.remove(fd_);
+    close(fd_);
+    fd_ = -1;
+  }
+  if (state_ == State::CONNECTED)
+    LOG_WARN("与汇聚端 " + address_ + " 断开: " + reason);
+  else
+    LOG_WARN("无法连接汇聚端 " + address_ + ": " + reason);
+  state_ = State::DISCONNECTED;
+  pending_.clear();
+  pending_offset_ = 0;
+  retry_at_ = std::chrono::steady_clock::now() + RETRY_INTERVAL;
+  ++reconnects_;
+}
+
+void WireClient::update(const MetricStore &store, int64_t timestamp_ms) {
+  if (state_ == State::DISCONNECTED) {
+    if (std::chrono::steady_clock::now() < retry_at_ || !connect_target())
+      return;
+  }
+  encoder_.encode_tick(store, timestamp_ms, pending_);
+  if (pending_.size() - pending_offset_ > MAX_PENDING_BYTES) {
+    disconnect("发送缓冲区超过 " + std::to_string(MAX_PENDING_BYTES / 1024) +
+               " KB");
+    return;
+  }
+  if (state_ == State::CONNECTED)
+    flush();
+}
+
+bool WireClient::flush() {
+  while (pending_offset_ < pending_.size()) {
+    ssize_t n = send(fd_, pending_.data() + pending_offset_,
+                     pending_.size() - pending_offset_, MSG_NOSIGNAL);
+    if (n > 0) {
+      pending_offset_ += static_cast<size_t>(n);
+      bytes_sent_ += static_cast<uint64_t>(n);
+      continue;
+    }
+    if (n == -1 && errno == EINTR)
+      continue;
+    if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (!want_write_) {
+        want_write_ = true;
+        loop_.modify(fd_, EPOLLIN | EPOLLOUT | EPOLLRDHUP);
+      }
+      return true;
+    }
+    disconnect(std::string("send 失败: ") + strerror(errno));
+    return false;
+  }
+  pending_.clear();
+  pending_offset_ = 0;
+  if (want_write_) {
+    want_write_ = false;
+    loop_.modify(fd_, EPOLLIN | EPOLLRDHUP);
+  }
+  return true;
+}
+
+void WireClient::on_event(uint32_t events) {
+  if (state_ == State::CONNECTING && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len);
+    if (error != 0) {
+      disconnect(strerror(error));
+      return;
+    }
+    state_ = State::CONNECTED;
+    LOG_INFO("已连接汇聚端 " + address_);
+  }
+  if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+    disconnect("连接被关闭");
+    return;
+  }
+  if (events & EPOLLIN) {
+    // 汇聚端不发送数据，读到的内容直接丢弃
+    char discard[256];
+    while (read(fd_, discard, sizeof(discard)) > 0) {
+    }
+  }
+  if (events & EPOLLOUT)
+    flush();
+}
+
+void WireClient::print(std::ostream &out) const {
+  out << "  汇聚端 " << address_ << ": "
+      << (state_ == State::CONNECTED    ? "已连接"
+          : state_ == State::CONNECTING ? "连接中"
+                                        : "未连接")
+      << " (已发送 " << bytes_sent_ / 1024 << " KB, 重连 " << reconnects_
+      << " 次)\n";
+}
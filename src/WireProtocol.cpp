@@ -0,0 +1,257 @@
+#include "WireProtocol.h"
+#include <cmath>
+#include <cstring>
+
+namespace wire {
+
+namespace {
+// 超过它的非整数取千分位会溢出 int64，按整数截断
+constexpr double MILLI_LIMIT = 9.0e15;
+constexpr double INTEGER_LIMIT = 4.0e18;
+} // namespace
+
+bool quantize(double value, int64_t &q, bool &milli) {
+  if (!std::isfinite(value) || std::fabs(value) >= INTEGER_LIMIT)
+    return false;
+  if (value == std::trunc(value) || std::fabs(value) >= MILLI_LIMIT) {
+    q = static_cast<int64_t>(value);
+    milli = false;
+  } else {
+    q = std::llround(value * 1000.0);
+    milli = true;
+  }
+  return true;
+}
+
+double dequantize(int64_t q, bool milli) {
+  return milli ? static_cast<double>(q) / 1000.0 : static_cast<double>(q);
+}
+
+// ==================== Encoder ====================
+void Encoder::reset() {
+  strings_.clear();
+  strings_.emplace(std::string(), 0);
+  defined_ = 0;
+  last_.clear();
+  last_ts_ = 0;
+}
+
+void Encoder::append_frame(FrameType type, std::vector<uint8_t> &out) {
+  put_varint(out, body_.size());
+  out.push_back(type);
+  out.insert(out.end(), body_.begin(), body_.end());
+}
+
+void Encoder::encode_hello(std::string_view host, uint32_t interval_ms,
+                           std::vector<uint8_t> &out) {
+  body_.assign(MAGIC, MAGIC + sizeof(MAGIC));
+  put_varint(body_, VERSION);
+  put_varint(body_, interval_ms);
+  put_varint(body_, host.size());
+  body_.insert(body_.end(), host.begin(), host.end());
+  append_frame(FRAME_HELLO, out);
+}
+
+uint64_t Encoder::intern(const std::string &text, size_t &new_strings) {
+  auto [it, inserted] = strings_.try_emplace(text, strings_.size());
+  if (inserted) {
+    ++new_strings;
+    put_varint(strings_body_, text.size());
+    strings_body_.insert(strings_body_.end(), text.begin(), text.end());
+  }
+  return it->second;
+}
+
+size_t Encoder::encode_tick(const MetricStore &store, int64_t timestamp_ms,
+                            std::vector<uint8_t> &out) {
+  // 新出现的指标：先定义用到的新字符串，再按 id 顺序定义指标
+  size_t count = store.metric_count();
+  if (defined_ < count) {
+    strings_body_.clear();
+    std::vector<uint64_t> refs;
+    refs.reserve((count - defined_) * 3);
+    size_t new_strings = 0;
+    for (size_t id = defined_; id < count; ++id) {
+      const MetricInfo &info = store.info(id);
+      refs.push_back(intern(info.name, new_strings));
+      refs.push_back(intern(info.label_key, new_strings));
+      refs.push_back(intern(info.label_value, new_strings));
+    }
+    body_.clear();
+    put_varint(body_, new_strings);
+    body_.insert(body_.end(), strings_body_.begin(), strings_body_.end());
+    put_varint(body_, count - defined_);
+    for (uint64_t ref : refs)
+      put_varint(body_, ref);
+    append_frame(FRAME_DEFINE, out);
+    defined_ = count;
+    last_.resize(count);
+  }
+
+  // 只发送与上次不同的值
+  body_.clear();
+  put_varint(body_, zigzag(timestamp_ms - last_ts_));
+  size_t count_pos = body_.size();
+  body_.resize(body_.size() + 5); // 个数的占位，最后按实际长度收缩
+  size_t changed = 0;
+  size_t expected = 0;
+  for (size_t id = 0; id < count; ++id) {
+    const MetricRing &ring = store.ring(id);
+    if (ring.empty())
+      continue;
+    int64_t q = 0;
+    bool milli = false;
+    if (!quantize(ring.latest_value(), q, milli))
+      continue;
+    Last &last = last_[id];
+    if (last.sent && last.q == q && last.milli == milli)
+      continue;
+    int64_t base = last.sent && last.milli == milli ? last.q : 0;
+    put_varint(body_, (static_cast<uint64_t>(id - expected) << 1) | (milli ? 1 : 0));
+    put_varint(body_, zigzag(q - base));
+    last = Last{q, milli, true};
+    expected = id + 1;
+    ++changed;
+  }
+
+  // 回填个数：把 varint 写到占位处，再把后面的内容前移
+  uint8_t count_bytes[10];
+  size_t count_len = 0;
+  for (uint64_t v = changed;; v >>= 7) {
+    count_bytes[count_len++] = static_cast<uint8_t>((v >= 0x80 ? 0x80 : 0) | (v & 0x7f));
+    if (v < 0x80)
+      break;
+  }
+  std::memcpy(&body_[count_pos], count_bytes, count_len);
+  body_.erase(body_.begin() + static_cast<long>(count_pos + count_len),
+              body_.begin() + static_cast<long>(count_pos + 5));
+  append_frame(FRAME_SAMPLES, out);
+  last_ts_ = timestamp_ms;
+  return changed;
+}
+
+// ==================== Decoder ====================
+void Decoder::reset() {
+  hello_ = false;
+  strings_.assign(1, std::string());
+  string_bytes_ = 0;
+  metrics_.clear();
+  last_ts_ = 0;
+  frames_ = 0;
+  error_.clear();
+}
+
+bool Decoder::fail(const char *message) {
+  error_ = message;
+  return false;
+}
+
+long Decoder::consume(const uint8_t *data, size_t size, Handler &handler) {
+  const uint8_t *p = data;
+  const uint8_t *end = data + size;
+  while (p < end) {
+    const uint8_t *frame = p;
+    uint64_t length = 0;
+    if (!get_varint(p, end, length)) {
+      if (end - frame >= 10)
+        return fail("帧长度无效"), -1;
+      return frame - data; // 长度本身还不完整
+    }
+    if (length > MAX_FRAME_BYTES)
+      return fail("帧过大"), -1;
+    if (static_cast<uint64_t>(end - p) < length + 1)
+      return frame - data;
+    uint8_t type = *p++;
+    if (!decode_frame(type, p, p + length, handler))
+      return -1;
+    p += length;
+    ++frames_;
+  }
+  return p - data;
+}
+
+bool Decoder::decode_frame(uint8_t type, const uint8_t *p, const uint8_t *end,
+                           Handler &handler) {
+  uint64_t n = 0;
+  if (type == FRAME_HELLO) {
+    uint64_t version = 0, interval = 0, host_len = 0;
+    if (end - p < static_cast<long>(sizeof(MAGIC)) ||
+        std::memcmp(p, MAGIC, sizeof(MAGIC)) != 0)
+      return fail("HELLO 魔数不匹配");
+    p += sizeof(MAGIC);
+    if (!get_varint(p, end, version) || version != VERSION)
+      return fail("协议版本不支持");
+    if (!get_varint(p, end, interval) || !get_varint(p, end, host_len) ||
+        static_cast<uint64_t>(end - p) < host_len)
+      return fail("HELLO 帧截断");
+    hello_ = true;
+    if (!handler.on_hello(std::string(reinterpret_cast<const char *>(p), host_len),
+                          static_cast<uint32_t>(interval)))
+      return fail("主机被拒绝");
+    return true;
+  }
+  if (!hello_)
+    return fail("缺少 HELLO 帧");
+
+  if (type == FRAME_DEFINE) {
+    if (!get_varint(p, end, n))
+      return fail("DEFINE 帧截断");
+    // 先按个数检查再解析：空字符串每个也要一个 std::string
+    if (n > limits_.max_strings - (strings_.size() - 1))
+      return fail("DEFINE 超出上限");
+    for (uint64_t i = 0; i < n; ++i) {
+      uint64_t len = 0;
+      if (!get_varint(p, end, len) || static_cast<uint64_t>(end - p) < len)
+        return fail("DEFINE 字符串截断");
+      if (len > limits_.max_string_bytes - string_bytes_)
+        return fail("DEFINE 超出上限");
+      strings_.emplace_back(reinterpret_cast<const char *>(p), len);
+      string_bytes_ += len;
+      p += len;
+    }
+    if (!get_varint(p, end, n))
+      return fail("DEFINE 帧截断");
+    if (n > limits_.max_metrics - metrics_.size())
+      return fail("DEFINE 超出上限");
+    for (uint64_t i = 0; i < n; ++i) {
+      Metric metric;
+      if (!get_varint(p, end, metric.name) || !get_varint(p, end, metric.key) ||
+          !get_varint(p, end, metric.value))
+        return fail("DEFINE 指标截断");
+      if (metric.name >= strings_.size() || metric.key >= strings_.size() ||
+          metric.value >= strings_.size())
+        return fail("DEFINE 引用了未定义的字符串");
+      metrics_.push_back(metric);
+      handler.on_define(metrics_.size() - 1, strings_[metric.name],
+                        strings_[metric.key], strings_[metric.value]);
+    }
+    return true;
+  }
+
+  if (type == FRAME_SAMPLES) {
+    uint64_t ts = 0;
+    if (!get_varint(p, end, ts) || !get_varint(p, end, n))
+      return fail("SAMPLES 帧截断");
+    last_ts_ += unzigzag(ts);
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+      uint64_t tag = 0, delta = 0;
+      if (!get_varint(p, end, tag) || !get_varint(p, end, delta))
+        return fail("SAMPLES 截断");
+      uint64_t id = expected + (tag >> 1);
+      if (id >= metrics_.size())
+        return fail("SAMPLES 引用了未定义的指标");
+      bool milli = tag & 1;
+      Metric &metric = metrics_[id];
+      int64_t base = metric.milli == milli ? metric.q : 0;
+      metric.q = base + unzigzag(delta);
+      metric.milli = milli;
+      handler.on_sample(id, last_ts_, dequantize(metric.q, milli));
+      expected = id + 1;
+    }
+    return true;
+  }
+  return fail("未知的帧类型");
+}
+
+} // namespace wire
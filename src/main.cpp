@@ -1,135 +1,676 @@
-#include <sys/timerfd.h>
-#include <sys/epoll.h>
-#include <unistd.h>
 #include <iostream>
 #include <iomanip>
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
 
+#include "AdaptiveSampler.h"
+#include "Aggregator.h"
 #include "Collectors.h"
 #include "CollectorFactory.h"
+#include "CollectorScheduler.h"
+#include "CollectorWarmup.h"
+#include "EventLoop.h"
+#include "FrameRenderer.h"
 #include "Logger.h"
+#include "MetricArchive.h"
+#include "MetricStore.h"
+#include "MetricsServer.h"
+#include "Options.h"
+#include "PressureBurst.h"
+#include "Replay.h"
+#include "TickArena.h"
+#include "WireClient.h"
 
-// ANSI 转义码 - 用于清屏和光标控制
-#define CLEAR_SCREEN "\033[2J\033[H"
+// ANSI 转义码 - 颜色（清屏和光标移动由 FrameRenderer 负责）
 #define BOLD "\033[1m"
 #define RESET "\033[0m"
 #define GREEN "\033[32m"
 #define YELLOW "\033[33m"
 #define CYAN "\033[36m"
 
-void print_header() {
-    std::cout << BOLD << CYAN;
-    std::cout << "╔══════════════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║               Linux 系统资源监控器                         ║" << std::endl;
-    std::cout << "╚══════════════════════════════════════════════════════════╝" << RESET << std::endl;
-    std::cout << std::endl;
+void print_header(std::ostream& out) {
+    out << BOLD << CYAN;
+    out << "╔══════════════════════════════════════════════════════════╗\n";
+    out << "║               Linux 系统资源监控器                         ║\n";
+    out << "╚══════════════════════════════════════════════════════════╝" << RESET << "\n";
+    out << "\n";
 }
 
-void print_separator() {
-    std::cout << YELLOW << "──────────────────────────────────────────────────────────────" << RESET << std::endl;
+// 汇聚模式下主机列表最多显示的行数
+constexpr size_t AGGREGATOR_ROWS = 20;
+
+void print_separator(std::ostream& out) {
+    out << YELLOW << "──────────────────────────────────────────────────────────────" << RESET << "\n";
 }
 
-int main() {
-    // 设置日志级别（单例模式示例）
-    Logger::instance().set_level(Logger::Level::WARNING);
+// 把 RLIMIT_NOFILE 软限制提到硬限制：cgroup 采集器每个 cgroup 保持 5 个 fd，
+// 汇聚端每台主机一个连接，都远超常见的 1024。进程里只在这里修改一次
+void raise_fd_limit() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur >= limit.rlim_max) {
+        return;
+    }
+    rlim_t soft = limit.rlim_cur;
+    limit.rlim_cur = limit.rlim_max;
+    if (setrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        LOG_WARN(std::string("无法提高 RLIMIT_NOFILE: ") + strerror(errno));
+        return;
+    }
+    LOG_INFO("RLIMIT_NOFILE 软限制 " + std::to_string(soft) + " -> " +
+             std::to_string(limit.rlim_cur));
+}
 
-    // 1. 创建定时器 fd
-    int tfd = timerfd_create(CLOCK_MONOTONIC, 0);
-    if (tfd == -1) {
-        LOG_ERROR(std::string("创建 timerfd 失败: ") + strerror(errno));
+// 按 --interval 覆盖各采集器的采样周期
+void apply_intervals(const MonitorOptions& options,
+                     const std::vector<std::unique_ptr<Collector>>& collectors) {
+    for (const auto& entry : options.intervals) {
+        for (auto& collector : collectors) {
+            if (entry.collector.empty() || entry.collector == collector->get_name()) {
+                collector->set_interval(std::chrono::milliseconds(entry.interval_ms));
+            }
+        }
+    }
+}
+
+// 每个 tick（采集 + 输出）的统计
+struct TickStats {
+    LatencyHistogram latency;      // 纳秒
+    LatencyHistogram allocations;  // 分配次数
+    LatencyHistogram output_bytes; // 每帧写到终端的字节数
+    LatencyHistogram arena_bytes;  // 每 tick 从 TickArena 分配的字节数
+};
+
+// --stats：各采集器各阶段耗时的 p50/p99/max，以及每 tick 的分配次数和输出字节数
+void print_stats(std::ostream& out,
+                 const std::vector<std::unique_ptr<Collector>>& collectors,
+                 const TickStats& ticks) {
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+    auto row = [&](const char* name, const char* phase, const LatencyHistogram& h) {
+        out << "  " << std::left << std::setw(10) << name << std::setw(11) << phase
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << us(h.percentile(50))
+            << std::setw(10) << us(h.percentile(99))
+            << std::setw(10) << us(h.max()) << "\n";
+    };
+
+    print_separator(out);
+    out << "自监控统计 (单位 us):\n";
+    // 中文宽度与字节数不同，表头手工对齐
+    out << "  采集器    阶段       " << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "max" << "\n";
+    for (const auto& collector : collectors) {
+        const PhaseStats& stats = collector->phase_stats();
+        std::string name = collector->get_name();
+        row(name.c_str(), "collect", stats.collect);
+        row("", "parse", stats.parse);
+        row("", "calculate", stats.calculate);
+        row("", "total", stats.total);
+
+        uint64_t updates = stats.total.count();
+        double allocs = updates ? static_cast<double>(stats.allocations.load()) / updates : 0.0;
+        out << "  " << std::setw(10) << "" << "分配/次: " << std::setprecision(1)
+            << allocs << "\n";
+    }
+    out << "  每 tick 耗时: p50 " << us(ticks.latency.percentile(50))
+        << " p99 " << us(ticks.latency.percentile(99))
+        << " max " << us(ticks.latency.max()) << "\n";
+    out << "  每 tick 分配: p50 " << ticks.allocations.percentile(50)
+        << " p99 " << ticks.allocations.percentile(99)
+        << " max " << ticks.allocations.max() << "\n";
+    out << "  每帧输出字节: p50 " << ticks.output_bytes.percentile(50)
+        << " p99 " << ticks.output_bytes.percentile(99)
+        << " max " << ticks.output_bytes.max() << "\n";
+    out << "  每 tick arena 字节: p50 " << ticks.arena_bytes.percentile(50)
+        << " max " << ticks.arena_bytes.max() << "\n";
+}
+
+// 输出一帧：头部 + 各采集器结果（按工厂注册顺序）+ 本次采集耗时
+void render(std::ostream& out,
+            const std::vector<std::unique_ptr<Collector>>& collectors,
+            const CollectorScheduler& scheduler, const CollectorWarmup& warmup,
+            const AdaptiveSampler* adaptive, const PressureBurst* burst,
+            const WireClient* client, const TickStats* ticks) {
+    print_header(out);
+
+    // 多态遍历：输出顺序与工厂注册顺序一致
+    for (size_t i = 0; i < collectors.size(); ++i) {
+        if (warmup.pending(collectors[i].get())) {
+            // 第一次采集还在后台进行，先占一行
+            out << collectors[i]->get_name() << ": 首次采集中...\n";
+        } else {
+            collectors[i]->print_result(out); // 多态调用
+        }
+        if (i < collectors.size() - 1) {
+            print_separator(out);
+        }
+    }
+
+    using Ms = std::chrono::duration<double, std::milli>;
+    out << "\n";
+    if (const Collector* critical = scheduler.critical_collector()) {
+        out << "采集耗时: " << std::fixed << std::setprecision(2)
+            << Ms(scheduler.wall_time()).count() << " ms (关键路径 "
+            << critical->get_name() << " "
+            << Ms(scheduler.critical_path()).count() << " ms, "
+            << scheduler.jobs() << " 线程)\n";
+    }
+    if (adaptive) {
+        adaptive->print(out);
+    }
+    if (burst) {
+        burst->print(out);
+    }
+    if (client) {
+        client->print(out);
+    }
+    if (ticks) {
+        print_stats(out, collectors, *ticks);
+    }
+    out << GREEN << "[自动刷新 | Ctrl+C 退出]" << RESET << "\n";
+}
+
+// 汇聚模式：不采集本机，只在同一个 epoll 上接收各主机的推送，每秒刷新一次主机列表
+int run_aggregator(const MonitorOptions& options, const sigset_t& quit_signals) {
+    EventLoop loop;
+    if (!loop.valid()) {
+        return 1;
+    }
+    Aggregator aggregator(loop, std::chrono::seconds(options.retention_s));
+    if (!aggregator.listen(options.aggregate)) {
         return 1;
     }
 
-    // 2. 设置定时参数（每 1 秒触发一次）
-    struct itimerspec ts;
-    ts.it_interval.tv_sec = 1;   // 周期：1秒
-    ts.it_interval.tv_nsec = 0;
-    ts.it_value.tv_sec = 0;      // 第一次启动：立即开始
-    ts.it_value.tv_nsec = 1;     // 设置为非零值以启动定时器
-    
-    if (timerfd_settime(tfd, 0, &ts, NULL) == -1) {
-        LOG_ERROR(std::string("设置 timerfd 失败: ") + strerror(errno));
-        close(tfd);
+    int sfd = signalfd(-1, &quit_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    bool running = true;
+    if (sfd == -1 || !loop.add(sfd, EPOLLIN, [sfd, &running](uint32_t) {
+            signalfd_siginfo info;
+            while (read(sfd, &info, sizeof(info)) == sizeof(info)) {
+            }
+            running = false;
+        })) {
+        return 1;
+    }
+    bool refresh = false;
+    if (loop.add_timer(std::chrono::seconds(1), [&refresh](uint64_t) { refresh = true; }) == -1) {
         return 1;
     }
 
-    // 3. 将 tfd 加入 epoll
-    int epfd = epoll_create1(0);
-    if (epfd == -1) {
-        LOG_ERROR(std::string("创建 epoll 失败: ") + strerror(errno));
-        close(tfd);
+    std::cout << "汇聚端已启动，监听端口 " << aggregator.port() << "，按 Ctrl+C 退出..."
+              << std::endl;
+    LOG_INFO("汇聚端已启动");
+
+    FrameRenderer renderer;
+    while (running && loop.run_once()) {
+        if (!refresh || options.headless) {
+            continue;
+        }
+        refresh = false;
+        std::ostream& out = renderer.begin_frame();
+        print_header(out);
+        aggregator.print(out, AGGREGATOR_ROWS);
+        out << GREEN << "[自动刷新 | Ctrl+C 退出]" << RESET << "\n";
+        if (!renderer.end_frame()) {
+            LOG_ERROR("写终端失败，退出");
+            break;
+        }
+    }
+    close(sfd);
+    return 0;
+}
+
+// 回放：把记录文件中的原始输入依次喂给对应采集器的 replay()，按 TICK 记录统计每 tick 耗时
+class ReplayRunner : public ReplayReader::Handler {
+public:
+    ReplayRunner(const std::vector<std::unique_ptr<Collector>>& collectors, TickStats& ticks)
+        : collectors_(collectors), ticks_(ticks),
+          base_(std::chrono::steady_clock::now()), tick_start_(base_),
+          allocs_before_(AllocCounter::total()) {}
+
+    void on_source(uint64_t id, std::string_view name) override {
+        // decode() 已经拒绝了更大的 id，这里再检查一次，不按文件内容无限扩容
+        if (id >= replay::MAX_SOURCES) {
+            return;
+        }
+        if (id >= sources_.size()) {
+            sources_.resize(id + 1, nullptr);
+        }
+        for (const auto& collector : collectors_) {
+            if (collector->get_name() == name) {
+                sources_[id] = collector.get();
+            }
+        }
+        if (!sources_[id]) {
+            LOG_WARN("记录中的采集器 " + std::string(name) + " 未启用，跳过它的输入");
+        }
+    }
+
+    void on_input(uint64_t id, uint64_t timestamp_ns, std::string_view raw) override {
+        if (id >= sources_.size() || !sources_[id]) {
+            return;
+        }
+        // 记录时的采样间隔原样保留，速率与记录时一致
+        sources_[id]->replay(raw, base_ + std::chrono::nanoseconds(timestamp_ns));
+        ++inputs_;
+        bytes_ += raw.size();
+    }
+
+    void on_tick(uint64_t timestamp_ns) override {
+        auto now = std::chrono::steady_clock::now();
+        ticks_.latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - tick_start_).count()));
+        uint64_t allocs = AllocCounter::total();
+        ticks_.allocations.record(allocs - allocs_before_);
+        tick_start_ = now;
+        allocs_before_ = allocs;
+        ++count_;
+        recorded_ns_ = timestamp_ns;
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t inputs() const { return inputs_; }
+    uint64_t bytes() const { return bytes_; }
+    uint64_t recorded_ns() const { return recorded_ns_; }
+
+private:
+    const std::vector<std::unique_ptr<Collector>>& collectors_;
+    TickStats& ticks_;
+    std::vector<Collector*> sources_;  // 下标是记录中的 SOURCE id
+    std::chrono::steady_clock::time_point base_;
+    std::chrono::steady_clock::time_point tick_start_;
+    uint64_t allocs_before_;
+    uint64_t count_ = 0;
+    uint64_t inputs_ = 0;
+    uint64_t bytes_ = 0;
+    uint64_t recorded_ns_ = 0;
+};
+
+// 回放模式：不读 /proc，以最快速度回放 --record 的文件，报告吞吐和各阶段耗时，
+// 最后输出一帧（同一个文件每次回放的输出相同）
+int run_replay(const MonitorOptions& options) {
+    ReplayReader reader;
+    if (!reader.open(options.replay)) {
         return 1;
     }
-    
-    struct epoll_event ev;
-    ev.events = EPOLLIN;
-    ev.data.fd = tfd;
-    if (epoll_ctl(epfd, EPOLL_CTL_ADD, tfd, &ev) == -1) {
-        LOG_ERROR(std::string("epoll_ctl 失败: ") + strerror(errno));
-        close(tfd);
-        close(epfd);
+    auto collectors = CollectorFactory::instance().create_all(options.backends, options.collectors);
+    collectors.erase(std::remove_if(collectors.begin(), collectors.end(),
+                                    [](const auto& c) { return !c->replayable(); }),
+                     collectors.end());
+    for (auto& collector : collectors) {
+        collector->configure(options);
+    }
+
+    TickStats ticks;
+    ReplayRunner runner(collectors, ticks);
+    auto start = std::chrono::steady_clock::now();
+    if (!ReplayReader::decode(reader.data(), reader.size(), runner)) {
+        std::cerr << options.replay << " 不是记录文件或已损坏" << std::endl;
         return 1;
     }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostream& out = std::cout;
+    print_header(out);
+    for (size_t i = 0; i < collectors.size(); ++i) {
+        collectors[i]->print_result(out);
+        if (i < collectors.size() - 1) {
+            print_separator(out);
+        }
+    }
+    double mb = runner.bytes() / (1024.0 * 1024.0);
+    print_separator(out);
+    out << std::fixed << std::setprecision(1)
+        << "回放 " << options.replay << ": " << runner.count() << " ticks (记录时长 "
+        << runner.recorded_ns() / 1e9 << " s), " << runner.inputs() << " 条输入, "
+        << std::setprecision(2) << mb << " MB\n"
+        << "用时 " << seconds * 1000 << " ms: "
+        << std::setprecision(0) << (seconds > 0 ? runner.count() / seconds : 0.0)
+        << " ticks/s, " << std::setprecision(1) << (seconds > 0 ? mb / seconds : 0.0)
+        << " MB/s\n";
+    print_stats(out, collectors, ticks);
+    out.flush();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    MonitorOptions options;
+    ParseResult parsed = parse_options(argc, argv, options);
+    if (parsed != ParseResult::RUN) {
+        return parsed == ParseResult::HELP ? 0 : 1;
+    }
+
+    // SIGINT/SIGTERM 改由 signalfd 在事件循环中处理，正常退出时析构函数
+    // 才会运行（归档写出未封存的块）；必须在创建任何线程之前屏蔽
+    sigset_t quit_signals;
+    sigemptyset(&quit_signals);
+    sigaddset(&quit_signals, SIGINT);
+    sigaddset(&quit_signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &quit_signals, nullptr);
+    // 抓取方断开时 write/writev 返回 EPIPE，而不是杀死进程
+    signal(SIGPIPE, SIG_IGN);
+
+    // 设置日志级别（单例模式示例）
+    Logger::instance().set_level(Logger::Level::WARNING);
+    // 日志交给后台线程写出，采集路径上的 LOG_* 不做 I/O；
+    // 在屏蔽信号之后启动，后台线程继承信号掩码
+    if (!Logger::instance().start_async(options.log_file)) {
+        return 1;
+    }
+    raise_fd_limit();
+
+    if (!options.aggregate.empty()) {
+        int rc = run_aggregator(options, quit_signals);
+        Logger::instance().stop_async();
+        return rc;
+    }
 
     // ========================================
     // 工厂模式：使用工厂创建所有采集器
     // 客户端不需要知道具体类名！
     // ========================================
-    auto collectors = CollectorFactory::instance().create_all();
+    if (!options.proc_root.empty()) {
+        set_default_proc_root(options.proc_root);
+    }
+    for (const auto& choice : options.backends) {
+        if (!CollectorFactory::instance().has_backend(choice.collector, choice.backend)) {
+            std::cerr << "采集器 " << choice.collector << " 没有后端 " << choice.backend
+                      << "（可选: "
+                      << CollectorFactory::instance().backend_names(choice.collector)
+                      << "）" << std::endl;
+            return 1;
+        }
+    }
+    for (const auto& name : options.collectors) {
+        if (!CollectorFactory::instance().has_collector(name)) {
+            std::cerr << "没有名为 " << name << " 的采集器（可选: "
+                      << CollectorFactory::instance().collector_names() << "）" << std::endl;
+            return 1;
+        }
+    }
+    for (const auto& entry : options.intervals) {
+        if (!entry.collector.empty() &&
+            !CollectorFactory::instance().has_collector(entry.collector)) {
+            std::cerr << "--interval 中没有名为 " << entry.collector << " 的采集器（可选: "
+                      << CollectorFactory::instance().collector_names() << "）" << std::endl;
+            return 1;
+        }
+    }
+    if (!options.replay.empty()) {
+        int rc = run_replay(options);
+        Logger::instance().stop_async();
+        return rc;
+    }
 
-    // 首次采集数据（模板方法模式：调用 update()）
+    // 没有选中的采集器（以及被后端替换掉的默认实现）不会被构造
+    auto collectors =
+        CollectorFactory::instance().create_all(options.backends, options.collectors);
     for (auto& collector : collectors) {
-        collector->update();  // 模板方法：自动调用 do_collect -> do_parse -> do_calculate
+        collector->configure(options);
     }
+    apply_intervals(options, collectors);
 
-    std::cout << "系统监控器已启动，按 Ctrl+C 退出..." << std::endl;
+    // --record：可回放的采集器每次 update() 后把原始输入交给记录器，每个 tick 写出一次
+    std::unique_ptr<RawRecorder> recorder;
+    if (!options.record.empty()) {
+        recorder = std::make_unique<RawRecorder>();
+        if (!recorder->open(options.record)) {
+            return 1;
+        }
+        for (auto& collector : collectors) {
+            collector->set_raw_sink(recorder.get());
+        }
+    }
+
+    // --cpu-budget：主机繁忙时按自身 CPU 预算降低进程采集的精度
+    std::unique_ptr<AdaptiveSampler> adaptive;
+    if (options.cpu_budget > 0) {
+        const CPUCollector* cpu = nullptr;
+        const SystemCollector* system = nullptr;
+        ProcessCollector* process = nullptr;
+        for (auto& collector : collectors) {
+            if (!cpu) cpu = dynamic_cast<const CPUCollector*>(collector.get());
+            if (!system) system = dynamic_cast<const SystemCollector*>(collector.get());
+            if (!process) process = dynamic_cast<ProcessCollector*>(collector.get());
+        }
+        AdaptiveSampler::Thresholds thresholds;
+        thresholds.cpu_budget_percent = options.cpu_budget;
+        thresholds.hot_cpu_percent = options.hot_cpu;
+        thresholds.hot_load_per_cpu = options.hot_load;
+        adaptive = std::make_unique<AdaptiveSampler>(thresholds, cpu, system, process);
+    }
+
+    // 采集器之间互不依赖，交给调度器并发执行
+    size_t jobs = options.jobs;
+    if (jobs == 0) {
+        jobs = std::min<size_t>(collectors.size(),
+                                std::max(1u, std::thread::hardware_concurrency()));
+    }
+    CollectorScheduler scheduler(jobs);
+    // 本 tick 的临时对象（分发的任务等）从 arena 分配，输出完成后一次性释放
+    TickArena arena;
+    scheduler.set_arena(&arena);
+    if (options.io_uring && !scheduler.enable_io_uring()) {
+        LOG_WARN("io_uring 不可用，使用 pread 读取 /proc");
+    }
+
+    // 1. 创建事件循环 (epoll)
+    EventLoop loop;
+    if (!loop.valid()) {
+        return 1;
+    }
+
+    // 2. 按采样周期分组，每种周期一个 timerfd，注册到同一个 epoll
+    //    定时器回调只记录哪些采集器到期，本轮事件分发完后统一执行
+    std::map<std::chrono::milliseconds, std::vector<Collector*>> groups;
+    for (auto& collector : collectors) {
+        groups[collector->interval()].push_back(collector.get());
+    }
+
+    std::vector<Collector*> due;
+    due.reserve(collectors.size());
+    for (auto& [interval, members] : groups) {
+        const std::vector<Collector*>& group = members;
+        int tfd = loop.add_timer(interval, [&due, &group](uint64_t) {
+            due.insert(due.end(), group.begin(), group.end());
+        });
+        if (tfd == -1) {
+            return 1;
+        }
+    }
+
+    int sfd = signalfd(-1, &quit_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    bool running = true;
+    if (sfd == -1 || !loop.add(sfd, EPOLLIN, [sfd, &running](uint32_t) {
+            signalfd_siginfo info;
+            while (read(sfd, &info, sizeof(info)) == sizeof(info)) {
+            }
+            running = false;
+        })) {
+        return 1;
+    }
+
+    // PSI 触发器注册到同一个 epoll：出现资源停顿时对 CPU/内存/进程做一段高频采样，
+    // 平时只由上面的定时器唤醒
+    std::unique_ptr<PressureBurst> burst;
+    PressureCollector* pressure = nullptr;
+    for (auto& collector : collectors) {
+        if (!pressure) pressure = dynamic_cast<PressureCollector*>(collector.get());
+    }
+    if (pressure && !options.psi_trigger.empty()) {
+        std::vector<Collector*> targets;
+        for (auto& collector : collectors) {
+            Collector* c = collector.get();
+            if (c == pressure || dynamic_cast<CPUCollector*>(c) ||
+                dynamic_cast<MemoryCollector*>(c) || dynamic_cast<ProcessCollector*>(c)) {
+                targets.push_back(c);
+            }
+        }
+        PressureBurst::Config config;
+        config.interval = std::chrono::milliseconds(options.burst_interval_ms);
+        config.duration = std::chrono::milliseconds(options.burst_duration_ms);
+        burst = std::make_unique<PressureBurst>(loop, *pressure, std::move(targets), due,
+                                                config);
+        if (!burst->start(options.psi_trigger)) {
+            LOG_WARN("PSI 触发器不可用，只按固定周期采样");
+            burst.reset();
+        }
+    }
+
+    // headless 模式：不输出画面，每次采集后把数值写入各指标的环形缓冲区
+    // --archive：环形缓冲区之后再接一个磁盘归档
+    // --listen：每次采集后重新生成 /metrics 响应体，监听 socket 在同一个 epoll 上
+    // --push：每次采集后把变化的指标编码推给汇聚端，连接同样在这个 epoll 上
+    std::unique_ptr<MetricStore> store;
+    std::unique_ptr<MetricArchive> archive;
+    std::unique_ptr<MetricsServer> server;
+    std::unique_ptr<WireClient> client;
+    if (options.headless || !options.archive_dir.empty() || !options.listen.empty() ||
+        !options.push.empty()) {
+        store = std::make_unique<MetricStore>(std::chrono::seconds(options.retention_s));
+    }
+    if (!options.archive_dir.empty()) {
+        archive = std::make_unique<MetricArchive>(options.archive_dir);
+        store->set_sink(archive.get());
+    }
+    if (!options.listen.empty()) {
+        server = std::make_unique<MetricsServer>(loop);
+        if (!server->listen(options.listen)) {
+            return 1;
+        }
+    }
+    if (!options.push.empty()) {
+        std::string host_name = options.host_name;
+        char buf[256];
+        if (host_name.empty() && gethostname(buf, sizeof(buf)) == 0) {
+            buf[sizeof(buf) - 1] = '\0';
+            host_name = buf;
+        }
+        // 汇聚端按最短的采样周期为这台主机分配环形缓冲区
+        client = std::make_unique<WireClient>(loop, host_name, groups.begin()->first);
+        if (!client->set_target(options.push)) {
+            return 1;
+        }
+    }
+    auto publish = [&store, &server, &client](const std::vector<Collector*>& updated) {
+        if (!store) {
+            return;
+        }
+        int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        for (Collector* collector : updated) {
+            collector->publish(*store, now_ms);
+        }
+        if (server) {
+            server->update(*store);
+        }
+        if (client) {
+            client->update(*store, now_ms);
+        }
+    };
+
+    // 首次采集数据（模板方法模式：调度器调用 update()）
+    // 慢的采集器（进程、磁盘、网络、cgroup）在后台首次采集，其余的立即采集，
+    // 第一帧不用等最慢的那个；后台完成后立即刷新一帧
+    std::vector<Collector*> fast;
+    std::vector<Collector*> slow;
+    for (auto& collector : collectors) {
+        (collector->slow_start() ? slow : fast).push_back(collector.get());
+    }
+    scheduler.run(fast);
+    publish(fast);
+    if (recorder) {
+        recorder->end_tick(std::chrono::steady_clock::now());
+    }
+    arena.reset();
+    CollectorWarmup warmup(loop);
+    bool refresh = false;
+    if (!slow.empty() &&
+        !warmup.start(slow, [&publish, &refresh](const std::vector<Collector*>& done) {
+            publish(done);
+            refresh = true;
+        })) {
+        scheduler.run(slow);
+        publish(slow);
+        arena.reset();
+    }
+
+    if (store) {
+        std::cout << "系统监控器已启动 (headless): " << store->metric_count() << " 个指标, 保留 "
+                  << options.retention_s << " 秒, 已分配 "
+                  << store->memory_bytes() / 1024 << " KB，按 Ctrl+C 退出..." << std::endl;
+    } else {
+        std::cout << "系统监控器已启动，按 Ctrl+C 退出..." << std::endl;
+    }
     LOG_INFO("系统监控器已启动");
 
-    // 4. 事件循环
-    struct epoll_event events[1];
-    while (true) {
-        int nfds = epoll_wait(epfd, events, 1, -1);
-        
-        if (nfds == -1) {
-            LOG_ERROR(std::string("epoll_wait 失败: ") + strerror(errno));
-            break;
+    // 3. 事件循环：只运行到期的采集器，然后刷新画面
+    //    每帧先写入渲染器的缓冲区，只把与上一帧不同的行写到终端
+    FrameRenderer renderer;
+    TickStats ticks;
+    while (running && loop.run_once()) {
+        // 常规定时器和突发采样可能在同一轮加入同一个采集器
+        std::sort(due.begin(), due.end());
+        due.erase(std::unique(due.begin(), due.end()), due.end());
+        warmup.filter(due);
+        if (adaptive) {
+            adaptive->filter(due);
+        }
+        if (due.empty() && !refresh) {
+            continue;
+        }
+        refresh = false;
+
+        auto tick_start = std::chrono::steady_clock::now();
+        uint64_t allocs_before = AllocCounter::total();
+
+        // 模板方法模式：到期的采集器并发 update()，全部完成后再输出
+        if (!due.empty()) {
+            scheduler.run(due);
+            publish(due);
+            due.clear();
+            if (recorder) {
+                recorder->end_tick(std::chrono::steady_clock::now());
+            }
         }
-        
-        for (int n = 0; n < nfds; ++n) {
-            if (events[n].data.fd == tfd) {
-                // 定时器触发
-                uint64_t expirations;
-                ssize_t s = read(tfd, &expirations, sizeof(expirations));
-                if (s != sizeof(expirations)) {
-                    LOG_ERROR("读取 timerfd 失败");
-                    continue;
-                }
-                
-                // 清屏并打印头部
-                std::cout << CLEAR_SCREEN;
-                print_header();
-                
-                // 多态遍历 + 模板方法模式
-                for (size_t i = 0; i < collectors.size(); ++i) {
-                    collectors[i]->update();       // 模板方法
-                    collectors[i]->print_result(); // 多态调用
-                    if (i < collectors.size() - 1) {
-                        print_separator();
-                    }
-                }
-                
-                std::cout << std::endl;
-                std::cout << GREEN << "[每秒自动刷新 | Ctrl+C 退出]" << RESET << std::endl;
+
+        if (!options.headless) {
+            render(renderer.begin_frame(), collectors, scheduler, warmup, adaptive.get(),
+                   burst.get(), client.get(), options.stats ? &ticks : nullptr);
+            if (!renderer.end_frame()) {
+                LOG_ERROR("写终端失败，退出");
+                break;
             }
+            ticks.output_bytes.record(renderer.last_bytes());
         }
+
+        ticks.arena_bytes.record(arena.used_bytes());
+        arena.reset();
+        // 后台首次采集期间不调整进程采集器的抽样，避免与后台线程竞争
+        if (adaptive && !warmup.running()) {
+            adaptive->update(std::chrono::steady_clock::now());
+        }
+
+        ticks.latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - tick_start).count()));
+        ticks.allocations.record(AllocCounter::total() - allocs_before);
     }
 
-    // 清理
-    close(tfd);
-    close(epfd);
-    
+    if (archive) {
+        archive->flush();
+    }
+    close(sfd);
+    Logger::instance().stop_async();
     return 0;
-}
\ No newline at end of file
+}